@@ -20,6 +20,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
   // 1.     Search the page table for the requested page (P).
   auto iter = page_table_.find(page_id);
   // 1.1    If P exists, pin it and return it immediately.
@@ -51,6 +52,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::scoped_lock lock{latch_};
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
@@ -79,6 +81,7 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
   // 0.   Make sure you call DeallocatePage!
   DeallocatePage(page_id);
   // 1.   Search the page table for the requested page (P).
@@ -99,7 +102,29 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
   return true;
 }
 
+bool BufferPoolManager::DeletePages(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock lock{latch_};
+  disk_manager_->DeAllocatePages(page_ids);
+  bool all_deleted = true;
+  for (auto page_id : page_ids) {
+    auto iter = page_table_.find(page_id);
+    if (iter == page_table_.end()) continue;
+    frame_id_t frame_id = iter->second;
+    if (pages_[frame_id].pin_count_) {
+      all_deleted = false;
+      continue;
+    }
+    pages_[frame_id].ResetMemory();
+    pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+    pages_[frame_id].is_dirty_ = false;
+    page_table_.erase(iter);
+    free_list_.emplace_back(frame_id);
+  }
+  return all_deleted;
+}
+
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock lock{latch_};
   auto iter = page_table_.find(page_id);
   if (iter == page_table_.end()) return false;
   frame_id_t P = (*iter).second;
@@ -112,6 +137,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
   if (page_table_.find(page_id) == page_table_.end()) return false;
   frame_id_t P = page_table_[page_id];
   if (pages_[P].is_dirty_) disk_manager_->WritePage(page_id, pages_[P].GetData());
@@ -129,11 +155,23 @@ void BufferPoolManager::DeallocatePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
   return disk_manager_->IsPageFree(page_id);
 }
 
+void BufferPoolManager::SetPageCompression(page_id_t page_id, bool enable) {
+  std::scoped_lock lock{latch_};
+  disk_manager_->SetPageCompression(page_id, enable);
+}
+
+uint32_t BufferPoolManager::GetStoredSize(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  return disk_manager_->GetStoredSize(page_id);
+}
+
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock lock{latch_};
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
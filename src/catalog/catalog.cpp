@@ -1,4 +1,5 @@
 #include "catalog/catalog.h"
+#include "page/overflow_page.h"
 
 void CatalogMeta::SerializeTo(char *buf) const {
   // ASSERT(false, "Not Implemented yet");
@@ -89,10 +90,25 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
       TableMetadata::DeserializeFrom(table_page->GetData(), table_meta, table_info->GetMemHeap());
       // table_heap
       auto table_heap =
-          TableHeap::Create(buffer_pool_manager_, (page_id_t)table_meta->GetFirstPageId(), table_meta->GetSchema(),
-                            log_manager_, lock_manager_, table_info->GetMemHeap());
-
-      table_info->Init(table_meta, table_heap);
+          TableHeap::Create(buffer_pool_manager_, (page_id_t)table_meta->GetFirstPageId(),
+                            table_meta->GetDictionaryPageId(), table_meta->GetSchema(), log_manager_, lock_manager_,
+                            table_info->GetMemHeap());
+      if (table_meta->IsCompressed()) {
+        table_heap->EnableCompression();
+      }
+      // table_stats
+      TableStats *table_stats = nullptr;
+      if (table_meta->GetStatsPageId() != INVALID_PAGE_ID) {
+        std::vector<char> data;
+        ReadStatsPages(table_meta->GetStatsPageId(), data);
+        TableStats::DeserializeFrom(data.data(), table_meta->GetSchema(), table_stats, table_info->GetMemHeap());
+      } else {
+        // counters start from zero, they do not describe the rows already stored
+        table_stats = TableStats::Create(table_meta->GetSchema(), table_info->GetMemHeap());
+        table_stats->SetValid(false);
+      }
+
+      table_info->Init(table_meta, table_heap, table_stats);
 
       table_names_.emplace(std::make_pair(table_meta->GetTableName(), page.first));
       tables_.emplace(std::make_pair(page.first, table_info));
@@ -104,6 +120,7 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
     for (auto &page : *index_pages) {
       auto index_page = buffer_pool_manager_->FetchPage(page.second);
       index_page->RLatch();
+      bool dirty = false;
       auto heap = new SimpleMemHeap();
 
       IndexMetadata *index_meta = nullptr;
@@ -112,18 +129,34 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
       auto index_info = IndexInfo ::Create(heap);
 
       index_info->Init(index_meta, tables_[index_meta->GetTableId()], buffer_pool_manager_);
+      if (index_meta->GetIndexType() == kIndexBitmap) {
+        RebuildIndex(index_info);
+      } else if (!index_meta->HasCurrentKeyLayout()) {
+        // IndexInfo::Init freed the old tree, it is filled again with the current key type
+        RebuildIndex(index_info);
+        index_meta->SetCurrentKeyLayout(true);
+        index_meta->SerializeTo(index_page->GetData());
+        dirty = true;
+      }
       auto table_name = tables_[index_meta->GetTableId()]->GetTableName();
 
       index_names_[table_name].insert(std::make_pair(index_meta->GetIndexName(), page.first));
       indexes_.emplace(page.first, index_info);
       index_page->RUnlatch();
-      buffer_pool_manager_->UnpinPage(page.second, false);
+      buffer_pool_manager_->UnpinPage(page.second, dirty);
     }
     buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID,false);
   }
 }
 
 CatalogManager::~CatalogManager() { 
+  for (auto &table : tables_) {
+    if (table.second->GetTableStats()->IsDirty()) {
+      FlushTableStats(table.second);
+    } else if (table.second->GetTableMetadata()->IsDirty()) {
+      FlushTableMetadata(table.second);
+    }
+  }
   char *buf = reinterpret_cast<char *>(buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID)->GetData());
   catalog_meta_->SerializeTo(buf);
   buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID,true);
@@ -131,7 +164,7 @@ CatalogManager::~CatalogManager() {
 }
 
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Transaction *txn,
-                                    TableInfo *&table_info) {
+                                    TableInfo *&table_info, bool compressed) {
   if (table_names_.count(table_name) != 0) {
     return DB_TABLE_ALREADY_EXIST;
   }
@@ -147,9 +180,20 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   // table_info分配内存
   table_info = TableInfo::Create(heap_);
   // metadata heap 构造
-  TableMetadata *new_table_metadata = TableMetadata::Create(new_table_id, table_name, new_page_id, schema, heap_);
   TableHeap *new_table_heap = TableHeap::Create(buffer_pool_manager_, schema, txn, log_manager_, lock_manager_, heap_);
-  table_info->Init(new_table_metadata, new_table_heap);
+  // the heap is reopened through its page directory
+  TableMetadata *new_table_metadata =
+      TableMetadata::Create(new_table_id, table_name, new_table_heap->GetDirectoryPageId(), schema, heap_);
+  new_table_metadata->SetDictionaryPageId(new_table_heap->GetDictionaryPageId());
+  new_table_metadata->SetRowCount(0);
+  if (compressed) {
+    new_table_heap->EnableCompression();
+    new_table_metadata->SetCompressed(true);
+  }
+  // an empty table is fully described by zeroed counters, persist them with the catalog
+  TableStats *new_table_stats = TableStats::Create(schema, heap_);
+  new_table_stats->SetDirty(true);
+  table_info->Init(new_table_metadata, new_table_heap, new_table_stats);
   // tables_
   tables_.insert({new_table_id, table_info});
 
@@ -157,6 +201,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   //数据字节流的位置
   char *buf = reinterpret_cast<char *>(new_page->GetData());
   new_table_metadata->SerializeTo(buf);
+  new_table_metadata->SetDirty(false);
   catalog_meta_->table_meta_pages_.insert({new_table_id, new_page_id});
   catalog_meta_->SerializeTo(buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID)->GetData());
 
@@ -224,6 +269,7 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   page_id_t new_page_id = catalog_meta_->table_meta_pages_[new_table_id];
 
   tmp->GetTableHeap()->FreeHeap();
+  FreeStatsPages(tmp->GetTableMetadata()->GetStatsPageId());
   buffer_pool_manager_->DeletePage(new_page_id);
 
   // catalog_meta_
@@ -236,7 +282,7 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) {
+                                    IndexInfo *&index_info, IndexType index_type) {
   if(table_names_.count(table_name) == 0)
     return DB_TABLE_NOT_EXIST;
     
@@ -273,7 +319,8 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   index_info = IndexInfo::Create(heap);
 
   IndexMetadata *new_index_meta =
-      IndexMetadata::Create(new_index_id, index_name, table_names_.find(table_name)->second, key_map, heap);
+      IndexMetadata::Create(new_index_id, index_name, table_names_.find(table_name)->second, key_map, heap,
+                            index_type);
   // init
   index_info->Init(new_index_meta, table_info, buffer_pool_manager_);
   // indexes_
@@ -289,6 +336,26 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::RebuildIndex(IndexInfo *index_info) {
+  TableHeap *table_heap = index_info->GetTableInfo()->GetTableHeap();
+  const std::vector<uint32_t> &key_map = index_info->GetMetadata()->GetKeyMapping();
+  auto scan = [&](const IndexEntryConsumer &consume) {
+    // one key alive at a time, rewound per row instead of growing with the table
+    ArenaMemHeap key_heap;
+    std::vector<Field> fields;
+    for (auto it = table_heap->Begin(nullptr, key_map); it != table_heap->End(); ++it) {
+      fields.clear();
+      key_heap.Reset();
+      for (auto column_index : key_map) {
+        fields.push_back(*it->GetField(column_index));
+      }
+      Row key(fields, &key_heap);
+      consume(key, it->GetRowId());
+    }
+  };
+  return index_info->GetIndex()->BulkLoad(scan, nullptr);
+}
+
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
                                  IndexInfo *&index_info) const {
   auto iter1 = index_names_.find(table_name);
@@ -340,6 +407,32 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   }
 }
 
+dberr_t CatalogManager::TruncateTable(const std::string &table_name) {
+  TableInfo *table_info;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_name, indexes);
+  for (auto index_info : indexes) {
+    index_info->GetIndex()->Destroy();
+  }
+  TableHeap *old_table_heap = table_info->GetTableHeap();
+  old_table_heap->FreeHeap();
+  Schema *schema = table_info->GetSchema();
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, schema, nullptr, log_manager_, lock_manager_, heap_);
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  if (old_table_heap->IsCompressed()) {
+    table_heap->EnableCompression();
+  }
+  table_meta->SetFirstPageId(table_heap->GetDirectoryPageId());
+  table_meta->SetDictionaryPageId(table_heap->GetDictionaryPageId());
+  table_meta->SetRowCount(0);
+  table_info->Init(table_meta, table_heap, TableStats::Create(schema, heap_));
+  // writes the metadata along with the zeroed counters
+  return FlushTableStats(table_info);
+}
+
 dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const {
   auto iter = index_names_.find(table_name);
   if(iter == index_names_.end())
@@ -352,3 +445,105 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
   }
   return DB_SUCCESS;
 }
+
+dberr_t CatalogManager::AnalyzeTable(const std::string &table_name) {
+  TableInfo *table_info;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  table_info->GetTableStats()->Analyze(table_info->GetTableHeap());
+  return FlushTableStats(table_info);
+}
+
+dberr_t CatalogManager::FlushTableStats(TableInfo *table_info) {
+  TableStats *table_stats = table_info->GetTableStats();
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  std::vector<char> data(table_stats->GetSerializedSize());
+  table_stats->SerializeTo(data.data());
+  page_id_t stats_page_id = WriteStatsPages(data.data(), data.size());
+  if (stats_page_id == INVALID_PAGE_ID) {
+    return DB_FAILED;
+  }
+  FreeStatsPages(table_meta->GetStatsPageId());
+  table_meta->SetStatsPageId(stats_page_id);
+  FlushTableMetadata(table_info);
+  table_stats->SetDirty(false);
+  return DB_SUCCESS;
+}
+
+void CatalogManager::FlushTableMetadata(TableInfo *table_info) {
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  page_id_t meta_page_id = catalog_meta_->table_meta_pages_[table_meta->GetTableId()];
+  auto meta_page = buffer_pool_manager_->FetchPage(meta_page_id);
+  table_meta->SerializeTo(meta_page->GetData());
+  buffer_pool_manager_->UnpinPage(meta_page_id, true);
+  table_meta->SetDirty(false);
+}
+
+dberr_t CatalogManager::GetRowCount(const std::string &table_name, uint64_t &row_count) {
+  TableInfo *table_info;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  TableMetadata *table_meta = table_info->GetTableMetadata();
+  if (!table_meta->HasRowCount()) {
+    uint64_t count = 0;
+    TableHeap *table_heap = table_info->GetTableHeap();
+    for (auto it = table_heap->Begin(nullptr, {}); it != table_heap->End(); ++it) {
+      count++;
+    }
+    table_meta->SetRowCount(count);
+  }
+  row_count = table_meta->GetRowCount();
+  return DB_SUCCESS;
+}
+
+page_id_t CatalogManager::WriteStatsPages(const char *data, uint32_t len) {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  for (uint32_t ofs = 0; ofs < len; ) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(page_id));
+    if (page == nullptr) {
+      if (prev_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+      }
+      FreeStatsPages(first_page_id);
+      return INVALID_PAGE_ID;
+    }
+    page->Init(page_id);
+    ofs += page->WritePayload(data + ofs, len - ofs);
+    if (prev_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+    }
+    prev_page = page;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+  }
+  return first_page_id;
+}
+
+void CatalogManager::ReadStatsPages(page_id_t page_id, std::vector<char> &data) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Failed to fetch statistics page.");
+    data.insert(data.end(), page->GetPayload(), page->GetPayload() + page->GetDataSize());
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void CatalogManager::FreeStatsPages(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
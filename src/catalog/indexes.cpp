@@ -2,14 +2,14 @@
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name,
                                      const table_id_t table_id, const vector<uint32_t> &key_map,
-                                     MemHeap *heap) {
+                                     MemHeap *heap, IndexType index_type) {
   void *buf = heap->Allocate(sizeof(IndexMetadata));
-  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map);
+  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map, index_type);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
   uint32_t ofs=sizeof(uint32_t);
-  MACH_WRITE_TO(uint32_t, buf, INDEX_METADATA_MAGIC_NUM);
+  MACH_WRITE_TO(uint32_t, buf, INDEX_METADATA_MAGIC_NUM_V5);
   MACH_WRITE_TO(index_id_t, buf+ofs, index_id_);
   ofs+=sizeof(index_id_t);
   MACH_WRITE_TO(size_t, buf+ofs, index_name_.size());
@@ -25,19 +25,24 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     MACH_WRITE_TO(uint32_t,buf+ofs,key);
     ofs+=sizeof(uint32_t);
   }
+  MACH_WRITE_TO(uint32_t, buf + ofs, static_cast<uint32_t>(index_type_));
+  ofs += sizeof(uint32_t);
   
   return ofs;
 }
 
 uint32_t IndexMetadata::GetSerializedSize() const {
   uint32_t ofs=sizeof(uint32_t)+sizeof(index_id_t)+sizeof(size_t)+index_name_.size()+sizeof(table_id_t)+sizeof(size_t)+key_map_.size()*sizeof(uint32_t);
+  ofs += sizeof(uint32_t);
 
   return ofs;
 }
 
 uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, MemHeap *heap) {
   uint32_t MAGIC_NUM = MACH_READ_FROM(uint32_t, buf);
-  ASSERT(MAGIC_NUM == INDEX_METADATA_MAGIC_NUM, "INDEX FORMAT ERROR!");
+  ASSERT(MAGIC_NUM == INDEX_METADATA_MAGIC_NUM || MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V2 ||
+         MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V3 || MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V4 ||
+         MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V5, "INDEX FORMAT ERROR!");
   uint32_t ofs = sizeof(uint32_t); 
   index_id_t index_id = MACH_READ_FROM(index_id_t, buf+ofs);
   ofs+=sizeof(index_id_t);
@@ -59,7 +64,14 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
     ofs+=sizeof(uint32_t);
     key_map.push_back(temp);
   }
+  IndexType index_type = kIndexBPlusTree;
+  if (MAGIC_NUM != INDEX_METADATA_MAGIC_NUM) {
+    index_type = static_cast<IndexType>(MACH_READ_FROM(uint32_t, buf + ofs));
+    ofs += sizeof(uint32_t);
+  }
   
-  index_meta = Create(index_id,index_name,table_id,key_map,heap);
+  index_meta = Create(index_id,index_name,table_id,key_map,heap,index_type);
+  index_meta->SetCurrentKeyLayout(MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V5);
+  index_meta->unique_key_layout_ = MAGIC_NUM == INDEX_METADATA_MAGIC_NUM_V4;
   return ofs;
 }
\ No newline at end of file
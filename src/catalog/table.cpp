@@ -1,8 +1,26 @@
 #include "catalog/table.h"
 
 uint32_t TableMetadata::SerializeTo(char *buf) const {
+  // v1 tables without statistics keep the original layout byte for byte
+  bool has_row_count = HasRowCount();
+  bool has_options = has_row_count || compressed_;
+  bool has_dictionaries = has_options || dictionary_page_id_ != INVALID_PAGE_ID;
+  bool has_stats = has_dictionaries || stats_page_id_ != INVALID_PAGE_ID;
+  bool has_row_format = has_stats || schema_->GetRowFormat() != kRowFormatV1;
   uint32_t ofs = sizeof(TABLE_METADATA_MAGIC_NUM);
-  MACH_WRITE_TO(uint32_t, buf, TABLE_METADATA_MAGIC_NUM);
+  uint32_t magic_num = TABLE_METADATA_MAGIC_NUM;
+  if (has_row_count) {
+    magic_num = TABLE_METADATA_MAGIC_NUM_V6;
+  } else if (has_options) {
+    magic_num = TABLE_METADATA_MAGIC_NUM_V5;
+  } else if (has_dictionaries) {
+    magic_num = TABLE_METADATA_MAGIC_NUM_V4;
+  } else if (has_stats) {
+    magic_num = TABLE_METADATA_MAGIC_NUM_V3;
+  } else if (has_row_format) {
+    magic_num = TABLE_METADATA_MAGIC_NUM_V2;
+  }
+  MACH_WRITE_TO(uint32_t, buf, magic_num);
   MACH_WRITE_TO(table_id_t, buf+ofs, table_id_);
   ofs+=sizeof(table_id_t);
   MACH_WRITE_TO(size_t, buf+ofs, table_name_.size());
@@ -13,12 +31,58 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   ofs+=sizeof(page_id_t);
   (*schema_).SerializeTo(buf+ofs);
   ofs+=(*schema_).GetSerializedSize();
-  
+  if (has_row_format) {
+    MACH_WRITE_TO(uint32_t, buf + ofs, static_cast<uint32_t>(schema_->GetRowFormat()));
+    ofs += sizeof(uint32_t);
+  }
+  if (has_stats) {
+    MACH_WRITE_TO(page_id_t, buf + ofs, stats_page_id_);
+    ofs += sizeof(page_id_t);
+  }
+  if (has_dictionaries) {
+    MACH_WRITE_TO(page_id_t, buf + ofs, dictionary_page_id_);
+    ofs += sizeof(page_id_t);
+    uint32_t count_ofs = ofs;
+    uint32_t count = 0;
+    ofs += sizeof(uint32_t);
+    for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+      if (schema_->GetColumnEncoding(i) == kEncodingDictionary) {
+        MACH_WRITE_UINT32(buf + ofs, i);
+        ofs += sizeof(uint32_t);
+        count++;
+      }
+    }
+    MACH_WRITE_UINT32(buf + count_ofs, count);
+  }
+  if (has_options) {
+    MACH_WRITE_UINT32(buf + ofs, compressed_ ? kTableOptionCompressed : 0);
+    ofs += sizeof(uint32_t);
+  }
+  if (has_row_count) {
+    MACH_WRITE_TO(uint64_t, buf + ofs, row_count_);
+    ofs += sizeof(uint64_t);
+  }
   return ofs;
 }
 
 uint32_t TableMetadata::GetSerializedSize() const {
-  return sizeof(TABLE_METADATA_MAGIC_NUM)+sizeof(size_t)+table_name_.size()+sizeof(table_id_t)+sizeof(page_id_t)+(*schema_).GetSerializedSize();
+  bool has_row_count = HasRowCount();
+  bool has_options = has_row_count || compressed_;
+  bool has_dictionaries = has_options || dictionary_page_id_ != INVALID_PAGE_ID;
+  bool has_stats = has_dictionaries || stats_page_id_ != INVALID_PAGE_ID;
+  uint32_t row_format_size = has_stats || schema_->GetRowFormat() != kRowFormatV1 ? sizeof(uint32_t) : 0;
+  uint32_t stats_size = has_stats ? sizeof(page_id_t) : 0;
+  uint32_t dictionary_size = 0;
+  if (has_dictionaries) {
+    dictionary_size = sizeof(page_id_t) + sizeof(uint32_t);
+    for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+      dictionary_size += schema_->GetColumnEncoding(i) == kEncodingDictionary ? sizeof(uint32_t) : 0;
+    }
+  }
+  uint32_t options_size = (has_options ? sizeof(uint32_t) : 0) + (has_row_count ? sizeof(uint64_t) : 0);
+  return sizeof(TABLE_METADATA_MAGIC_NUM) + sizeof(size_t) + table_name_.size() + sizeof(table_id_t) +
+         sizeof(page_id_t) + (*schema_).GetSerializedSize() + row_format_size + stats_size + dictionary_size +
+         options_size;
 }
 
 /**
@@ -26,7 +90,10 @@ uint32_t TableMetadata::GetSerializedSize() const {
  */
 uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, MemHeap *heap) {
   uint32_t MAGIC_NUM = MACH_READ_FROM(uint32_t, buf);
-  ASSERT(TABLE_METADATA_MAGIC_NUM == MAGIC_NUM,"TABLE FORMAT ERROR!!");
+  ASSERT(TABLE_METADATA_MAGIC_NUM == MAGIC_NUM || TABLE_METADATA_MAGIC_NUM_V2 == MAGIC_NUM ||
+         TABLE_METADATA_MAGIC_NUM_V3 == MAGIC_NUM || TABLE_METADATA_MAGIC_NUM_V4 == MAGIC_NUM ||
+         TABLE_METADATA_MAGIC_NUM_V5 == MAGIC_NUM || TABLE_METADATA_MAGIC_NUM_V6 == MAGIC_NUM,
+         "TABLE FORMAT ERROR!!");
   uint32_t ofs = sizeof(TABLE_METADATA_MAGIC_NUM);
   table_id_t table_id = MACH_READ_FROM(table_id_t, buf+ofs);
   ofs += sizeof(table_id_t);
@@ -41,8 +108,44 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   ofs+=sizeof(page_id_t);
   Schema *schema;
   ofs+=Schema::DeserializeFrom(buf+ofs, schema, heap);
+  if (MAGIC_NUM != TABLE_METADATA_MAGIC_NUM) {
+    schema->SetRowFormat(static_cast<RowFormat>(MACH_READ_FROM(uint32_t, buf + ofs)));
+    ofs += sizeof(uint32_t);
+  }
+  page_id_t stats_page_id = INVALID_PAGE_ID;
+  if (MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V3 || MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V4 ||
+      MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V5 || MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V6) {
+    stats_page_id = MACH_READ_FROM(page_id_t, buf + ofs);
+    ofs += sizeof(page_id_t);
+  }
+  page_id_t dictionary_page_id = INVALID_PAGE_ID;
+  if (MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V4 || MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V5 ||
+      MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V6) {
+    dictionary_page_id = MACH_READ_FROM(page_id_t, buf + ofs);
+    ofs += sizeof(page_id_t);
+    uint32_t count = MACH_READ_UINT32(buf + ofs);
+    ofs += sizeof(uint32_t);
+    for (uint32_t i = 0; i < count; i++) {
+      schema->SetColumnEncoding(MACH_READ_UINT32(buf + ofs), kEncodingDictionary);
+      ofs += sizeof(uint32_t);
+    }
+  }
+  uint32_t options = 0;
+  if (MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V5 || MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V6) {
+    options = MACH_READ_UINT32(buf + ofs);
+    ofs += sizeof(uint32_t);
+  }
+  uint64_t row_count = INVALID_ROW_COUNT;
+  if (MAGIC_NUM == TABLE_METADATA_MAGIC_NUM_V6) {
+    row_count = MACH_READ_FROM(uint64_t, buf + ofs);
+    ofs += sizeof(uint64_t);
+  }
   //
   table_meta = ALLOC_P(heap,TableMetadata)(table_id, table_name, root_page_id, schema);
+  table_meta->stats_page_id_ = stats_page_id;
+  table_meta->dictionary_page_id_ = dictionary_page_id;
+  table_meta->compressed_ = (options & kTableOptionCompressed) != 0;
+  table_meta->row_count_ = row_count;
   return ofs;
 }
 
@@ -0,0 +1,310 @@
+#include "catalog/table_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+void HyperLogLog::Add(uint64_t hash) {
+  uint32_t index = static_cast<uint32_t>(hash >> (64 - HLL_PRECISION));
+  uint64_t rest = hash << HLL_PRECISION;
+  uint8_t rank = rest == 0 ? 64 - HLL_PRECISION + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+uint64_t HyperLogLog::Estimate() const {
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (auto reg : registers_) {
+    sum += std::ldexp(1.0, -reg);
+    zeros += reg == 0;
+  }
+  double m = REGISTER_COUNT;
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros != 0) {
+    // linear counting for small cardinalities
+    estimate = m * std::log(m / zeros);
+  }
+  return static_cast<uint64_t>(std::llround(estimate));
+}
+
+void HyperLogLog::Clear() { memset(registers_, 0, sizeof(registers_)); }
+
+uint64_t HyperLogLog::Hash(const Field &field) {
+  char buf[sizeof(uint64_t)];
+  const char *data = buf;
+  uint32_t len;
+  if (field.GetTypeId() == kTypeChar) {
+    data = field.GetData();
+    len = field.GetLength();
+  } else {
+    len = field.SerializeTo(buf);
+  }
+  // FNV-1a followed by the splitmix64 finalizer, the leading bits pick the register
+  uint64_t hash = 14695981039346656037ull;
+  for (uint32_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+  }
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+  return hash ^ (hash >> 31);
+}
+
+TableStats::TableStats(Schema *schema) : schema_(schema), columns_(schema->GetColumnCount()) {}
+
+void TableStats::Analyze(TableHeap *table_heap) {
+  uint32_t page_count = table_heap->GetPageCount();
+  std::vector<uint32_t> sample(page_count);
+  std::iota(sample.begin(), sample.end(), 0);
+  if (page_count > STATS_SAMPLE_PAGES) {
+    // seeded by the table size so that analyzing an unchanged table gives the same result
+    std::mt19937 random(page_count);
+    std::shuffle(sample.begin(), sample.end(), random);
+    sample.resize(STATS_SAMPLE_PAGES);
+    std::sort(sample.begin(), sample.end());
+  }
+  ArenaMemHeap heap;
+  std::vector<Row> rows;
+  for (auto index : sample) {
+    table_heap->GetPageTuples(table_heap->GetPageId(index), nullptr, nullptr, &heap, &rows);
+  }
+  bool full = sample.size() == page_count;
+  uint64_t sample_rows = rows.size();
+  row_count_ = full ? sample_rows : std::llround(static_cast<double>(sample_rows) * page_count / sample.size());
+  double scale = sample_rows == 0 ? 0 : static_cast<double>(row_count_) / sample_rows;
+
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    ColumnStats &column = columns_[i];
+    column = ColumnStats();
+    std::vector<const Field *> values;
+    uint64_t nulls = 0;
+    for (auto &row : rows) {
+      const Field *field = row.GetField(i);
+      if (field->IsNull()) {
+        nulls++;
+      } else {
+        values.push_back(field);
+        column.sketch_.Add(HyperLogLog::Hash(*field));
+      }
+    }
+    column.null_count_ = full ? nulls : std::llround(nulls * scale);
+    if (values.empty()) {
+      continue;
+    }
+    std::sort(values.begin(), values.end(),
+              [](const Field *a, const Field *b) { return a->CompareLessThan(*b) == kTrue; });
+    column.min_ = CopyValue(*values.front());
+    column.max_ = CopyValue(*values.back());
+
+    // distinct values in the sample and how many of them occur exactly once
+    uint64_t distinct = 0, singles = 0;
+    for (size_t begin = 0, end; begin < values.size(); begin = end) {
+      for (end = begin + 1; end < values.size() && values[end]->CompareEquals(*values[begin]) == kTrue; end++) {
+      }
+      distinct++;
+      singles += end - begin == 1;
+    }
+    if (full) {
+      column.distinct_count_ = distinct;
+    } else {
+      // Duj1 estimator of Haas and Stokes, n * d / (n - f1 + f1 * n / N): a sample of unique values
+      // scales to the table, values repeated in the sample are taken as all there is
+      uint64_t non_null = row_count_ - std::min(row_count_, column.null_count_);
+      double n = values.size();
+      double estimate = n * distinct / (n - singles + singles * n / std::max<double>(non_null, n));
+      column.distinct_count_ = std::min<uint64_t>(non_null, std::llround(estimate));
+    }
+
+    uint32_t bucket_count = std::min<uint32_t>(STATS_HISTOGRAM_BUCKETS, values.size());
+    for (uint32_t b = 0; b < bucket_count; b++) {
+      size_t pos = ((b + 1) * values.size() + bucket_count - 1) / bucket_count - 1;
+      column.histogram_.push_back(CopyValue(*values[pos]));
+    }
+  }
+  modified_count_ = 0;
+  sampled_pages_ = sample.size();
+  table_pages_ = page_count;
+  valid_ = analyzed_ = dirty_ = true;
+}
+
+void TableStats::OnInsert(const Row &row) {
+  row_count_++;
+  modified_count_++;
+  dirty_ = true;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const Field *field = row.GetField(i);
+    if (field->IsNull()) {
+      columns_[i].null_count_++;
+    } else if (field->GetTypeId() == schema_->GetColumn(i)->GetType()) {
+      columns_[i].sketch_.Add(HyperLogLog::Hash(*field));
+      Widen(columns_[i], *field);
+    }
+  }
+}
+
+void TableStats::OnDelete(const Row &row) {
+  row_count_ -= row_count_ > 0;
+  modified_count_++;
+  dirty_ = true;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (row.GetField(i)->IsNull()) {
+      columns_[i].null_count_ -= columns_[i].null_count_ > 0;
+    }
+  }
+}
+
+double TableStats::GetNullFraction(uint32_t column_index) const {
+  if (row_count_ == 0) {
+    return 0;
+  }
+  return std::min(1.0, static_cast<double>(columns_[column_index].null_count_) / row_count_);
+}
+
+uint64_t TableStats::GetDistinctCount(uint32_t column_index) const {
+  const ColumnStats &column = columns_[column_index];
+  uint64_t non_null = row_count_ - std::min(row_count_, column.null_count_);
+  return std::min(non_null, std::max(column.distinct_count_, column.sketch_.Estimate()));
+}
+
+ColumnEncoding TableStats::AdviseEncoding(uint32_t column_index) const {
+  const Column *column = schema_->GetColumn(column_index);
+  if (column->GetType() != kTypeChar || !valid_ || row_count_ == 0) {
+    return kEncodingPlain;
+  }
+  uint64_t distinct = GetDistinctCount(column_index);
+  if (distinct > ColumnDictionary::MAX_CODES || distinct * DICTIONARY_MIN_REPEATS > row_count_) {
+    return kEncodingPlain;
+  }
+  // a dictionary entry carries a 4 byte header, see TableHeap::AppendDictionaryEntry
+  uint64_t plain_size = row_count_ * column->GetLength();
+  uint64_t dictionary_size = row_count_ * sizeof(uint16_t) + distinct * (column->GetLength() + 2 * sizeof(uint16_t));
+  return dictionary_size < plain_size ? kEncodingDictionary : kEncodingPlain;
+}
+
+void TableStats::Widen(ColumnStats &column, const Field &field) {
+  if (column.min_ == nullptr || field.CompareLessThan(*column.min_) == kTrue) {
+    column.min_ = CopyValue(field);
+  }
+  if (column.max_ == nullptr || field.CompareGreaterThan(*column.max_) == kTrue) {
+    column.max_ = CopyValue(field);
+  }
+}
+
+std::unique_ptr<Field> TableStats::CopyValue(const Field &field) {
+  if (field.GetTypeId() == kTypeChar) {
+    uint32_t len = std::min(field.GetLength(), STATS_MAX_VALUE_LEN);
+    return std::unique_ptr<Field>(new Field(kTypeChar, const_cast<char *>(field.GetData()), len, true));
+  }
+  return std::unique_ptr<Field>(new Field(field));
+}
+
+namespace {
+
+uint32_t WriteValue(char *buf, const std::unique_ptr<Field> &value) { return value->SerializeTo(buf); }
+
+uint32_t ReadValue(char *buf, TypeId type, std::unique_ptr<Field> &value) {
+  SimpleMemHeap heap;
+  Field *field;
+  uint32_t ofs = Field::DeserializeFrom(buf, type, &field, false, &heap);
+  value = std::unique_ptr<Field>(new Field(*field));
+  field->~Field();
+  return ofs;
+}
+
+}  // namespace
+
+uint32_t TableStats::SerializeTo(char *buf) const {
+  uint32_t ofs = 0;
+  MACH_WRITE_UINT32(buf + ofs, TABLE_STATS_MAGIC_NUM);
+  ofs += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf + ofs, static_cast<uint32_t>(valid_) | static_cast<uint32_t>(analyzed_) << 1);
+  ofs += sizeof(uint32_t);
+  MACH_WRITE_TO(uint64_t, buf + ofs, row_count_);
+  ofs += sizeof(uint64_t);
+  MACH_WRITE_TO(uint64_t, buf + ofs, modified_count_);
+  ofs += sizeof(uint64_t);
+  MACH_WRITE_UINT32(buf + ofs, sampled_pages_);
+  ofs += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf + ofs, table_pages_);
+  ofs += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf + ofs, static_cast<uint32_t>(columns_.size()));
+  ofs += sizeof(uint32_t);
+  for (auto &column : columns_) {
+    MACH_WRITE_TO(uint64_t, buf + ofs, column.null_count_);
+    ofs += sizeof(uint64_t);
+    MACH_WRITE_TO(uint64_t, buf + ofs, column.distinct_count_);
+    ofs += sizeof(uint64_t);
+    memcpy(buf + ofs, column.sketch_.registers_, HyperLogLog::REGISTER_COUNT);
+    ofs += HyperLogLog::REGISTER_COUNT;
+    MACH_WRITE_UINT32(buf + ofs, column.min_ != nullptr);
+    ofs += sizeof(uint32_t);
+    if (column.min_ != nullptr) {
+      ofs += WriteValue(buf + ofs, column.min_);
+      ofs += WriteValue(buf + ofs, column.max_);
+    }
+    MACH_WRITE_UINT32(buf + ofs, static_cast<uint32_t>(column.histogram_.size()));
+    ofs += sizeof(uint32_t);
+    for (auto &bound : column.histogram_) {
+      ofs += WriteValue(buf + ofs, bound);
+    }
+  }
+  return ofs;
+}
+
+uint32_t TableStats::GetSerializedSize() const {
+  uint32_t size = 5 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+  for (auto &column : columns_) {
+    size += 2 * sizeof(uint64_t) + HyperLogLog::REGISTER_COUNT + 2 * sizeof(uint32_t);
+    if (column.min_ != nullptr) {
+      size += column.min_->GetSerializedSize() + column.max_->GetSerializedSize();
+    }
+    for (auto &bound : column.histogram_) {
+      size += bound->GetSerializedSize();
+    }
+  }
+  return size;
+}
+
+uint32_t TableStats::DeserializeFrom(char *buf, Schema *schema, TableStats *&table_stats, MemHeap *heap) {
+  ASSERT(MACH_READ_UINT32(buf) == TABLE_STATS_MAGIC_NUM, "TABLE STATS FORMAT ERROR!");
+  uint32_t ofs = sizeof(uint32_t);
+  table_stats = Create(schema, heap);
+  uint32_t flags = MACH_READ_UINT32(buf + ofs);
+  ofs += sizeof(uint32_t);
+  table_stats->valid_ = flags & 1;
+  table_stats->analyzed_ = flags & 2;
+  table_stats->row_count_ = MACH_READ_FROM(uint64_t, buf + ofs);
+  ofs += sizeof(uint64_t);
+  table_stats->modified_count_ = MACH_READ_FROM(uint64_t, buf + ofs);
+  ofs += sizeof(uint64_t);
+  table_stats->sampled_pages_ = MACH_READ_UINT32(buf + ofs);
+  ofs += sizeof(uint32_t);
+  table_stats->table_pages_ = MACH_READ_UINT32(buf + ofs);
+  ofs += sizeof(uint32_t);
+  uint32_t column_count = MACH_READ_UINT32(buf + ofs);
+  ofs += sizeof(uint32_t);
+  ASSERT(column_count == schema->GetColumnCount(), "Statistics do not match the schema.");
+  for (uint32_t i = 0; i < column_count; i++) {
+    ColumnStats &column = table_stats->columns_[i];
+    TypeId type = schema->GetColumn(i)->GetType();
+    column.null_count_ = MACH_READ_FROM(uint64_t, buf + ofs);
+    ofs += sizeof(uint64_t);
+    column.distinct_count_ = MACH_READ_FROM(uint64_t, buf + ofs);
+    ofs += sizeof(uint64_t);
+    memcpy(column.sketch_.registers_, buf + ofs, HyperLogLog::REGISTER_COUNT);
+    ofs += HyperLogLog::REGISTER_COUNT;
+    bool has_range = MACH_READ_UINT32(buf + ofs) != 0;
+    ofs += sizeof(uint32_t);
+    if (has_range) {
+      ofs += ReadValue(buf + ofs, type, column.min_);
+      ofs += ReadValue(buf + ofs, type, column.max_);
+    }
+    uint32_t bucket_count = MACH_READ_UINT32(buf + ofs);
+    ofs += sizeof(uint32_t);
+    column.histogram_.resize(bucket_count);
+    for (auto &bound : column.histogram_) {
+      ofs += ReadValue(buf + ofs, type, bound);
+    }
+  }
+  return ofs;
+}
@@ -1,10 +1,15 @@
 #include "executor/execute_engine.h"
 #include <algorithm>
+#include <cstdlib>
 #include <iomanip>
+#include <sstream>
+#include <type_traits>
 #include <typeinfo>
 #include "fstream"
+#include "executor/parallel_scan.h"
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
+#include "index/b_plus_tree_index_types.h"
 #include "index/index.h"
 #include "parser/syntax_tree_printer.h"
 #include "utils/tree_file_mgr.h"
@@ -82,6 +87,14 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteExecfile(ast, context);
     case kNodeQuit:
       return ExecuteQuit(ast, context);
+    case kNodeSetVariable:
+      return ExecuteSetVariable(ast, context);
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context);
+    case kNodeShowStats:
+      return ExecuteShowStats(ast, context);
+    case kNodeTruncateTable:
+      return ExecuteTruncateTable(ast, context);
     default:
       break;
   }
@@ -117,79 +130,546 @@ bool isFloat(string str) {
   return false;
 }
 
-int compare(const char *s,const char *t){
-  int i = 0;
-  int flag = 0;
-  while(s[i]!='\0'){
-    if(s[i] == '.'){
-      flag = 1;
-      break;
-    }else if(s[i]<'0' || s[i] > '9'){
-      flag = 2;
-      break;
+/**
+ * Three-way compare of a non-null field against a literal converted to the field's type
+ */
+int CompareLiteral(const Field *field, const char *literal) {
+  switch (field->GetTypeId()) {
+    case kTypeInt: {
+      Field value(kTypeInt, static_cast<int32_t>(strtol(literal, nullptr, 10)));
+      return field->CompareLessThan(value) == kTrue ? -1 : field->CompareGreaterThan(value) == kTrue;
+    }
+    case kTypeFloat: {
+      Field value(kTypeFloat, strtof(literal, nullptr));
+      return field->CompareLessThan(value) == kTrue ? -1 : field->CompareGreaterThan(value) == kTrue;
+    }
+    default: {
+      Field value(kTypeChar, const_cast<char *>(literal), strlen(literal), false);
+      return field->CompareLessThan(value) == kTrue ? -1 : field->CompareGreaterThan(value) == kTrue;
     }
-    i++;
-  }
-  if(flag == 0){
-    uint32_t l = 0;
-    for (int i = 0; s[i] != '\0'; ++i) {
-      l = l * 10 + (s[i] - '0');
-    }
-    uint32_t r = StringToInt((char *)t);
-    if(l > r) return 1;
-    if(strcmp(s,t) == 0) return 0;
-    else return -1;
-  }else if(flag == 1){
-    float l = StringToFloat((char *)s);
-    float r = StringToFloat((char *)t);
-    if(l-r>0) return 1;
-    else if(l-r==0) return 0;
-    else if(l-r<0) return -1;
-  }else return strcmp(s,t);
-  return 0;
+  }
 }
 
-bool DFS(pSyntaxNode ast, TableIterator &iter, Schema *schema) {
+/**
+ * Evaluate a where condition on one row. Only reads the row and the syntax tree, so scan workers
+ * call it concurrently.
+ */
+bool DFS(pSyntaxNode ast, const Row &row, Schema *schema) {
   if (ast->type_ == kNodeCompareOperator) {
     pSyntaxNode attr = ast->child_;
     pSyntaxNode val = attr->next_;
-    const char *r_value = val->val_;
-
     uint32_t index;
-    string col_name = attr->val_;
-    schema->GetColumnIndex(col_name, index);
-    Field *fie = iter->GetField(index);
-
-    const char *l_value = fie->GetData();
-    char *item = ast->val_;
-    if (strcmp(item, "=") == 0 && strcmp(l_value, r_value) == 0)
-      return true;
-    else if (strcmp(item, ">") == 0 && compare(l_value, r_value) > 0)
-      return true;
-    else if (strcmp(item, ">=") == 0 && compare(l_value, r_value) >= 0)
-      return true;
-    else if (strcmp(item, "<=") == 0 && compare(l_value, r_value) <= 0)
-      return true;
-    else if (strcmp(item, "<") == 0 && compare(l_value, r_value) < 0)
-      return true;
-    else if (strcmp(item, "<>") == 0 && strcmp(l_value, r_value) != 0)
-      return true;
-    else if (strcmp(item, "is") == 0 && compare(l_value,r_value) == 0)
-      return true;
-    else if (strcmp(item ,"is not") == 0 && compare(l_value,r_value)!=0)
-      return true;
-
+    if (schema->GetColumnIndex(attr->val_, index) != DB_SUCCESS) {
+      return false;
+    }
+    const Field *fie = row.GetField(index);
+    const char *item = ast->val_;
+    if (val->type_ == kNodeNull) {
+      if (strcmp(item, "is") == 0) return fie->IsNull();
+      if (strcmp(item, "not") == 0) return !fie->IsNull();
+      return false;
+    }
+    if (fie->IsNull()) {
+      return false;
+    }
+    int cmp = CompareLiteral(fie, val->val_);
+    if (strcmp(item, "=") == 0 || strcmp(item, "is") == 0) return cmp == 0;
+    if (strcmp(item, "<>") == 0 || strcmp(item, "not") == 0) return cmp != 0;
+    if (strcmp(item, ">") == 0) return cmp > 0;
+    if (strcmp(item, ">=") == 0) return cmp >= 0;
+    if (strcmp(item, "<") == 0) return cmp < 0;
+    if (strcmp(item, "<=") == 0) return cmp <= 0;
     return false;
   } else if (ast->type_ == kNodeConnector) {
     char *connector = ast->val_;
-    if (strcmp(connector, "and") == 0 && DFS(ast->child_, iter, schema) && DFS(ast->child_->next_, iter, schema))
-      return true;
-    else if (strcmp(connector, "or") == 0 && (DFS(ast->child_, iter, schema) || DFS(ast->child_->next_, iter, schema)))
+    if (strcmp(connector, "and") == 0)
+      return DFS(ast->child_, row, schema) && DFS(ast->child_->next_, row, schema);
+    else if (strcmp(connector, "or") == 0)
+      return DFS(ast->child_, row, schema) || DFS(ast->child_->next_, row, schema);
+    return false;
+  } else
+    return false;
+}
+
+/**
+ * Decide from the zone map whether any row of a page can satisfy a where condition.
+ * Comparisons the zone map cannot judge are taken as satisfiable.
+ */
+bool ZoneMayMatch(pSyntaxNode ast, const TableZoneMap &zone_map, Schema *schema, uint32_t page_index) {
+  if (ast->type_ == kNodeConnector) {
+    if (strcmp(ast->val_, "and") == 0)
+      return ZoneMayMatch(ast->child_, zone_map, schema, page_index) &&
+             ZoneMayMatch(ast->child_->next_, zone_map, schema, page_index);
+    if (strcmp(ast->val_, "or") == 0)
+      return ZoneMayMatch(ast->child_, zone_map, schema, page_index) ||
+             ZoneMayMatch(ast->child_->next_, zone_map, schema, page_index);
+    return true;
+  }
+  if (ast->type_ != kNodeCompareOperator) {
+    return true;
+  }
+  pSyntaxNode attr = ast->child_;
+  pSyntaxNode val = attr->next_;
+  uint32_t index;
+  if (schema->GetColumnIndex(attr->val_, index) != DB_SUCCESS || !zone_map.IsTracked(index)) {
+    return true;
+  }
+  const char *item = ast->val_;
+  if (val->type_ == kNodeNull) {
+    if (strcmp(item, "is") == 0) return zone_map.MayMatch(page_index, index, ZoneOp::kIsNull, 0);
+    if (strcmp(item, "not") == 0) return zone_map.MayMatch(page_index, index, ZoneOp::kNotNull, 0);
+    return false;
+  }
+  // the literal is converted the way DFS converts it
+  double value;
+  if (schema->GetColumn(index)->GetType() == kTypeInt) {
+    value = static_cast<int32_t>(strtol(val->val_, nullptr, 10));
+  } else {
+    value = strtof(val->val_, nullptr);
+  }
+  ZoneOp op;
+  if (strcmp(item, "=") == 0 || strcmp(item, "is") == 0) op = ZoneOp::kEq;
+  else if (strcmp(item, "<>") == 0 || strcmp(item, "not") == 0) op = ZoneOp::kNe;
+  else if (strcmp(item, ">") == 0) op = ZoneOp::kGt;
+  else if (strcmp(item, ">=") == 0) op = ZoneOp::kGe;
+  else if (strcmp(item, "<") == 0) op = ZoneOp::kLt;
+  else if (strcmp(item, "<=") == 0) op = ZoneOp::kLe;
+  else return true;
+  return zone_map.MayMatch(page_index, index, op, value);
+}
+
+/**
+ * Printable value of a field. Type::GetData hands out a temporary for numbers and char values are
+ * not null-terminated, so neither is printed from GetData directly.
+ */
+string FieldToString(const Field *field) {
+  if (field->IsNull()) {
+    return "null";
+  }
+  char buf[sizeof(int32_t)];
+  switch (field->GetTypeId()) {
+    case kTypeInt:
+      field->SerializeTo(buf);
+      return std::to_string(MACH_READ_FROM(int32_t, buf));
+    case kTypeFloat: {
+      field->SerializeTo(buf);
+      std::ostringstream out;
+      out << MACH_READ_FROM(float, buf);
+      return out.str();
+    }
+    default:
+      return string(field->GetData(), field->GetLength());
+  }
+}
+
+/**
+ * Collect the codes of a disjunction of equalities on one dictionary column, e.g. the expansion of IN.
+ * Literals no row ever held have no code and are left out. column_index starts as UINT32_MAX.
+ * @return false if the condition has another shape
+ */
+bool CollectCodes(pSyntaxNode ast, TableHeap *table_heap, Schema *schema, uint32_t *column_index,
+                  vector<uint32_t> *codes) {
+  if (ast->type_ == kNodeConnector) {
+    return strcmp(ast->val_, "or") == 0 && CollectCodes(ast->child_, table_heap, schema, column_index, codes) &&
+           CollectCodes(ast->child_->next_, table_heap, schema, column_index, codes);
+  }
+  if (ast->type_ != kNodeCompareOperator || strcmp(ast->val_, "=") != 0) {
+    return false;
+  }
+  pSyntaxNode attr = ast->child_;
+  pSyntaxNode val = attr->next_;
+  uint32_t index;
+  if (val->type_ == kNodeNull || schema->GetColumnIndex(attr->val_, index) != DB_SUCCESS ||
+      schema->GetColumnEncoding(index) != kEncodingDictionary) {
+    return false;
+  }
+  if (*column_index != index && *column_index != UINT32_MAX) {
+    return false;
+  }
+  *column_index = index;
+  uint32_t code = table_heap->FindCode(index, val->val_, strlen(val->val_));
+  if (code != ColumnDictionary::INVALID_CODE) {
+    codes->push_back(code);
+  }
+  return true;
+}
+
+/**
+ * Turn the conjuncts of a condition that test dictionary columns for equality into code filters,
+ * the condition itself is still evaluated on the rows that pass them
+ */
+void BuildCodeFilters(pSyntaxNode ast, TableHeap *table_heap, Schema *schema, vector<CodeFilter> *filters) {
+  if (ast->type_ == kNodeConnector && strcmp(ast->val_, "and") == 0) {
+    BuildCodeFilters(ast->child_, table_heap, schema, filters);
+    BuildCodeFilters(ast->child_->next_, table_heap, schema, filters);
+    return;
+  }
+  uint32_t column_index = UINT32_MAX;
+  vector<uint32_t> codes;
+  if (!CollectCodes(ast, table_heap, schema, &column_index, &codes)) {
+    return;
+  }
+  CodeFilter filter{column_index, vector<bool>(table_heap->GetDictionarySize(column_index), false)};
+  for (auto code : codes) {
+    filter.codes_[code] = true;
+  }
+  filters->push_back(std::move(filter));
+}
+
+/**
+ * Key of an index on one column holding a literal, converted the way DFS converts it
+ */
+vector<Field> LiteralKey(TypeId type, const char *literal) {
+  vector<Field> key;
+  if (type == kTypeInt) {
+    key.emplace_back(kTypeInt, static_cast<int32_t>(strtol(literal, nullptr, 10)));
+  } else if (type == kTypeFloat) {
+    key.emplace_back(kTypeFloat, strtof(literal, nullptr));
+  } else {
+    key.emplace_back(kTypeChar, const_cast<char *>(literal), strlen(literal), false);
+  }
+  return key;
+}
+
+/**
+ * @return the bitmap index on exactly this column, nullptr if there is none
+ */
+BitmapIndex *FindBitmapIndex(const vector<IndexInfo *> &indexes, uint32_t column_index) {
+  for (auto index_info : indexes) {
+    const vector<uint32_t> &key_map = index_info->GetMetadata()->GetKeyMapping();
+    if (index_info->GetMetadata()->GetIndexType() == kIndexBitmap && key_map.size() == 1 &&
+        key_map[0] == column_index) {
+      return dynamic_cast<BitmapIndex *>(index_info->GetIndex());
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Narrow a where condition down with the bitmap indexes of the table. Comparisons on columns without
+ * a bitmap index, and comparisons other than equality, are left to the caller: under AND the other
+ * side alone narrows the result, under OR nothing is known.
+ * @param[out] result superset of the rows satisfying the condition
+ * @return false if no bitmap index applies
+ */
+bool EvaluateBitmaps(pSyntaxNode ast, const vector<IndexInfo *> &indexes, Schema *schema, RoaringBitmap *result) {
+  if (ast->type_ == kNodeConnector) {
+    RoaringBitmap right;
+    bool has_left = EvaluateBitmaps(ast->child_, indexes, schema, result);
+    bool has_right = EvaluateBitmaps(ast->child_->next_, indexes, schema, &right);
+    if (strcmp(ast->val_, "and") == 0) {
+      if (has_left && has_right) {
+        result->And(right);
+      } else if (has_right) {
+        *result = std::move(right);
+      }
+      return has_left || has_right;
+    }
+    if (strcmp(ast->val_, "or") == 0 && has_left && has_right) {
+      result->Or(right);
       return true;
+    }
+    return false;
+  }
+  if (ast->type_ != kNodeCompareOperator) {
+    return false;
+  }
+  pSyntaxNode attr = ast->child_;
+  pSyntaxNode val = attr->next_;
+  uint32_t column_index;
+  if (schema->GetColumnIndex(attr->val_, column_index) != DB_SUCCESS) {
+    return false;
+  }
+  BitmapIndex *index = FindBitmapIndex(indexes, column_index);
+  if (index == nullptr) {
+    return false;
+  }
+  const char *item = ast->val_;
+  bool is_eq = strcmp(item, "=") == 0 || strcmp(item, "is") == 0;
+  bool is_ne = strcmp(item, "<>") == 0 || strcmp(item, "not") == 0;
+  if (!is_eq && !is_ne) {
+    return false;
+  }
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  SimpleMemHeap heap;
+  vector<Field> null_key;
+  null_key.emplace_back(type);
+  const RoaringBitmap *nulls = index->GetBitmap(Row(null_key, &heap));
+  result->Clear();
+  if (val->type_ == kNodeNull) {
+    // only is and not compare with null, see DFS
+    if (strcmp(item, "is") == 0 && nulls != nullptr) {
+      *result = *nulls;
+    } else if (strcmp(item, "not") == 0) {
+      *result = index->GetAllRows();
+      if (nulls != nullptr) {
+        result->AndNot(*nulls);
+      }
+    }
+    return true;
+  }
+  vector<Field> key = LiteralKey(type, val->val_);
+  const RoaringBitmap *matches = index->GetBitmap(Row(key, &heap));
+  if (is_eq) {
+    if (matches != nullptr) {
+      *result = *matches;
+    }
+    return true;
+  }
+  // null values are unequal to nothing either
+  *result = index->GetAllRows();
+  if (matches != nullptr) {
+    result->AndNot(*matches);
+  }
+  if (nulls != nullptr) {
+    result->AndNot(*nulls);
+  }
+  return true;
+}
 
+/**
+ * Bounds a where condition puts on one column, literals of the syntax tree, nullptr where the range is open
+ */
+struct KeyRange {
+  const char *lo_{nullptr};
+  bool lo_inclusive_{false};
+  const char *hi_{nullptr};
+  bool hi_inclusive_{false};
+};
+
+/**
+ * Narrow range down with a bound, the larger lower or the smaller upper one is kept
+ */
+void TightenBound(TypeId type, const char *literal, bool inclusive, bool lower, KeyRange *range) {
+  const char *&bound = lower ? range->lo_ : range->hi_;
+  bool &bound_inclusive = lower ? range->lo_inclusive_ : range->hi_inclusive_;
+  int cmp = bound == nullptr ? 0 : CompareLiteral(&LiteralKey(type, bound)[0], literal);
+  if (bound == nullptr || (lower ? cmp < 0 : cmp > 0)) {
+    bound = literal;
+    bound_inclusive = inclusive;
+  } else if (cmp == 0) {
+    bound_inclusive = bound_inclusive && inclusive;
+  }
+}
+
+/**
+ * Narrow the key range of a column down with the comparisons of the conjuncts of a condition
+ * @return false if no conjunct bounds the column
+ */
+bool CollectKeyRange(pSyntaxNode ast, Schema *schema, uint32_t column_index, KeyRange *range) {
+  if (ast->type_ == kNodeConnector) {
+    if (strcmp(ast->val_, "and") != 0) {
+      return false;
+    }
+    bool left = CollectKeyRange(ast->child_, schema, column_index, range);
+    bool right = CollectKeyRange(ast->child_->next_, schema, column_index, range);
+    return left || right;
+  }
+  if (ast->type_ != kNodeCompareOperator) {
     return false;
-  } else
+  }
+  pSyntaxNode attr = ast->child_;
+  pSyntaxNode val = attr->next_;
+  uint32_t index;
+  if (val->type_ == kNodeNull || schema->GetColumnIndex(attr->val_, index) != DB_SUCCESS || index != column_index) {
+    return false;
+  }
+  const Column *column = schema->GetColumn(column_index);
+  // index keys are sized for the values of the column, a longer literal is left to the scan
+  if (column->GetType() == kTypeChar && strlen(val->val_) > column->GetLength()) {
     return false;
+  }
+  const char *item = ast->val_;
+  bool is_eq = strcmp(item, "=") == 0 || strcmp(item, "is") == 0;
+  bool lower = is_eq || strcmp(item, ">") == 0 || strcmp(item, ">=") == 0;
+  bool upper = is_eq || strcmp(item, "<") == 0 || strcmp(item, "<=") == 0;
+  if (lower) {
+    TightenBound(column->GetType(), val->val_, is_eq || strcmp(item, ">=") == 0, true, range);
+  }
+  if (upper) {
+    TightenBound(column->GetType(), val->val_, is_eq || strcmp(item, "<=") == 0, false, range);
+  }
+  return lower || upper;
+}
+
+/**
+ * Pick the single column index that narrows a condition down the most, ranges bounded on both sides,
+ * such as equalities, before ranges open on one side
+ * @return nullptr if no ordered index applies
+ */
+IndexInfo *FindRangeIndex(pSyntaxNode condition, const vector<IndexInfo *> &indexes, Schema *schema,
+                          KeyRange *range) {
+  IndexInfo *best = nullptr;
+  for (auto index_info : indexes) {
+    const vector<uint32_t> &key_map = index_info->GetMetadata()->GetKeyMapping();
+    if (index_info->GetMetadata()->GetIndexType() != kIndexBPlusTree || key_map.size() != 1) {
+      continue;
+    }
+    KeyRange candidate;
+    if (!CollectKeyRange(condition, schema, key_map[0], &candidate)) {
+      continue;
+    }
+    if (best == nullptr || (candidate.lo_ != nullptr && candidate.hi_ != nullptr &&
+                            (range->lo_ == nullptr || range->hi_ == nullptr))) {
+      best = index_info;
+      *range = candidate;
+    }
+  }
+  return best;
+}
+
+/**
+ * Hand the rows of sorted row ids that satisfy the condition to consumer, reading each heap page once
+ * @return number of rows handed to consumer
+ */
+uint64_t FetchSortedRows(const vector<RowId> &rids, TableHeap *table_heap, Schema *schema, pSyntaxNode condition,
+                         const vector<uint32_t> *fetch_columns, const ParallelTableScan::Consumer &consumer) {
+  // rows are read a chunk at a time, a chunk of sorted row ids covers few pages, and share an arena that is
+  // reset for the next chunk
+  constexpr size_t FETCH_CHUNK_SIZE = 4096;
+  uint64_t count = 0;
+  vector<RowId> chunk;
+  vector<Row> rows;
+  ArenaMemHeap heap;
+  for (size_t begin = 0; begin < rids.size(); begin += FETCH_CHUNK_SIZE) {
+    chunk.assign(rids.begin() + begin, rids.begin() + std::min(rids.size(), begin + FETCH_CHUNK_SIZE));
+    rows.clear();
+    heap.Reset();
+    table_heap->GetTuples(chunk, nullptr, fetch_columns, &heap, &rows);
+    for (auto &row : rows) {
+      if (DFS(condition, row, schema)) {
+        consumer(row);
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Rows of the key range of a B+ tree index that satisfy the condition. By default the row ids of the whole
+ * range are collected and sorted first, so that every heap page is read once however the keys are spread
+ * over the table, as a bitmap heap scan does. With key_order the rows are fetched one by one as the leaves
+ * hand out their row ids, for callers that need the rows in key order.
+ * @param[out] count number of rows handed to consumer
+ * @return false if the index cannot take the bounds, e.g. a char literal too long for its keys, no row was
+ * handed out then
+ */
+bool ScanIndexRange(IndexInfo *index_info, const KeyRange &range, TableHeap *table_heap, Schema *schema,
+                    pSyntaxNode condition, const vector<uint32_t> *fetch_columns,
+                    const ParallelTableScan::Consumer &consumer, bool key_order, uint64_t *count) {
+  const Column *column = index_info->GetIndexKeySchema()->GetColumn(0);
+  TypeId type = column->GetType();
+  vector<Field> lo_key = range.lo_ == nullptr ? vector<Field>() : LiteralKey(type, range.lo_);
+  vector<Field> hi_key = range.hi_ == nullptr ? vector<Field>() : LiteralKey(type, range.hi_);
+  bool lo_inclusive = range.lo_inclusive_;
+  if (range.lo_ == nullptr && column->IsNullable()) {
+    // nulls sort first and satisfy no comparison
+    lo_key.emplace_back(type);
+    lo_inclusive = false;
+  }
+  Row lo(lo_key);
+  Row hi(hi_key);
+  *count = 0;
+  vector<RowId> rids;
+  // the consumer may update the index, the scan holds no latch while it runs
+  dberr_t res = index_info->GetIndex()->ScanRange(
+          lo_key.empty() ? nullptr : &lo, lo_inclusive, hi_key.empty() ? nullptr : &hi, range.hi_inclusive_, 0,
+          [&](const vector<RowId> &batch) {
+            if (!key_order) {
+              rids.insert(rids.end(), batch.begin(), batch.end());
+              return true;
+            }
+            for (auto &rid : batch) {
+              Row row(rid);
+              bool found = fetch_columns == nullptr ? table_heap->GetTuple(&row, nullptr)
+                                                    : table_heap->GetTuple(&row, nullptr, *fetch_columns);
+              if (found && DFS(condition, row, schema)) {
+                consumer(row);
+                (*count)++;
+              }
+            }
+            return true;
+          },
+          nullptr);
+  if (res != DB_SUCCESS) {
+    return false;
+  }
+  if (!key_order) {
+    TableHeap::SortRowIds(&rids);
+    *count = FetchSortedRows(rids, table_heap, schema, condition, fetch_columns, consumer);
+  }
+  return true;
+}
+
+/**
+ * Full scan of a table on the session's scan workers, a null condition accepts every row.
+ * Pages the zone map rules out for the condition are not read, rows of PAX pages that fail an
+ * equality on a dictionary column are not decoded. Rows reach consumer on the calling thread.
+ * If bitmap indexes narrow the condition down to at most half of the rows, only those rows are
+ * fetched, in row id order, and the condition is checked on each of them. Otherwise a condition that
+ * bounds a column with a B+ tree index is answered from the key range of the index, see ScanIndexRange.
+ */
+uint64_t ScanTable(TableHeap *table_heap, Schema *schema, pSyntaxNode condition, uint32_t workers,
+                   const vector<uint32_t> *fetch_columns, const ParallelTableScan::Consumer &consumer,
+                   const vector<IndexInfo *> *indexes = nullptr, bool key_order = false) {
+  RoaringBitmap candidates;
+  uint64_t row_count = 0;
+  for (uint32_t i = 0; indexes != nullptr && i < schema->GetColumnCount(); i++) {
+    BitmapIndex *index = FindBitmapIndex(*indexes, i);
+    if (index != nullptr) {
+      // every bitmap index holds every row
+      row_count = index->GetAllRows().GetCardinality();
+      break;
+    }
+  }
+  if (condition != nullptr && row_count > 0 && EvaluateBitmaps(condition, *indexes, schema, &candidates) &&
+      candidates.GetCardinality() * 2 <= row_count) {
+    // the candidates are copied out, consumers may update the indexes
+    vector<RowId> rids;
+    candidates.ToRowIds(&rids);
+    return FetchSortedRows(rids, table_heap, schema, condition, fetch_columns, consumer);
+  }
+  KeyRange range;
+  IndexInfo *range_index = condition == nullptr || indexes == nullptr
+                           ? nullptr : FindRangeIndex(condition, *indexes, schema, &range);
+  uint64_t count;
+  if (range_index != nullptr &&
+      ScanIndexRange(range_index, range, table_heap, schema, condition, fetch_columns, consumer, key_order, &count)) {
+    return count;
+  }
+  ParallelTableScan scan(table_heap, workers);
+  ParallelTableScan::Predicate predicate;
+  if (condition != nullptr) {
+    predicate = [condition, schema](const Row &row) { return DFS(condition, row, schema); };
+    const TableZoneMap &zone_map = table_heap->GetZoneMap();
+    scan.SetPageFilter([condition, schema, &zone_map](uint32_t page_index) {
+      return ZoneMayMatch(condition, zone_map, schema, page_index);
+    });
+    if (table_heap->IsPax() && schema->GetCodec().HasDictionaryColumns()) {
+      vector<CodeFilter> code_filters;
+      BuildCodeFilters(condition, table_heap, schema, &code_filters);
+      scan.SetCodeFilters(std::move(code_filters));
+    }
+  }
+  return scan.Execute(predicate, consumer, fetch_columns);
+}
+
+/**
+ * Append the indexes of the columns a condition refers to
+ */
+void CollectColumns(pSyntaxNode ast, Schema *schema, vector<uint32_t> &columns) {
+  if (ast == nullptr) return;
+  if (ast->type_ == kNodeCompareOperator) {
+    uint32_t index;
+    if (schema->GetColumnIndex(ast->child_->val_, index) == DB_SUCCESS &&
+        std::find(columns.begin(), columns.end(), index) == columns.end()) {
+      columns.push_back(index);
+    }
+  } else if (ast->type_ == kNodeConnector) {
+    CollectColumns(ast->child_, schema, columns);
+    CollectColumns(ast->child_->next_, schema, columns);
+  }
 }
 
 dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context) {
@@ -310,6 +790,7 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   bool nullable;
   bool unique;
   vector<string> index_column;
+  vector<uint32_t> dictionary_columns;
 
   while (tmp != nullptr && tmp->type_!=kNodeColumnList) {
     nullable = true;
@@ -319,6 +800,8 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
         unique = true;
       } else if (tmp->val_ == constraint[1]) {
         nullable = false;
+      } else if (strcmp(tmp->val_, "dictionary") == 0) {
+        dictionary_columns.push_back(index);
       }
     }
 
@@ -357,7 +840,48 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   }
 
   TableSchema *schema = new TableSchema(columns);
-  if (cata->CreateTable(table_name, schema, nullptr, table_info) == DB_SUCCESS) {
+  // new tables use the compact row format, tables created before keep v1
+  schema->SetRowFormat(kRowFormatV2);
+  string error;
+  bool compressed = false;
+  for (pSyntaxNode option = ast->child_->next_->next_; option != nullptr; option = option->next_) {
+    if (option->type_ == kNodeTableCompression) {
+      compressed = true;
+    } else if (option->type_ == kNodeTableLayout) {
+      string layout_name = option->child_->val_;
+      if (layout_name == "pax") {
+        schema->SetRowFormat(kRowFormatPax);
+      } else if (layout_name != "row") {
+        error = "unknown table layout " + layout_name + ", expected row or pax";
+      }
+    }
+  }
+  // dictionary codes live in the column minipages, only PAX pages have them
+  for (uint32_t i = 0; i < dictionary_columns.size() && error.empty(); i++) {
+    uint32_t column_index = dictionary_columns[i];
+    const Column *column = schema->GetColumn(column_index);
+    if (schema->GetRowFormat() != kRowFormatPax) {
+      error = "dictionary column " + column->GetName() + " needs the pax layout";
+    } else if (column->GetType() != kTypeChar) {
+      error = "dictionary column " + column->GetName() + " is not a char column";
+    } else if (column->GetLength() > OverflowPage::MAX_DATA_SIZE - 2 * sizeof(uint16_t)) {
+      error = "dictionary column " + column->GetName() + " is too long";
+    } else {
+      schema->SetColumnEncoding(column_index, kEncodingDictionary);
+    }
+  }
+  if (error.empty() && schema->GetRowFormat() == kRowFormatPax && schema->GetCodec().GetPaxCapacity() == 0) {
+    error = "a row of this table does not fit a PAX page";
+  }
+  if (!error.empty()) {
+    printf("[ERROR] Create table failed: %s!\n", error.c_str());
+    delete schema;
+    for (auto column : columns) {
+      delete column;
+    }
+    return DB_FAILED;
+  }
+  if (cata->CreateTable(table_name, schema, nullptr, table_info, compressed) == DB_SUCCESS) {
 
     for(auto column : index_column){
       IndexInfo *index_info;
@@ -447,31 +971,37 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     tmp = tmp->next_;
   }
 
+  IndexType index_type = kIndexBPlusTree;
+  pSyntaxNode type_node = ast->child_->next_->next_->next_;
+  if (type_node != nullptr && type_node->type_ == kNodeIndexType) {
+    string type_name = type_node->child_->val_;
+    if (type_name == "bitmap") {
+      index_type = kIndexBitmap;
+    } else if (type_name != "btree") {
+      printf("[ERROR] Create index failed: unknown index type %s, expected btree or bitmap!\n", type_name.c_str());
+      return DB_FAILED;
+    }
+  }
+
   IndexInfo *index_info;
-  if (cata->CreateIndex(table_name, index_name, index_keys, nullptr, index_info) != DB_SUCCESS) {
+  if (cata->CreateIndex(table_name, index_name, index_keys, nullptr, index_info, index_type) != DB_SUCCESS) {
     printf("[ERROR] Create index failed!\n");
     return DB_FAILED;
   } else {
-    IndexMetadata *meta = index_info->GetMetadata();
-    std::vector<uint32_t> key_map = meta->GetKeyMapping();
-    TableInfo *table_info = index_info->GetTableInfo();
-    TableHeap *table_heap = table_info->GetTableHeap();
-    TableIterator iter = table_heap->Begin(nullptr);
-    Index *index_ = index_info->GetIndex();
-    std::vector<Field> field;
-    double total_time = 0;
-    while (iter != table_heap->End()) {
-      field.clear();
-      for (auto ind : key_map) {
-        field.push_back(*(iter->GetField(ind)));
+    // the rows already in the table are sorted and loaded bottom up instead of inserted one by one
+    auto t1 = Clock::now();
+    dberr_t res = cata->RebuildIndex(index_info);
+    if (res != DB_SUCCESS) {
+      cata->DropIndex(table_name, index_name);
+      if (res == DB_KEY_TOO_LARGE) {
+        printf("[ERROR] Create index failed: the key of a row is too long for the index!\n");
+      } else {
+        printf("[ERROR] Create index failed: the rows of the table could not be loaded!\n");
       }
-      Row entry(field);
-      auto t1 = Clock::now();
-      index_->InsertEntry(entry, iter->GetRowId(), nullptr);
-      auto t2 = Clock::now();
-      total_time = total_time + std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
-      ++iter;
+      return DB_FAILED;
     }
+    auto t2 = Clock::now();
+    double total_time = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
 
     printf("[INFO] Create index successfully!\n");
     cerr<<"\ntotal time:"<<total_time/1e+6<<"ms\n";
@@ -510,6 +1040,9 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   DBStorageEngine *engine = (dbs_.find(current_db_))->second;
   CatalogManager *cata = engine->catalog_mgr_;
 
+  if (ast->child_->type_ == kNodeAggregateList) {
+    return ExecuteAggregate(ast, context);
+  }
   ast = ast->child_;
   string tablename = ast->next_->val_;
   TableInfo *table_info = NULL;
@@ -533,16 +1066,15 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     ast = ast->child_;
 
     TableHeap *table_heap = table_info->GetTableHeap();
-    auto iter1 = table_heap->Begin(nullptr);
-    for (TableIterator iter = table_heap->Begin(NULL); iter != table_heap->End(); ++iter) {
+    ScanTable(table_heap, schema, nullptr, scan_workers_, nullptr, [&](Row &row) {
       for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
         cout << "|";
-        cout << left << setfill(' ') << setw(20) << (*iter).GetField(i)->GetData();
+        cout << left << setfill(' ') << setw(20) << FieldToString(row.GetField(i));
       }
       cout << "|" << endl;
       cout << left << setfill('-') << setw(size_table) << '-';
       cout << endl;
-    }
+    });
     return DB_SUCCESS;
   } else if (ast->type_ == kNodeColumnList && ast->next_->next_ == NULL) {  //有投影但无条件
 
@@ -566,23 +1098,22 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     cout << endl;
 
 
+    // values of columns not projected stay in their overflow pages
+    vector<uint32_t> fetch;
+    for (auto &name : column_name) {
+      uint32_t index;
+      if (schema->GetColumnIndex(name, index) == DB_SUCCESS) fetch.push_back(index);
+    }
     TableHeap *table_heap = table_info->GetTableHeap();
-    for (TableIterator iter = table_heap->Begin(NULL); iter != table_heap->End(); ++iter) {
-      
-      for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {   
-        for (auto name : column_name){
-          if (schema->GetColumn(i)->GetName() == name) {
-          cout << "|";
-          cout << left << setfill(' ')<<setw(20) << (*iter).GetField(i)->GetData();
-          
-        }
-        }    
-        
+    ScanTable(table_heap, schema, nullptr, scan_workers_, &fetch, [&](Row &row) {
+      for (auto index : fetch) {
+        cout << "|";
+        cout << left << setfill(' ') << setw(20) << FieldToString(row.GetField(index));
       }
       cout << "|" << endl;
       cout << left << setfill('-') << setw(size_table) << '-';
       cout << endl;
-    }
+    });
     return DB_SUCCESS;
   } else if (ast->type_ == kNodeAllColumns && ast->next_->next_ != NULL) {  //无投影但有条件
     //有索引
@@ -597,151 +1128,22 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     cout << left << setfill('-') << setw(size_table) << '-';
     cout << endl;
 
-    pSyntaxNode tmp = ast->next_->next_->child_;
-    if (tmp->type_ == kNodeCompareOperator) {
-      string attr_name = ast->next_->next_->child_->child_->val_;
-      vector<IndexInfo *> indexes;
-      auto compare = tmp->val_;
-      auto val = tmp->child_->next_->val_;
-      cata->GetTableIndexes(tablename, indexes);
-      for (auto index : indexes) {
-        Schema *schema = index->GetIndexKeySchema();
-        vector<Column *> cols;
-        cols = schema->GetColumns();
-        if (cols.size() == 1 && cols.at(0)->GetName() == attr_name) {
-          uint32_t id = cols.at(0)->GetTableInd();
-          TypeId type = cols.at(0)->GetType();
-          auto idx = dynamic_cast<BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> *>(index->GetIndex());
-          vector<Field *> tmp_fie;
-          if (type == kTypeInt) {
-            auto fie = new Field(kTypeInt, (int32_t)StringToInt(val));
-            tmp_fie.push_back(fie);
-          } else if (type == kTypeFloat) {
-            auto fie = new Field(kTypeFloat, StringToFloat(val));
-            tmp_fie.push_back(fie);
-          } else {
-            auto fie = new Field(kTypeChar, val, strlen(val), false);
-            tmp_fie.push_back(fie);
-          }
-          vector<Field> fields;
-          for (auto fie : tmp_fie) fields.push_back(*fie);
-
-          Row key(fields);
-          GenericKey<64> Key;
-          Key.SerializeFromKey(key, schema);
-          if (strcmp(compare, "=") == 0) {
-            auto iter = idx->GetBeginIterator(Key);
-            Row row((*iter).second);
-            TableHeap *table_heap = table_info->GetTableHeap();
-            table_heap->GetTuple(&row, nullptr);
-            vector<Field *> field_;
-            field_ = row.GetFields();
-            for (auto field : field_) {
-              cout << "|";
-              cout << left <<setfill(' ')<< setw(20) << field->GetData();
-            }
-            cout << "|"<<endl;
-            cout << left << setfill('-') << setw(size_table) << '-';
-            cout << endl;
-          } else if (strcmp(compare, "<") == 0) {
-            auto iter = idx->GetBeginIterator();
-            for (; iter != idx->GetEndIterator(); ++iter) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              if (strcmp(field_[id]->GetData(), val) < 0) {
-                for (auto field : field_) {
-                  cout << "|";
-                  cout << left << setfill(' ')<<setw(20) << field->GetData();
-                }
-                cout << "|"<<endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              } else break;
-            }
-          } else if (strcmp(compare, "<=") == 0) {
-            auto iter = idx->GetBeginIterator();
-            for (; iter != idx->GetEndIterator(); ++iter) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              if (strcmp(field_[id]->GetData(), val) <= 0) {
-                for (auto field : field_) {
-                  cout << "|";
-                  cout << left << setfill(' ')<<setw(20) << field->GetData();
-                  /*for (auto x = field->GetData(); *x != '\0'; x++)
-                    printf("%d ", (int)*x);*/
-                }
-                cout << "|"<<endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              } else break;
-            }
-          } else if (strcmp(compare, "<>") == 0) {
-            auto tmp = idx->GetBeginIterator(Key);
-            if (tmp.GetFlag() == 1) {
-              for (auto iter = idx->GetBeginIterator(); iter != idx->GetEndIterator(); ++iter) {
-                if (iter == tmp) ++iter;
-                Row row((*iter).second);
-                TableHeap *table_heap = table_info->GetTableHeap();
-                table_heap->GetTuple(&row, nullptr);
-                vector<Field *> field_;
-                field_ = row.GetFields();
-                for (auto field : field_) {
-                  cout <<"|";
-                  cout << left << setfill(' ') << setw(20) << field->GetData();
-                }
-                cout << "|"<<endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              }
-            }
-          }else {
-            auto iter = idx->GetBeginIterator(Key);
-            if (iter.GetFlag() == 1 && strcmp(compare, ">") == 0) ++iter;
-            while (iter != idx->GetEndIterator()) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              for (auto field : field_) {
-                cout << "|";
-                cout << left << setfill(' ')<<setw(20) << field->GetData();
-              }
-              cout << "|"<<endl;
-              cout << left << setfill('-') << setw(size_table) << '-';
-              cout << endl;
-              ++iter;
-            }
-          }
-          return DB_SUCCESS;
-        }
-      }
-    }
-
-    //没索引
     ast = ast->next_;
     ast = ast->next_;
     ast = ast->child_;
 
+    vector<IndexInfo *> table_indexes;
+    cata->GetTableIndexes(tablename, table_indexes);
     TableHeap *table_heap = table_info->GetTableHeap();
-    auto iter1 = table_heap->Begin(nullptr);
-    for (TableIterator iter = table_heap->Begin(NULL); iter != table_heap->End(); ++iter) {
-      if (DFS(ast, iter, schema)) {
-        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
-          cout << "|";
-          cout << left << setfill(' ')<<setw(20) << (*iter).GetField(i)->GetData();
-        }
-        cout << "|"<<endl;
-        cout << left << setfill('-') << setw(size_table) << '-';
-        cout << endl;
+    ScanTable(table_heap, schema, ast, scan_workers_, nullptr, [&](Row &row) {
+      for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+        cout << "|";
+        cout << left << setfill(' ') << setw(20) << FieldToString(row.GetField(i));
       }
-    }
+      cout << "|" << endl;
+      cout << left << setfill('-') << setw(size_table) << '-';
+      cout << endl;
+    }, &table_indexes, index_key_order_);
     return DB_SUCCESS;
   } else if (ast->type_ == kNodeColumnList && ast->next_->next_ != NULL) {  //有投影且有条件
     //有索引
@@ -755,6 +1157,8 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
       ind.push_back(id_);
       list = list->next_;
     }
+    vector<uint32_t> fetch = ind;
+    CollectColumns(ast->next_->next_->child_, schema, fetch);
 
     int size_table = 20 * column_name.size() + column_name.size() + 1;
     cout << left << setfill('-') << setw(size_table) << '-';
@@ -767,157 +1171,178 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     cout << left << setfill('-') << setw(size_table) << '-';
     cout << endl;
 
+
+    // column name
     pSyntaxNode tmp = ast->next_->next_->child_;
-    if (tmp->type_ == kNodeCompareOperator) {
-      string attr_name = ast->next_->next_->child_->child_->val_;
-      vector<IndexInfo *> indexes;
-      auto compare = tmp->val_;
-      auto val = tmp->child_->next_->val_;
-      cata->GetTableIndexes(tablename, indexes);
-
-      for (auto index : indexes) {
-        Schema *sch = index->GetIndexKeySchema();
-        vector<Column *> cols;
-        cols = sch->GetColumns();
-        if (cols.size() == 1 && cols.at(0)->GetName() == attr_name) {
-          uint32_t id = cols.at(0)->GetTableInd();
-          TypeId type = cols.at(0)->GetType();
-          auto idx = dynamic_cast<BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> *>(index->GetIndex());
-          vector<Field *> tmp_fie;
-          if (type == kTypeInt) {
-            auto fie = new Field(kTypeInt, (int32_t)StringToInt(val));
-            tmp_fie.push_back(fie);
-          } else if (type == kTypeFloat) {
-            auto fie = new Field(kTypeFloat, StringToFloat(val));
-            tmp_fie.push_back(fie);
-          } else {
-            auto fie = new Field(kTypeChar, val, strlen(val), false);
-            tmp_fie.push_back(fie);
-          }
-          vector<Field> fields;
-          for (auto fie : tmp_fie) fields.push_back(*fie);
-
-          Row key(fields);
-          GenericKey<64> Key;
-          Key.SerializeFromKey(key, sch);
-          if (strcmp(compare, "=") == 0) {
-            auto iter = idx->GetBeginIterator(Key);
-            Row row((*iter).second);
-            TableHeap *table_heap = table_info->GetTableHeap();
-            table_heap->GetTuple(&row, nullptr);
-            for (auto id_ : ind) {
-              cout<< "|";
-              cout << left << setfill(' ')<<setw(20) << row.GetField(id_)->GetData();
-            }
-            cout << "|" << endl;
-            cout << left << setfill('-') << setw(size_table) << '-';
-            cout << endl;
-          } else if (strcmp(compare, "<") == 0) {
-            auto iter = idx->GetBeginIterator();
-            for (; iter != idx->GetEndIterator(); ++iter) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              if (strcmp(field_[id]->GetData(), val) < 0) {
-                for (auto id_ : ind) {
-                  cout << "|";
-                  cout << left << setfill(' ')<<setw(20) << row.GetField(id_)->GetData();
-                }
-                cout << "|" << endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              } else break;
-            }
-          } else if (strcmp(compare, "<=") == 0) {
-            auto iter = idx->GetBeginIterator();
-            for (; iter != idx->GetEndIterator(); ++iter) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              if (strcmp(field_[id]->GetData(), val) <= 0) {
-                for (auto id_ : ind) {
-                  cout << "|";
-                  cout << left << setfill(' ')<<setw(20) << row.GetField(id_)->GetData();
-                }
-                cout << "|" << endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              } else break;
-            }
-          } else if (strcmp(compare, "<>") == 0) {
-            auto tmp = idx->GetBeginIterator(Key);
-            if (tmp.GetFlag() == 1) {
-              for (auto iter = idx->GetBeginIterator(); iter != idx->GetEndIterator(); ++iter) {
-                if (iter == tmp) ++iter;
-                Row row((*iter).second);
-                TableHeap *table_heap = table_info->GetTableHeap();
-                table_heap->GetTuple(&row, nullptr);
-                vector<Field *> field_;
-                field_ = row.GetFields();
-                for (auto id_ : ind) {
-                  cout << "|";
-                  cout << left << setfill(' ')<<setw(20) << row.GetField(id_)->GetData();
-                }
-                cout << "|" << endl;
-                cout << left << setfill('-') << setw(size_table) << '-';
-                cout << endl;
-              }
-            }
-          } else {
-            auto iter = idx->GetBeginIterator(Key);
-            if (iter.GetFlag() == 1 && strcmp(compare, ">") == 0) ++iter;
-            while (iter != idx->GetEndIterator()) {
-              Row row((*iter).second);
-              TableHeap *table_heap = table_info->GetTableHeap();
-              table_heap->GetTuple(&row, nullptr);
-              vector<Field *> field_;
-              field_ = row.GetFields();
-              for (auto id_ : ind) {
-                cout<< "|";
-                cout << left << setfill(' ')<<setw(20) << row.GetField(id_)->GetData();
-              }
-              cout << "|" << endl;
-              cout << left << setfill('-') << setw(size_table) << '-';
-              cout << endl;
-              ++iter;
-            }
-          }
-          return DB_SUCCESS;
-        }
+    // tmp = tmp->child_;  // Operator or connector
+    vector<IndexInfo *> table_indexes;
+    cata->GetTableIndexes(tablename, table_indexes);
+    TableHeap *table_heap = table_info->GetTableHeap();
+    ScanTable(table_heap, schema, tmp, scan_workers_, &fetch, [&](Row &row) {
+      for (auto index : ind) {
+        cout << "|";
+        cout << left << setfill(' ') << setw(20) << FieldToString(row.GetField(index));
       }
+      cout << "|" << endl;
+      cout << left << setfill('-') << setw(size_table) << '-';
+      cout << endl;
+    }, &table_indexes, index_key_order_);
+
+
+    return DB_SUCCESS;
+  }
+  return DB_FAILED;
+}
+
+/**
+ * Smallest or largest non-null key of a B+ tree index on column_index alone, nulls are skipped by the index
+ * @param[out] empty true if the column holds no value but null
+ * @return false if there is no such index or it cannot answer
+ */
+bool GetIndexEndpoint(const vector<IndexInfo *> &indexes, uint32_t column_index, bool max, Row &key, bool *empty) {
+  for (auto index_info : indexes) {
+    const vector<uint32_t> &key_map = index_info->GetMetadata()->GetKeyMapping();
+    if (key_map.size() != 1 || key_map[0] != column_index) {
+      continue;
     }
+    Index *index = index_info->GetIndex();
+    dberr_t res = max ? index->GetMaxKey(key) : index->GetMinKey(key);
+    if (res == DB_SUCCESS || res == DB_KEY_NOT_FOUND) {
+      *empty = res == DB_KEY_NOT_FOUND;
+      return true;
+    }
+  }
+  return false;
+}
 
-    //没索引
+dberr_t ExecuteEngine::ExecuteAggregate(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAggregate" << std::endl;
+#endif
+  if (dbs_.find(current_db_) == dbs_.end()) {
+    cout << "[INFO] No database selected" << endl;
+    return DB_FAILED;
+  }
+  CatalogManager *cata = dbs_[current_db_]->catalog_mgr_;
+  pSyntaxNode list = ast->child_;
+  string table_name = list->next_->val_;
+  pSyntaxNode condition = list->next_->next_ == nullptr ? nullptr : list->next_->next_->child_;
+  TableInfo *table_info = nullptr;
+  if (cata->GetTable(table_name, table_info) != DB_SUCCESS) {
+    cout << "[INFO] Table " << table_name << " does not exist" << endl;
+    return DB_TABLE_NOT_EXIST;
+  }
+  Schema *schema = table_info->GetSchema();
 
-    // column name
-    tmp = ast->next_->next_->child_;
-    // tmp = tmp->child_;  // Operator or connector
-    TableHeap *table_heap = table_info->GetTableHeap();
-    for (TableIterator iter = table_heap->Begin(NULL); iter != table_heap->End(); ++iter) {
-      if (DFS(tmp, iter, schema)) {
-        
-        for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
-          for (auto name : column_name){
-          if (schema->GetColumn(i)->GetName() == name) {
-          cout << "|";
-          cout << left << setfill(' ')<<setw(20) << (*iter).GetField(i)->GetData();
+  enum Function { kCountRows, kCount, kMin, kMax };
+  struct Aggregate {
+    Function function;
+    uint32_t column_index;
+    string header;
+    uint64_t count{0};
+    std::unique_ptr<Field> value;
+  };
+  vector<Aggregate> aggregates;
+  for (pSyntaxNode node = list->child_; node != nullptr; node = node->next_) {
+    string name = node->val_;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    bool all_columns = node->child_->type_ == kNodeAllColumns;
+    Aggregate aggregate{kCountRows, 0, name + "(" + (all_columns ? string("*") : string(node->child_->val_)) + ")"};
+    if (name == "count") {
+      aggregate.function = all_columns ? kCountRows : kCount;
+    } else if ((name == "min" || name == "max") && !all_columns) {
+      aggregate.function = name == "min" ? kMin : kMax;
+    } else {
+      cout << "[INFO] Unsupported aggregate " << aggregate.header << endl;
+      return DB_FAILED;
+    }
+    if (!all_columns && schema->GetColumnIndex(node->child_->val_, aggregate.column_index) != DB_SUCCESS) {
+      cout << "[INFO] Column " << node->child_->val_ << " does not exist" << endl;
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
+    aggregates.push_back(std::move(aggregate));
+  }
+
+  vector<IndexInfo *> indexes;
+  cata->GetTableIndexes(table_name, indexes);
+  // without a condition, answer what the metadata and the indexes can answer and scan for the rest
+  bool need_scan = condition != nullptr;
+  SimpleMemHeap heap;
+  for (auto &aggregate : aggregates) {
+    if (need_scan) {
+      break;
+    }
+    if (aggregate.function == kCountRows) {
+      need_scan = cata->GetRowCount(table_name, aggregate.count) != DB_SUCCESS;
+    } else if (aggregate.function == kMin || aggregate.function == kMax) {
+      Row key(INVALID_ROWID);
+      bool empty = false;
+      if (!GetIndexEndpoint(indexes, aggregate.column_index, aggregate.function == kMax, key, &empty)) {
+        need_scan = true;
+      } else if (!empty) {
+        aggregate.value.reset(new Field(*key.GetField(0)));
+      }
+    } else {
+      need_scan = true;
+    }
+  }
+  if (need_scan) {
+    for (auto &aggregate : aggregates) {
+      aggregate.count = 0;
+      aggregate.value.reset();
+    }
+    vector<uint32_t> fetch;
+    for (auto &aggregate : aggregates) {
+      if (aggregate.function != kCountRows &&
+          std::find(fetch.begin(), fetch.end(), aggregate.column_index) == fetch.end()) {
+        fetch.push_back(aggregate.column_index);
+      }
+    }
+    CollectColumns(condition, schema, fetch);
+    ScanTable(table_info->GetTableHeap(), schema, condition, scan_workers_, &fetch, [&](Row &row) {
+      for (auto &aggregate : aggregates) {
+        if (aggregate.function == kCountRows) {
+          aggregate.count++;
+          continue;
         }
-        } 
+        Field *field = row.GetField(aggregate.column_index);
+        if (field->IsNull()) {
+          continue;
+        }
+        aggregate.count++;
+        if (aggregate.value == nullptr ||
+            (aggregate.function == kMin && field->CompareLessThan(*aggregate.value) == kTrue) ||
+            (aggregate.function == kMax && field->CompareGreaterThan(*aggregate.value) == kTrue)) {
+          aggregate.value.reset(new Field(*field));
         }
-        cout << "|" << endl;
-        cout << left << setfill('-') << setw(size_table) << '-';
-        cout << endl;
       }
-    }
-    
+    }, &indexes);
+  }
 
-    return DB_SUCCESS;
+  int size_table = 20 * aggregates.size() + aggregates.size() + 1;
+  cout << left << setfill('-') << setw(size_table) << '-';
+  cout << endl;
+  for (auto &aggregate : aggregates) {
+    cout << "|";
+    cout << left << setfill(' ') << setw(20) << aggregate.header;
   }
-  return DB_FAILED;
+  cout << "|" << endl;
+  cout << left << setfill('-') << setw(size_table) << '-';
+  cout << endl;
+  for (auto &aggregate : aggregates) {
+    cout << "|";
+    string value;
+    if (aggregate.function == kCountRows || aggregate.function == kCount) {
+      value = std::to_string(aggregate.count);
+    } else {
+      value = aggregate.value == nullptr ? "null" : FieldToString(aggregate.value.get());
+    }
+    cout << left << setfill(' ') << setw(20) << value;
+  }
+  cout << "|" << endl;
+  cout << left << setfill('-') << setw(size_table) << '-';
+  cout << endl;
+  return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
@@ -958,10 +1383,14 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
   //构造row
 
   TableHeap *table_heap = table_info->GetTableHeap();
-  Row *row = new Row(fields_);
-  table_heap->InsertTuple(*row, nullptr);
+  Row row(fields_, &context->heap_);
+  if (!table_heap->InsertTuple(row, nullptr)) {
+    printf("[INFO] Insert failed!\n");
+    return DB_FAILED;
+  }
   std::vector<IndexInfo *> indexes;
   if (cata->GetTableIndexes(table_name, indexes) == DB_SUCCESS) {
+    std::vector<Row> index_rows;
     for (auto index_info : indexes) {
       IndexMetadata *meta = index_info->GetMetadata();
       std::vector<uint32_t> key_map = meta->GetKeyMapping();
@@ -970,17 +1399,27 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
       for (auto id : key_map) {
         fies.push_back(fields_.at(id));
       }
-      Row row_index(fies);
-      if (index_->InsertEntry(row_index, row->GetRowId(), nullptr) == DB_SUCCESS) {
-        //printf("[INFO] Insert successfully!\n");
-        //return DB_SUCCESS;
-      } else {
-        table_heap->MarkDelete(row->GetRowId(),nullptr);
-        printf("[INFO] Insert failed!\n");
+      Row row_index(fies, &context->heap_);
+      dberr_t res = index_->InsertEntry(row_index, row.GetRowId(), nullptr);
+      if (res != DB_SUCCESS) {
+        // the indexes before this one already hold the row
+        for (size_t i = 0; i < index_rows.size(); i++) {
+          indexes[i]->GetIndex()->RemoveEntry(index_rows[i], row.GetRowId(), nullptr);
+        }
+        table_heap->MarkDelete(row.GetRowId(),nullptr);
+        table_heap->ApplyDelete(row.GetRowId(), nullptr);
+        if (res == DB_KEY_TOO_LARGE) {
+          printf("[INFO] Insert failed: the key is too long for index %s!\n", index_info->GetIndexName().c_str());
+        } else {
+          printf("[INFO] Insert failed!\n");
+        }
         return DB_FAILED;
       }
+      index_rows.push_back(row_index);
     }
   }
+  table_info->GetTableStats()->OnInsert(row);
+  table_info->GetTableMetadata()->OnInsert();
   printf("[INFO] Insert successfully!\n");
   return DB_SUCCESS;
 }
@@ -992,60 +1431,37 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
   pSyntaxNode tmp = ast->child_;
   DBStorageEngine *engine = (dbs_.find(current_db_))->second;
   CatalogManager *cata = engine->catalog_mgr_;
-  if (tmp->next_ == NULL) {
-    string table_name = tmp->val_;
-    TableInfo *table_info;
-    std::vector<IndexInfo *> indexes;
-    cata->GetTable(table_name, table_info);
-    cata->GetTableIndexes(table_name, indexes);
-    TableHeap *table_heap = table_info->GetTableHeap();
-    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
-      if (indexes.size() != 0) {
-        for (auto index : indexes) {
-          Index *idx = index->GetIndex();
-          std::vector<Field> fields_;
-          IndexMetadata *meta = index->GetMetadata();
-          std::vector<uint32_t> key_map = meta->GetKeyMapping();
-          for (auto id : key_map) {
-            fields_.push_back(*(iter->GetField(id)));
-          }
-          Row delete_row(fields_);
-          RowId tmp;
-          idx->RemoveEntry(delete_row, tmp, nullptr);
-        }
+  string table_name = tmp->val_;
+  TableInfo *table_info;
+  std::vector<IndexInfo *> indexes;
+  cata->GetTable(table_name, table_info);
+  cata->GetTableIndexes(table_name, indexes);
+  Schema *schema = table_info->GetSchema();
+  TableHeap *table_heap = table_info->GetTableHeap();
+  pSyntaxNode condition = tmp->next_ == NULL ? NULL : tmp->next_->child_;
+  // deleting only marks the slot, so it is safe to apply while the workers are still scanning, the slots
+  // and the overflow chains of the rows are freed once the scan is over
+  std::vector<RowId> deleted;
+  ScanTable(table_heap, schema, condition, scan_workers_, nullptr, [&](Row &row) {
+    for (auto index : indexes) {
+      Index *idx = index->GetIndex();
+      IndexMetadata *meta = index->GetMetadata();
+      std::vector<uint32_t> key_map = meta->GetKeyMapping();
+      std::vector<Field> fields;
+      for (auto id : key_map) {
+        fields.push_back(*(row.GetField(id)));
       }
-      table_heap->MarkDelete(iter->GetRowId(), nullptr);
+      Row delete_row(fields, &context->heap_);
+      idx->RemoveEntry(delete_row, row.GetRowId(), nullptr);
     }
-  } else {
-    string table_name = tmp->val_;
-    TableInfo *table_info;
-    std::vector<IndexInfo *> indexes;
-    cata->GetTable(table_name, table_info);
-    Schema *schema = table_info->GetSchema();
-    TableHeap *table_heap = table_info->GetTableHeap();
-    tmp = tmp->next_;
-    tmp = tmp->child_;
-    cata->GetTableIndexes(table_name, indexes);
-
-    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
-      if (DFS(tmp, iter, schema)) {
-        if (indexes.size() != 0) {
-          for (auto index : indexes) {
-            Index *idx = index->GetIndex();
-            IndexMetadata *meta = index->GetMetadata();
-            std::vector<uint32_t> key_map = meta->GetKeyMapping();
-            std::vector<Field> fields;
-            for (auto id : key_map) {
-              fields.push_back(*(iter->GetField(id)));
-            }
-            Row delete_row(fields);
-            RowId tmp;
-            idx->RemoveEntry(delete_row, tmp, nullptr);
-          }
-        }
-        table_heap->MarkDelete(iter->GetRowId(), nullptr);
-      }
+    if (table_heap->MarkDelete(row.GetRowId(), nullptr)) {
+      deleted.push_back(row.GetRowId());
     }
+    table_info->GetTableStats()->OnDelete(row);
+    table_info->GetTableMetadata()->OnDelete();
+  }, &indexes);
+  for (auto &rid : deleted) {
+    table_heap->ApplyDelete(rid, nullptr);
   }
   return DB_FAILED;
 }
@@ -1099,100 +1515,77 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
         tmp = tmp->next_;
       }
   
-  if (tmp2 == NULL){// no conditionsiter++
-  
-    for (auto iter = table_heap->Begin(NULL); iter!=table_heap->End(); ++iter){
-      //cout << "7777" << endl;
-      for (auto index : indexes){
-          Index* idx = index->GetIndex();
-          std::vector<Field> fields_1;
-          std::vector<Field> fields_2;
-          IndexMetadata * meta = index->GetMetadata();
-          std::vector<uint32_t> key_map = meta->GetKeyMapping();
-          for (auto id: key_map){
-            fields_1.push_back(*(iter->GetField(id)));
-            if(map_.count(schema->GetColumn(id)->GetName())){
-              fields_2.push_back(*map_[schema->GetColumn(id)->GetName()]);
-            }
-            else {
-              fields_2.push_back(*(iter->GetField(id)));
-            }
-          }
-          Row delete_row(fields_1);
-          Row insert_row(fields_2);
-          RowId tmp(iter->GetRowId());
-          idx->RemoveEntry(delete_row, tmp, NULL);
-          idx->InsertEntry(insert_row, tmp, NULL);
-      }
-    
-      std::vector<Field> fields_;
-  
-      for (uint32_t i=0; i<schema->GetColumnCount();i++){
-        //cout << schema->GetColumnCount() << endl;
-        if (map_.count(schema->GetColumn(i)->GetName())) {
-          fields_.push_back(*map_[schema->GetColumn(i)->GetName()]);
+  // collect the matching rows first, an update may move a row to the end of the heap where the
+  // scan would meet it again
+  std::vector<Row> rows;
+  pSyntaxNode condition = tmp2 == NULL ? NULL : tmp2->child_;
+  ScanTable(table_heap, schema, condition, scan_workers_, nullptr,
+            [&rows, context](Row &row) { rows.emplace_back(row, &context->heap_); }, &indexes);
+  for (auto &row : rows) {
+    RowId rid = row.GetRowId();
+    // old and new key of the indexes the row moved in, it moves back if a later index refuses its new key
+    std::vector<std::pair<Row, Row>> moved;
+    for (auto index : indexes) {
+      Index *idx = index->GetIndex();
+      std::vector<Field> fields_1;
+      std::vector<Field> fields_2;
+      IndexMetadata *meta = index->GetMetadata();
+      std::vector<uint32_t> key_map = meta->GetKeyMapping();
+      for (auto id : key_map) {
+        fields_1.push_back(*(row.GetField(id)));
+        if (map_.count(schema->GetColumn(id)->GetName())) {
+          fields_2.push_back(*map_[schema->GetColumn(id)->GetName()]);
+        } else {
+          fields_2.push_back(*(row.GetField(id)));
         }
-        else {
-          fields_.push_back(*((*iter).GetField(i)));
+      }
+      Row delete_row(fields_1, &context->heap_);
+      Row insert_row(fields_2, &context->heap_);
+      idx->RemoveEntry(delete_row, rid, NULL);
+      if (idx->InsertEntry(insert_row, rid, NULL) != DB_SUCCESS) {
+        idx->InsertEntry(delete_row, rid, NULL);
+        for (size_t i = 0; i < moved.size(); i++) {
+          indexes[i]->GetIndex()->RemoveEntry(moved[i].second, rid, NULL);
+          indexes[i]->GetIndex()->InsertEntry(moved[i].first, rid, NULL);
         }
+        break;
       }
-      Row row(fields_);
-
-      res*=table_heap->UpdateTuple(row, iter->GetRowId(), NULL);
-
-  }
-  
-  if (res){
-    cout << "[INFO] Update successfully!" << endl;
-    return DB_SUCCESS;
-  }
-    
-  else{
-    cout << "[INFO] Update failed" << endl;
-    return DB_FAILED;
-  }
-}
-  //condition
-      
-    for (auto iter = table_heap->Begin(NULL); iter!=table_heap->End(); ++iter){
-      bool flag=DFS(ast->child_->next_->next_->child_, iter, schema);
-      if (flag){
-        for (auto index : indexes){
-          Index* idx = index->GetIndex();
-          std::vector<Field> fields_1;
-          std::vector<Field> fields_2;
-          IndexMetadata * meta = index->GetMetadata();
-          std::vector<uint32_t> key_map = meta->GetKeyMapping();
-          for (auto id: key_map){
-            fields_1.push_back(*(iter->GetField(id)));
-            if(map_.count(schema->GetColumn(id)->GetName())){
-              fields_2.push_back(*map_[schema->GetColumn(id)->GetName()]);
-            }
-            else {
-              fields_2.push_back(*(iter->GetField(id)));
-            }
-          }
-          Row delete_row(fields_1);
-          Row insert_row(fields_2);
-          RowId tmp = iter->GetRowId();
-          idx->RemoveEntry(delete_row, tmp, NULL);
-          idx->InsertEntry(insert_row, tmp, NULL);
+      moved.emplace_back(delete_row, insert_row);
+    }
+    if (moved.size() < indexes.size()) {
+      res = false;
+      continue;
+    }
+    std::vector<Field> fields_;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      if (map_.count(schema->GetColumn(i)->GetName())) {
+        fields_.push_back(*map_[schema->GetColumn(i)->GetName()]);
+      } else {
+        fields_.push_back(*(row.GetField(i)));
       }
-        std::vector<Field> fields_;
-      
-      for (uint32_t i=0; i<schema->GetColumnCount();i++){
-        if (map_.count(schema->GetColumn(i)->GetName())){
-          
-          fields_.push_back(*map_[schema->GetColumn(i)->GetName()]);
-        }
-        else {
-          fields_.push_back(*(*iter).GetField(i));
+    }
+    Row new_row(fields_, &context->heap_);
+    if (table_heap->UpdateTuple(new_row, rid, NULL)) {
+      // a row that outgrew its page was moved, its entries follow it to the new rid
+      if (!(new_row.GetRowId() == rid)) {
+        for (size_t i = 0; i < moved.size(); i++) {
+          indexes[i]->GetIndex()->RemoveEntry(moved[i].second, rid, NULL);
+          indexes[i]->GetIndex()->InsertEntry(moved[i].second, new_row.GetRowId(), NULL);
         }
       }
-      Row row(fields_);
-      res *= table_heap->UpdateTuple(row, iter->GetRowId(), NULL);
+      table_info->GetTableStats()->OnDelete(row);
+      table_info->GetTableStats()->OnInsert(new_row);
+    } else {
+      for (size_t i = 0; i < moved.size(); i++) {
+        indexes[i]->GetIndex()->RemoveEntry(moved[i].second, rid, NULL);
+        indexes[i]->GetIndex()->InsertEntry(moved[i].first, rid, NULL);
+      }
+      res = false;
     }
   }
+  for (auto &item : map_) {
+    delete item.second;
+  }
   if (res) {
     cout << "[INFO] Update successfully!" << endl;
     return DB_SUCCESS;
@@ -1311,3 +1704,152 @@ dberr_t ExecuteEngine::ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *conte
 #endif
   return DB_FAILED;
 }
+
+dberr_t ExecuteEngine::ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSetVariable" << std::endl;
+#endif
+  ASSERT(ast->type_ == kNodeSetVariable, "Unexpected node type.");
+  string name = ast->child_->val_;
+  long value = strtol(ast->child_->next_->val_, nullptr, 10);
+  if (name == "workers") {
+    if (value < 1 || value > ParallelTableScan::MAX_WORKER_COUNT) {
+      cout << "[INFO] workers must be between 1 and " << ParallelTableScan::MAX_WORKER_COUNT << endl;
+      return DB_FAILED;
+    }
+    scan_workers_ = static_cast<uint32_t>(value);
+    cout << "[INFO] workers = " << scan_workers_ << endl;
+    return DB_SUCCESS;
+  }
+  if (name == "index_order") {
+    index_key_order_ = value != 0;
+    cout << "[INFO] index_order = " << index_key_order_ << endl;
+    return DB_SUCCESS;
+  }
+  cout << "[INFO] Unknown variable " << name << endl;
+  return DB_FAILED;
+}
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  if (dbs_.find(current_db_) == dbs_.end()) {
+    cout << "[INFO] No database selected" << endl;
+    return DB_FAILED;
+  }
+  CatalogManager *cata = dbs_[current_db_]->catalog_mgr_;
+  string table_name = ast->child_->val_;
+  dberr_t res = cata->AnalyzeTable(table_name);
+  if (res == DB_TABLE_NOT_EXIST) {
+    cout << "[INFO] Table " << table_name << " does not exist" << endl;
+  } else if (res != DB_SUCCESS) {
+    cout << "[INFO] Analyze failed" << endl;
+  } else {
+    cout << "[INFO] Analyze successfully!" << endl;
+  }
+  return res;
+}
+
+dberr_t ExecuteEngine::ExecuteShowStats(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowStats" << std::endl;
+#endif
+  if (dbs_.find(current_db_) == dbs_.end()) {
+    cout << "[INFO] No database selected" << endl;
+    return DB_FAILED;
+  }
+  CatalogManager *cata = dbs_[current_db_]->catalog_mgr_;
+  std::vector<TableInfo *> tables;
+  if (cata->GetTables(tables) == DB_FAILED) {
+    printf("[INFO] There aren't any tables!\n");
+    return DB_FAILED;
+  }
+  const int size_table = 21 * 6 + 1;
+  for (auto table_info : tables) {
+    TableStats *stats = table_info->GetTableStats();
+    Schema *schema = table_info->GetSchema();
+    // ratio of the in-memory to the on-disk size of the data pages
+    string storage;
+    TableHeap *table_heap = table_info->GetTableHeap();
+    if (table_heap->IsCompressed()) {
+      uint32_t compressed_pages;
+      uint64_t stored_size = table_heap->GetStoredSize(&compressed_pages);
+      std::ostringstream out;
+      out << ", compressed " << compressed_pages << "/" << table_heap->GetPageCount() << " pages, ratio "
+          << std::fixed << std::setprecision(2)
+          << static_cast<double>(table_heap->GetPageCount()) * PAGE_SIZE / stored_size;
+      storage = out.str();
+    }
+    cout << "[TABLE] " << table_info->GetTableName();
+    if (!stats->IsValid()) {
+      cout << ": not analyzed" << storage << endl;
+      continue;
+    }
+    cout << ": " << stats->GetRowCount() << " rows";
+    if (stats->IsAnalyzed()) {
+      cout << ", analyzed " << stats->GetSampledPages() << "/" << stats->GetTablePages() << " pages, "
+           << stats->GetModifiedCount() << " rows modified since";
+    } else {
+      cout << ", not analyzed";
+    }
+    cout << storage << endl;
+    cout << left << setfill('-') << setw(size_table) << '-' << endl;
+    for (auto title : {"column", "null_frac", "distinct", "min", "max", "encoding"}) {
+      cout << "|" << left << setfill(' ') << setw(20) << title;
+    }
+    cout << "|" << endl;
+    cout << left << setfill('-') << setw(size_table) << '-' << endl;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const ColumnStats &column = stats->GetColumnStats(i);
+      cout << "|" << left << setfill(' ') << setw(20) << schema->GetColumn(i)->GetName();
+      cout << "|" << left << setfill(' ') << setw(20) << stats->GetNullFraction(i);
+      cout << "|" << left << setfill(' ') << setw(20) << stats->GetDistinctCount(i);
+      cout << "|" << left << setfill(' ') << setw(20) << (column.min_ ? FieldToString(column.min_.get()) : "null");
+      cout << "|" << left << setfill(' ') << setw(20) << (column.max_ ? FieldToString(column.max_.get()) : "null");
+      // the advice is only shown where it differs from the current encoding
+      ColumnEncoding encoding = schema->GetColumnEncoding(i);
+      ColumnEncoding advice = stats->AdviseEncoding(i);
+      string encoding_name = encoding == kEncodingDictionary ? "dictionary" : "plain";
+      if (advice != encoding) {
+        encoding_name = advice == kEncodingDictionary ? "dictionary (advised)" : "plain (advised)";
+      }
+      cout << "|" << left << setfill(' ') << setw(20) << encoding_name;
+      cout << "|" << endl;
+    }
+    cout << left << setfill('-') << setw(size_table) << '-' << endl;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      const ColumnStats &column = stats->GetColumnStats(i);
+      if (column.histogram_.empty()) {
+        continue;
+      }
+      cout << "[HISTOGRAM] " << schema->GetColumn(i)->GetName() << ":";
+      for (auto &bound : column.histogram_) {
+        cout << " " << FieldToString(bound.get());
+      }
+      cout << endl;
+    }
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteTruncateTable" << std::endl;
+#endif
+  if (dbs_.find(current_db_) == dbs_.end()) {
+    cout << "[INFO] No database selected" << endl;
+    return DB_FAILED;
+  }
+  CatalogManager *cata = dbs_[current_db_]->catalog_mgr_;
+  string table_name = ast->child_->val_;
+  dberr_t res = cata->TruncateTable(table_name);
+  if (res == DB_TABLE_NOT_EXIST) {
+    cout << "[INFO] Table " << table_name << " does not exist" << endl;
+  } else if (res != DB_SUCCESS) {
+    cout << "[INFO] Truncate failed" << endl;
+  } else {
+    cout << "[INFO] Truncate successfully!" << endl;
+  }
+  return res;
+}
@@ -0,0 +1,114 @@
+#include "executor/parallel_scan.h"
+
+#include <algorithm>
+#include <thread>
+
+ParallelTableScan::ParallelTableScan(TableHeap *table_heap, uint32_t worker_count, uint32_t morsel_size)
+    : table_heap_(table_heap),
+      worker_count_(std::min(std::max(worker_count, 1u), MAX_WORKER_COUNT)),
+      morsel_size_(std::max(morsel_size, 1u)) {
+  // snapshot the directory, pages appended while scanning are not visited
+  pages_.reserve(table_heap_->GetPageCount());
+  for (uint32_t i = 0; i < table_heap_->GetPageCount(); i++) {
+    pages_.push_back(table_heap_->GetPageId(i));
+  }
+}
+
+uint64_t ParallelTableScan::Execute(const Predicate &predicate, const Consumer &consumer,
+                                    const std::vector<uint32_t> *fetch_columns) {
+  uint64_t count = 0;
+  cursor_ = 0;
+  skipped_pages_ = 0;
+  uint32_t morsel_count = (static_cast<uint32_t>(pages_.size()) + morsel_size_ - 1) / morsel_size_;
+  uint32_t worker_count = std::min(worker_count_, morsel_count);
+  if (worker_count <= 1) {
+    Batch batch;
+    for (uint32_t begin = 0; begin < pages_.size(); begin += morsel_size_) {
+      ScanMorsel(begin, predicate, fetch_columns, &batch);
+      for (auto &row : batch.rows_) {
+        consumer(row);
+      }
+      count += batch.rows_.size();
+      batch.rows_.clear();
+      batch.heap_->Reset();
+    }
+    return count;
+  }
+
+  running_workers_ = worker_count;
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (uint32_t i = 0; i < worker_count; i++) {
+    workers.emplace_back(&ParallelTableScan::RunWorker, this, std::cref(predicate), fetch_columns);
+  }
+  while (true) {
+    Batch batch;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      not_empty_.wait(lock, [this] { return !queue_.empty() || running_workers_ == 0; });
+      if (queue_.empty()) {
+        break;
+      }
+      batch = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+    for (auto &row : batch.rows_) {
+      consumer(row);
+    }
+    count += batch.rows_.size();
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return count;
+}
+
+void ParallelTableScan::ScanMorsel(uint32_t begin, const Predicate &predicate,
+                                   const std::vector<uint32_t> *fetch_columns, Batch *batch) {
+  uint32_t end = std::min(begin + morsel_size_, static_cast<uint32_t>(pages_.size()));
+  std::vector<Row> rows;
+  for (uint32_t i = begin; i < end; i++) {
+    if (page_filter_ && !page_filter_(i)) {
+      skipped_pages_++;
+      continue;
+    }
+    rows.clear();
+    table_heap_->GetPageTuples(pages_[i], nullptr, fetch_columns, batch->heap_.get(), &rows,
+                               code_filters_.empty() ? nullptr : &code_filters_);
+    // the rows the predicate rejects keep their arena space until the batch is released
+    for (auto &row : rows) {
+      if (!predicate || predicate(row)) {
+        batch->rows_.push_back(std::move(row));
+      }
+    }
+  }
+}
+
+void ParallelTableScan::RunWorker(const Predicate &predicate, const std::vector<uint32_t> *fetch_columns) {
+  while (true) {
+    uint32_t begin = cursor_.fetch_add(morsel_size_);
+    if (begin >= pages_.size()) {
+      break;
+    }
+    Batch batch;
+    ScanMorsel(begin, predicate, fetch_columns, &batch);
+    if (!batch.rows_.empty()) {
+      PushBatch(std::move(batch));
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    running_workers_--;
+  }
+  not_empty_.notify_one();
+}
+
+void ParallelTableScan::PushBatch(Batch &&batch) {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    not_full_.wait(lock, [this] { return queue_.size() < QUEUE_BATCHES_PER_WORKER * worker_count_; });
+    queue_.push_back(std::move(batch));
+  }
+  not_empty_.notify_one();
+}
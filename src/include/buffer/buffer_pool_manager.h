@@ -28,8 +28,24 @@ public:
 
   bool DeletePage(page_id_t page_id);
 
+  /**
+   * Delete many pages at once, freeing them on disk in one pass, see DiskManager::DeAllocatePages
+   * @return false if some page is still pinned, its frame is kept like DeletePage does
+   */
+  bool DeletePages(const std::vector<page_id_t> &page_ids);
+
   bool IsPageFree(page_id_t page_id);
 
+  /**
+   * Compress the page on disk from its next write on, see DiskManager::SetPageCompression
+   */
+  void SetPageCompression(page_id_t page_id, bool enable);
+
+  /**
+   * @return bytes the page takes on disk, as of its last write
+   */
+  uint32_t GetStoredSize(page_id_t page_id);
+
   bool CheckAllUnpinned();
 
 private:
@@ -51,7 +67,7 @@ private:
   std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
-  recursive_mutex latch_;                                   // to protect shared data structure
+  recursive_mutex latch_;                                   // to protect shared data structure from the scan threads
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
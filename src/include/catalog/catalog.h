@@ -71,15 +71,28 @@ public:
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * @param compressed store the pages of the table compressed on disk, see TableHeap::EnableCompression
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      bool compressed = false);
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * Create an empty index, filling it with the rows already in the table is up to the caller, see RebuildIndex
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn,
-                      IndexInfo *&index_info);
+                      IndexInfo *&index_info, IndexType index_type = kIndexBPlusTree);
+
+  /**
+   * Fill an empty index from the rows of its table in one bulk load, also used for the indexes that are
+   * not persisted, e.g. a BitmapIndex
+   */
+  dberr_t RebuildIndex(IndexInfo *index_info);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -89,9 +102,46 @@ public:
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Remove every row of a table. The pages of the table heap and of its indexes are freed in bulk and
+   * replaced by empty ones, the indexes themselves are kept.
+   */
+  dberr_t TruncateTable(const std::string &table_name);
+
+  /**
+   * Recompute the statistics of a table and persist them
+   */
+  dberr_t AnalyzeTable(const std::string &table_name);
+
+  /**
+   * Exact number of live rows of a table, kept in its metadata. A table stored before the count was
+   * kept is counted once by a full scan.
+   */
+  dberr_t GetRowCount(const std::string &table_name, uint64_t &row_count);
+
 private:
   dberr_t FlushCatalogMetaPage() const;
 
+  /**
+   * Write the table's statistics to a fresh chain of overflow pages and record its head in the
+   * table metadata page
+   */
+  dberr_t FlushTableStats(TableInfo *table_info);
+
+  /**
+   * Serialize the table metadata to its page again
+   */
+  void FlushTableMetadata(TableInfo *table_info);
+
+  /**
+   * @return first page of the chain, INVALID_PAGE_ID if the buffer pool ran out of pages
+   */
+  page_id_t WriteStatsPages(const char *data, uint32_t len);
+
+  void ReadStatsPages(page_id_t page_id, std::vector<char> &data);
+
+  void FreeStatsPages(page_id_t page_id);
+
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id);
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
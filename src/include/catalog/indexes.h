@@ -4,8 +4,8 @@
 #include <memory>
 
 #include "catalog/table.h"
-#include "index/generic_key.h"
-#include "index/b_plus_tree_index.h"
+#include "index/b_plus_tree_index_types.h"
+#include "index/bitmap_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
@@ -14,7 +14,7 @@ class IndexMetadata {
 public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name,
                                const table_id_t table_id, const std::vector<uint32_t> &key_map,
-                               MemHeap *heap);
+                               MemHeap *heap, IndexType index_type = kIndexBPlusTree);
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -32,23 +32,53 @@ public:
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline IndexType GetIndexType() const { return index_type_; }
+
+  /**
+   * @return false if the pages of a b+ tree index were written by an older format, always as GenericKey<64>
+   * and possibly in the row layout used before KeyCodec, such an index has to be rebuilt before use
+   */
+  inline bool HasCurrentKeyLayout() const { return current_key_layout_; }
+
+  inline void SetCurrentKeyLayout(bool current_key_layout) { current_key_layout_ = current_key_layout; }
+
+  /**
+   * @return true if the pages of a b+ tree index were written with the key types of CreateBPlusTreeIndex, but
+   * before non-unique indexes, when every index was opened as unique. The tree of an index that is not unique
+   * by its key schema has to be rebuilt with row ids in its keys, the one of a unique index is kept as is.
+   */
+  inline bool HasUniqueKeyLayout() const { return unique_key_layout_; }
+
 private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map) {
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map,
+                         IndexType index_type) {
                            index_id_ = index_id;
                            index_name_ = index_name;
                            table_id_ = table_id;
                            key_map_ = key_map;
+                           index_type_ = index_type;
                          }
 
 private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  /** followed by the index type */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V2 = 344529;
+  /** followed by the index type, b+ tree keys are encoded by KeyCodec */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V3 = 344530;
+  /** followed by the index type, b+ tree key types are chosen by CreateBPlusTreeIndex */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V4 = 344531;
+  /** followed by the index type, keys of non-unique b+ tree indexes end with the row id */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V5 = 344532;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_;  /** The mapping of index key to tuple key */
+  IndexType index_type_;
+  bool current_key_layout_{true};
+  bool unique_key_layout_{false};
 };
 
 /**
@@ -79,7 +109,22 @@ public:
     }
 
     key_schema_ = new Schema(cols);
-  
+
+    if (meta_data_->GetIndexType() == kIndexBPlusTree && !meta_data_->HasCurrentKeyLayout()) {
+      if (!meta_data_->HasUniqueKeyLayout()) {
+        // older trees always hold GenericKey<64>, they are freed as such and rebuilt by the catalog
+        BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> legacy_index(meta_data_->GetIndexId(),
+                                                                                  key_schema_, buffer_pool_manager);
+        legacy_index.Destroy();
+      } else if (!IsUniqueKeySchema(key_schema_)) {
+        // the tree was opened as unique, which dropped the rows of repeated keys
+        std::unique_ptr<Index> legacy_index(
+                CreateBPlusTreeIndex(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager, true));
+        legacy_index->Destroy();
+      } else {
+        meta_data_->SetCurrentKeyLayout(true);
+      }
+    }
     index_ = CreateIndex(buffer_pool_manager);
   }
 
@@ -102,7 +147,11 @@ private:
 
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
     //ASSERT(false, "Not Implemented yet.");
-      return new BPlusTreeIndex<GenericKey<64>,RowId,GenericComparator<64>>(meta_data_->GetIndexId(),key_schema_,buffer_pool_manager);
+      if (meta_data_->GetIndexType() == kIndexBitmap) {
+        return new BitmapIndex(meta_data_->GetIndexId(), key_schema_);
+      }
+      return CreateBPlusTreeIndex(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager,
+                                  IsUniqueKeySchema(key_schema_));
   }
 
 private:
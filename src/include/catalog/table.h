@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "catalog/table_stats.h"
 #include "glog/logging.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
@@ -24,10 +25,74 @@ public:
 
   inline std::string GetTableName() const { return table_name_; }
 
+  /**
+   * @return root page of the table heap, i.e. the first page of its directory
+   */
   inline uint32_t GetFirstPageId() const { return root_page_id_; }
 
+  inline void SetFirstPageId(page_id_t root_page_id) { root_page_id_ = root_page_id; }
+
   inline Schema *GetSchema() const { return schema_; }
 
+  /**
+   * @return first page of the serialized TableStats, INVALID_PAGE_ID if they were never written
+   */
+  inline page_id_t GetStatsPageId() const { return stats_page_id_; }
+
+  inline void SetStatsPageId(page_id_t stats_page_id) { stats_page_id_ = stats_page_id; }
+
+  /**
+   * @return first page of the dictionaries of the table heap, INVALID_PAGE_ID if no column is dictionary encoded
+   */
+  inline page_id_t GetDictionaryPageId() const { return dictionary_page_id_; }
+
+  inline void SetDictionaryPageId(page_id_t dictionary_page_id) { dictionary_page_id_ = dictionary_page_id; }
+
+  /**
+   * @return true if the pages of the table heap are stored compressed
+   */
+  inline bool IsCompressed() const { return compressed_; }
+
+  inline void SetCompressed(bool compressed) { compressed_ = compressed; }
+
+  static constexpr uint64_t INVALID_ROW_COUNT = UINT64_MAX;
+
+  /**
+   * @return false if the live rows were never counted, i.e. the table was stored before the count was kept
+   */
+  inline bool HasRowCount() const { return row_count_ != INVALID_ROW_COUNT; }
+
+  /**
+   * @return exact number of live rows, see HasRowCount
+   */
+  inline uint64_t GetRowCount() const { return row_count_; }
+
+  inline void SetRowCount(uint64_t row_count) {
+    row_count_ = row_count;
+    dirty_ = true;
+  }
+
+  /**
+   * Count a row inserted into or deleted from the table heap, nothing happens while there is no count
+   */
+  inline void OnInsert() {
+    if (HasRowCount()) {
+      SetRowCount(row_count_ + 1);
+    }
+  }
+
+  inline void OnDelete() {
+    if (HasRowCount() && row_count_ > 0) {
+      SetRowCount(row_count_ - 1);
+    }
+  }
+
+  /**
+   * @return true if the metadata changed since it was last serialized to its page
+   */
+  inline bool IsDirty() const { return dirty_; }
+
+  inline void SetDirty(bool dirty) { dirty_ = dirty; }
 
 private:
   TableMetadata() = delete;
@@ -36,10 +101,26 @@ private:
 
 private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  /** followed by the row format of the table */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V2 = 344529;
+  /** followed by the row format and the first page of the table statistics */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V3 = 344530;
+  /** followed by the v3 fields, the first dictionary page and the indexes of the dictionary columns */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V4 = 344531;
+  /** followed by the v4 fields and the table options, see TableOption */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V5 = 344532;
+  enum TableOption : uint32_t { kTableOptionCompressed = 1 };
+  /** followed by the v5 fields and the live row count */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM_V6 = 344533;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  page_id_t stats_page_id_{INVALID_PAGE_ID};
+  page_id_t dictionary_page_id_{INVALID_PAGE_ID};
+  bool compressed_{false};
+  uint64_t row_count_{INVALID_ROW_COUNT};
+  bool dirty_{false};
 };
 
 /**
@@ -57,13 +138,18 @@ public:
     delete heap_;
   }
 
-  void Init(TableMetadata *table_meta, TableHeap *table_heap) {
+  void Init(TableMetadata *table_meta, TableHeap *table_heap, TableStats *table_stats) {
     table_meta_ = table_meta;
     table_heap_ = table_heap;
+    table_stats_ = table_stats;
   }
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
 
+  inline TableStats *GetTableStats() const { return table_stats_; }
+
+  inline TableMetadata *GetTableMetadata() const { return table_meta_; }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline table_id_t GetTableId() const { return table_meta_->table_id_; }
@@ -80,6 +166,7 @@ private:
 private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStats *table_stats_;
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
 };
 
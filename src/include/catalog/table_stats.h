@@ -0,0 +1,142 @@
+#ifndef MINISQL_TABLE_STATS_H
+#define MINISQL_TABLE_STATS_H
+
+#include <memory>
+#include <vector>
+
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * HyperLogLog sketch of the distinct values of one column, 2^HLL_PRECISION one-byte registers
+ */
+class HyperLogLog {
+public:
+  void Add(uint64_t hash);
+
+  uint64_t Estimate() const;
+
+  void Clear();
+
+  static uint64_t Hash(const Field &field);
+
+  static constexpr uint32_t HLL_PRECISION = 8;
+  static constexpr uint32_t REGISTER_COUNT = 1u << HLL_PRECISION;
+
+  uint8_t registers_[REGISTER_COUNT]{};
+};
+
+/**
+ * Statistics of one column. min_, max_ and the histogram bounds are copies of sampled values,
+ * char values are cut to STATS_MAX_VALUE_LEN bytes.
+ */
+struct ColumnStats {
+  uint64_t null_count_{0};
+  /** distinct values found by the last ANALYZE, extrapolated to the whole table */
+  uint64_t distinct_count_{0};
+  HyperLogLog sketch_;
+  std::unique_ptr<Field> min_;
+  std::unique_ptr<Field> max_;
+  /** upper bounds of equi-depth buckets, each holds about row_count / bucket count rows */
+  std::vector<std::unique_ptr<Field>> histogram_;
+};
+
+/**
+ * Per table statistics, computed by ANALYZE from a sample of heap pages and kept current by cheap
+ * counters on every insert and delete.
+ *
+ * Counters follow inserts and deletes exactly. min/max and the sketch only grow on insert, the
+ * histogram is left as it is until the next ANALYZE.
+ */
+class TableStats {
+public:
+  explicit TableStats(Schema *schema);
+
+  /**
+   * Recompute every statistic. Reads all pages of a small table, otherwise STATS_SAMPLE_PAGES pages
+   * chosen at random, and extrapolates the counts to the whole table.
+   */
+  void Analyze(TableHeap *table_heap);
+
+  void OnInsert(const Row &row);
+
+  void OnDelete(const Row &row);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  static uint32_t DeserializeFrom(char *buf, Schema *schema, TableStats *&table_stats, MemHeap *heap);
+
+  static TableStats *Create(Schema *schema, MemHeap *heap) { return ALLOC_P(heap, TableStats)(schema); }
+
+  /**
+   * @return false if counts do not cover the whole table, i.e. it was loaded without statistics and
+   * has not been analyzed since
+   */
+  inline bool IsValid() const { return valid_; }
+
+  inline bool IsAnalyzed() const { return analyzed_; }
+
+  inline bool IsDirty() const { return dirty_; }
+
+  inline void SetDirty(bool dirty) { dirty_ = dirty; }
+
+  inline void SetValid(bool valid) { valid_ = valid; }
+
+  inline uint64_t GetRowCount() const { return row_count_; }
+
+  /**
+   * @return rows inserted or deleted since the last ANALYZE
+   */
+  inline uint64_t GetModifiedCount() const { return modified_count_; }
+
+  inline uint32_t GetSampledPages() const { return sampled_pages_; }
+
+  inline uint32_t GetTablePages() const { return table_pages_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline const ColumnStats &GetColumnStats(uint32_t column_index) const { return columns_[column_index]; }
+
+  double GetNullFraction(uint32_t column_index) const;
+
+  /**
+   * @return distinct non-null values, the larger of the ANALYZE estimate and the sketch
+   */
+  uint64_t GetDistinctCount(uint32_t column_index) const;
+
+  /**
+   * Suggest an encoding for a column of a PAX table. A char column is worth a dictionary when it has
+   * few distinct values compared to its rows and the 2 byte codes plus the dictionary take less space
+   * than the plain values.
+   * @return kEncodingPlain if the statistics are not valid or the table is empty
+   */
+  ColumnEncoding AdviseEncoding(uint32_t column_index) const;
+
+private:
+  /**
+   * Widen min/max by a non-null field
+   */
+  static void Widen(ColumnStats &column, const Field &field);
+
+  static std::unique_ptr<Field> CopyValue(const Field &field);
+
+private:
+  static constexpr uint32_t TABLE_STATS_MAGIC_NUM = 525137;
+  /** a dictionary only pays off if a value repeats at least this often on average */
+  static constexpr uint64_t DICTIONARY_MIN_REPEATS = 4;
+  Schema *schema_;
+  bool valid_{true};
+  bool analyzed_{false};
+  bool dirty_{false};
+  uint64_t row_count_{0};
+  uint64_t modified_count_{0};
+  /** pages read by the last ANALYZE out of the pages the table had then */
+  uint32_t sampled_pages_{0};
+  uint32_t table_pages_{0};
+  std::vector<ColumnStats> columns_;
+};
+
+#endif  // MINISQL_TABLE_STATS_H
@@ -18,6 +18,11 @@ static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer p
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
+static constexpr uint32_t TOAST_THRESHOLD = PAGE_SIZE / 8;    // longer char values are moved to overflow pages
+static constexpr uint32_t TOAST_PREFIX_LEN = 32;              // leading bytes of a moved value kept in the tuple
+static constexpr uint32_t STATS_SAMPLE_PAGES = 64;            // heap pages read by ANALYZE of a large table
+static constexpr uint32_t STATS_HISTOGRAM_BUCKETS = 16;       // buckets of an equi-depth histogram
+static constexpr uint32_t STATS_MAX_VALUE_LEN = 32;           // bytes of a char value kept as min/max/bound
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
@@ -10,6 +10,7 @@ enum dberr_t {
   DB_INDEX_NOT_FOUND,
   DB_COLUMN_NAME_NOT_EXIST,
   DB_KEY_NOT_FOUND,
+  DB_KEY_TOO_LARGE,
 };
 
 #endif //MINISQL_DBERR_H
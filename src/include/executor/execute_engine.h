@@ -6,6 +6,7 @@
 #include "common/dberr.h"
 #include "common/instance.h"
 #include "transaction/transaction.h"
+#include "utils/mem_heap.h"
 
 extern "C" {
 #include "parser/parser.h"
@@ -20,6 +21,7 @@ extern "C" {
 struct ExecuteContext {
   bool flag_quit_{false};
   Transaction *txn_{nullptr};
+  ArenaMemHeap heap_;  /** rows and keys built while running one statement, released when it ends */
 };
 
 /**
@@ -63,6 +65,13 @@ private:
 
   dberr_t ExecuteSelect(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * SELECT count(*), count(col), min(col), max(col) FROM ...
+   * Without a condition count(*) is read from the table metadata and min/max from the ends of a
+   * B+ tree index on the column, anything else takes one table scan.
+   */
+  dberr_t ExecuteAggregate(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteInsert(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDelete(pSyntaxNode ast, ExecuteContext *context);
@@ -79,9 +88,25 @@ private:
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * SET <variable> = <number>, session settings of this engine
+   */
+  dberr_t ExecuteSetVariable(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteShowStats(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * TRUNCATE TABLE <table>, empties the table and its indexes without visiting the rows
+   */
+  dberr_t ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context);
+
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database */
+  uint32_t scan_workers_{1};  /** worker threads of a full table scan, SET workers = N */
+  bool index_key_order_{false};  /** index scans fetch rows in key order instead of by page, SET index_order = 1 */
   //[[maybe_unused]] std::unordered_map<std::string, std::string> index_;
 };
 
@@ -0,0 +1,106 @@
+#ifndef MINISQL_PARALLEL_SCAN_H
+#define MINISQL_PARALLEL_SCAN_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "storage/table_heap.h"
+
+/**
+ * Morsel-driven parallel full scan of a table heap.
+ *
+ * The heap's pages are split into morsels of morsel_size consecutive directory entries. Each worker
+ * thread claims the next morsel from a shared cursor, reads its tuples, evaluates the predicate on
+ * its own and pushes the qualifying rows in batches into a bounded merge queue. The calling thread
+ * drains the queue and hands every row to the consumer, so consumers need not be thread-safe.
+ * Rows arrive in heap order within a page but pages interleave across workers. With a single
+ * worker the scan runs on the calling thread and rows come in heap order.
+ */
+class ParallelTableScan {
+public:
+  /** called on worker threads, must only read the row */
+  using Predicate = std::function<bool(const Row &)>;
+  /** called on the calling thread, the row is released when it returns */
+  using Consumer = std::function<void(Row &)>;
+  /** called on worker threads with a directory index, false skips the page without reading it */
+  using PageFilter = std::function<bool(uint32_t)>;
+
+  explicit ParallelTableScan(TableHeap *table_heap, uint32_t worker_count,
+                             uint32_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /**
+   * Run the scan to completion. The set of pages is fixed when the scan starts.
+   * @param predicate filter evaluated by the workers, an empty predicate accepts every row
+   * @param consumer receives every qualifying row
+   * @param fetch_columns columns read by predicate and consumer, nullptr for all (see TableHeap::GetTuple)
+   * @return number of rows passed to consumer
+   */
+  uint64_t Execute(const Predicate &predicate, const Consumer &consumer,
+                   const std::vector<uint32_t> *fetch_columns = nullptr);
+
+  /**
+   * Skip the pages the filter rejects, e.g. by the table's zone map
+   */
+  inline void SetPageFilter(PageFilter page_filter) { page_filter_ = std::move(page_filter); }
+
+  /**
+   * Skip the rows of PAX pages whose dictionary codes fail the filters, before they are decoded
+   */
+  inline void SetCodeFilters(std::vector<CodeFilter> code_filters) { code_filters_ = std::move(code_filters); }
+
+  /**
+   * @return pages the last Execute skipped through the page filter
+   */
+  inline uint32_t GetSkippedPages() const { return skipped_pages_; }
+
+  static constexpr uint32_t DEFAULT_MORSEL_SIZE = 32;
+  static constexpr uint32_t MAX_WORKER_COUNT = 64;
+
+private:
+  /**
+   * Rows of a morsel, allocated from the arena that comes with them
+   */
+  struct Batch {
+    std::unique_ptr<ArenaMemHeap> heap_{new ArenaMemHeap()};
+    std::vector<Row> rows_;
+  };
+
+  /**
+   * Scan the pages of one morsel, appending qualifying rows to batch
+   */
+  void ScanMorsel(uint32_t begin, const Predicate &predicate, const std::vector<uint32_t> *fetch_columns,
+                  Batch *batch);
+
+  void RunWorker(const Predicate &predicate, const std::vector<uint32_t> *fetch_columns);
+
+  /**
+   * Blocks while the merge queue is full
+   */
+  void PushBatch(Batch &&batch);
+
+private:
+  static constexpr uint32_t QUEUE_BATCHES_PER_WORKER = 4;
+
+  TableHeap *table_heap_;
+  uint32_t worker_count_;
+  uint32_t morsel_size_;
+  std::vector<page_id_t> pages_;
+  PageFilter page_filter_;
+  std::vector<CodeFilter> code_filters_;
+  std::atomic<uint32_t> cursor_{0};
+  std::atomic<uint32_t> skipped_pages_{0};
+  /** merge queue */
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Batch> queue_;
+  uint32_t running_workers_{0};
+};
+
+#endif  // MINISQL_PARALLEL_SCAN_H
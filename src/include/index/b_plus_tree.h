@@ -1,10 +1,13 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <atomic>
+#include <functional>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
@@ -18,10 +21,14 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, a non-unique index makes them so with the row id, see BPlusTreeIndex
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Lookups, inserts and removes may run on many threads. They descend with latch coupling, i.e. a
+ *     child is latched before its parent is released, and an insert or remove write-latches the leaf
+ *     only. One that would split or merge pages starts over with the whole tree to itself, see root_latch_.
+ *     Iterators are not latched.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -41,22 +48,70 @@ public:
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  /**
+   * Build an empty tree bottom up: leaves are written left to right, and every internal page as soon as
+   * its last child is complete, so the pages are written once and in order. Entries are spread evenly over
+   * the pages of each level, fill_factor of a page on average, to leave room for later inserts.
+   * @param next yields the entries in ascending key order without duplicates, false once there are no more
+   * @param count number of entries next yields at most, the pages on the right edge are left short if fewer come
+   * @return false if the tree is not empty
+   */
+  bool BulkLoad(const std::function<bool(MappingType *)> &next, uint64_t count,
+                double fill_factor = BULK_LOAD_FILL_FACTOR);
+
+  static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
+  /**
+   * Values of many keys at once, e.g. the list of an IN or the probes of an index nested loop join. The probes
+   * are sorted and walked down the tree a level at a time, so a page on the paths of several probes is fetched
+   * and searched under one read latch per batch, not once per probe. The pages of a level are fetched
+   * PROBE_PREFETCH_DISTANCE ahead and their memory prefetched while the ones before them are searched.
+   * @param keys probe keys in any order, repeats allowed
+   * @param[out] values values[i] is the value of keys[i] if found[i]
+   * @return number of keys found
+   */
+  size_t GetValues(const std::vector<KeyType> &keys, std::vector<ValueType> &values, std::vector<bool> &found);
+
+  static constexpr size_t PROBE_PREFETCH_DISTANCE = 4;
+
+  /**
+   * Values of the keys between lo and hi in key order, handed to consume a leaf at a time. The bounds are
+   * found by searching the leaves, keys are not compared one by one. A batch is copied under the read latch
+   * of its leaf and consume runs with no latch held, so it may change the tree, e.g. remove what it got:
+   * the next batch then starts over from the root past the last key handed out.
+   * @param lo smallest key, nullptr for a range open below
+   * @param hi largest key, nullptr for a range open above
+   * @param limit number of values at most, 0 for no limit
+   * @param consume returns false to end the scan
+   */
+  void ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive, uint64_t limit,
+                 const std::function<bool(const std::vector<ValueType> &)> &consume);
+
+  /**
+   * Smallest and largest key, read from the leftmost and the rightmost leaf
+   * @param from smallest key not less than *from if given, searched from the root
+   * @return false if there is no such key
+   */
+  bool GetMinKey(KeyType &key, const KeyType *from = nullptr);
+
+  bool GetMaxKey(KeyType &key);
+
   INDEXITERATOR_TYPE Begin();
 
   INDEXITERATOR_TYPE Begin(const KeyType &key);
 
   INDEXITERATOR_TYPE End();
 
-  // expose for test purpose
+  // expose for test purpose, the leaf is returned pinned but not latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
   // used to check whether all pages are unpinned
   bool Check();
 
-  // destroy the b plus tree
+  // destroy the b plus tree, freeing all of its pages in one pass
   void Destroy();
 
   void PrintTree(std::ofstream &out) {
@@ -71,8 +126,66 @@ public:
   }
 
 private:
+  enum class LeafEdge { kNone, kLeftmost, kRightmost };
+
+  enum class LeafLatch { kNone, kRead, kWrite };
+
+  /**
+   * Descend to the leaf of key, or along the first or the last child of every internal page to an edge.
+   * Internal pages are read-latched with coupling and the leaf is latched as asked, kNone latches nothing
+   * for the callers that hold root_latch_ exclusive. The caller holds root_latch_ either way.
+   * @return the leaf, pinned and latched, nullptr if the tree is empty
+   */
+  Page *DescendToLeaf(const KeyType &key, LeafEdge edge, LeafLatch latch);
+
+  /**
+   * @return the leftmost or rightmost leaf, pinned but not latched, nullptr if the tree is empty
+   */
+  Page *FindEdgeLeafPage(bool rightmost);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  bool BulkLoadEmpty(const std::function<bool(MappingType *)> &next, uint64_t count, double fill_factor);
+
+  /**
+   * The open, i.e. rightmost and incomplete, internal page of a level during BulkLoad
+   */
+  struct BulkLevel {
+    InternalPage *page_{nullptr};
+    uint64_t entry_nums_;
+    uint64_t node_nums_;
+    uint64_t next_node_{0};
+    int target_size_{0};
+  };
+
+  /**
+   * Add a complete page of the level below to the open page of levels[level], which is then completed
+   * and added to the level above once it holds its share of entries
+   */
+  void BulkAppendChild(std::vector<BulkLevel> &levels, size_t level, const KeyType &key, BPlusTreePage *child);
+
+  /**
+   * Append a key above every other one to the rightmost leaf without descending from the root, with the
+   * leaf write-latched and root_latch_ held shared
+   * @param[out] inserted true if the key was appended
+   * @return false if there is no hint, the key is not the largest or the leaf is full
+   */
+  bool AppendToRightmostLeaf(const KeyType &key, const ValueType &value, bool *inserted);
+
+  /**
+   * Insert into a leaf that is not full, with the leaf write-latched and root_latch_ held shared
+   * @param[out] inserted false if the key is already there
+   * @return false if the leaf is full and the insert has to split it
+   */
+  bool OptimisticInsert(const KeyType &key, const ValueType &value, bool *inserted);
+
+  /**
+   * Remove from a leaf that stays at least half full and keeps its first key, with the leaf write-latched
+   * and root_latch_ held shared
+   * @return false if the remove has to touch the parent or merge the leaf
+   */
+  bool OptimisticRemove(const KeyType &key);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
@@ -102,7 +215,18 @@ private:
 
   // member variable
   index_id_t index_id_;
+  /**
+   * Latch of the tree as a whole, which also guards root_page_id_. Lookups and the inserts and removes that
+   * stay within one leaf take it shared, splits and merges take it exclusive as they follow parent pointers
+   * to pages the descent did not latch.
+   */
+  ReaderWriterLatch root_latch_;
   page_id_t root_page_id_;
+  /**
+   * Hint of the rightmost leaf for increasing keys, INVALID_PAGE_ID if it is not known. Only splits and
+   * merges move the right edge, under root_latch_ exclusive, the other writers just record where they found it.
+   */
+  std::atomic<page_id_t> rightmost_leaf_id_{INVALID_PAGE_ID};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
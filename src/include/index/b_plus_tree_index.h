@@ -1,31 +1,104 @@
 #ifndef MINISQL_B_PLUS_TREE_INDEX_H
 #define MINISQL_B_PLUS_TREE_INDEX_H
 
+#include <type_traits>
+
 #include "index/b_plus_tree.h"
+#include "index/generic_key.h"
 #include "index/index.h"
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * Key types in the encoding of KeyCodec, which keeps nulls, whereas native keys are of non-null columns
+ */
+template<typename KeyType>
+struct IsCodecKey : std::false_type {};
+
+template<size_t KeySize>
+struct IsCodecKey<GenericKey<KeySize>> : std::true_type {};
+
+/**
+ * Key types that can hold a row id after the key, as the keys of a non-unique index do. Keys no wider than
+ * the row id itself cannot, CreateBPlusTreeIndex never picks them for a non-unique index.
+ */
+template<typename KeyType>
+struct HoldsRowId : std::false_type {};
+
+template<size_t KeySize>
+struct HoldsRowId<GenericKey<KeySize>> : std::bool_constant<(KeySize > GenericKey<KeySize>::ROW_ID_SIZE)> {};
+
+/**
+ * Index over a b+ tree, whose keys are unique. A unique index refuses a second row of a key, a non-unique
+ * one ends every key with the row id, see GenericKey, so the rows of a key are adjacent entries in row id
+ * order and ScanKey returns all of them.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
 public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+  using IndexKey = KeyType;
+
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true);
 
+  /**
+   * @return DB_KEY_TOO_LARGE if the key does not fit, see KeyFits, DB_FAILED if the key is in a unique index
+   */
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  /**
+   * @param[out] result rows of key, in row id order for a non-unique index
+   */
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
 
   dberr_t Destroy() override;
 
+  /**
+   * Sort the entries by key, spilling to disk past the sort memory limit, and build the tree bottom up
+   * @return DB_FAILED if the index is not empty, DB_KEY_TOO_LARGE if a key does not fit and nothing is loaded
+   */
+  dberr_t BulkLoad(const IndexEntrySource &source, Transaction *txn) override;
+
+  /**
+   * Rows in batches of a leaf, see BPlusTree::ScanRange
+   * @return DB_FAILED if a bound does not fit the key type
+   */
+  dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, uint64_t limit,
+                    const RowIdBatchConsumer &consume, Transaction *txn) override;
+
+  /**
+   * Smallest key whose first field is not null, nulls sort before every value so the search starts past them
+   */
+  dberr_t GetMinKey(Row &key) override;
+
+  dberr_t GetMaxKey(Row &key) override;
+
+  bool IsUnique() const override { return unique_; }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  /**
+   * @return false if key, followed by the row id in a non-unique index, is wider than KeyType. Only the
+   * GenericKey<64> of a wide schema may be too small, for a long char value.
+   */
+  bool KeyFits(const Row &key) const;
+
 protected:
+  /**
+   * Serialize key the way the tree holds it, followed by row_id in a non-unique index
+   * @return size of the encoded key without the row id, 0 in a unique index
+   */
+  uint32_t SerializeKey(const Row &key, RowId row_id, KeyType *index_key) const;
+
+  bool unique_;
+  // every key of the schema fits, KeyFits need not measure the key
+  bool keys_fit_{true};
   // comparator for key
   KeyComparator comparator_;
   // container
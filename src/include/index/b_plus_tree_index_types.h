@@ -0,0 +1,55 @@
+#ifndef MINISQL_B_PLUS_TREE_INDEX_TYPES_H
+#define MINISQL_B_PLUS_TREE_INDEX_TYPES_H
+
+#include "index/b_plus_tree_index.h"
+#include "index/generic_key.h"
+#include "index/native_key.h"
+
+/**
+ * Instantiations of BPlusTreeIndex used for table indexes. The key type follows from the key schema alone,
+ * so an index is opened with the type it was created with:
+ *  - a unique single non-null int or float column: NativeKey, compared as a number
+ *  - any other unique schema: the smallest GenericKey<N> holding KeyCodec::GetMaxEncodedSize bytes, or GenericKey<64>
+ *  - a non-unique schema: the same with GenericKey::ROW_ID_SIZE more bytes for the row id
+ * Keys that exceed GenericKey<64> are refused, see BPlusTreeIndex::KeyFits.
+ * Smaller keys put more entries in a page, hence shallower trees.
+ * @param unique see IsUniqueKeySchema, a different value opens the tree of the index with another key type
+ */
+Index *CreateBPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                            bool unique = true);
+
+/**
+ * @return true if a key stands for one row at most, i.e. it has a unique or primary key column
+ */
+bool IsUniqueKeySchema(IndexSchema *key_schema);
+
+namespace detail {
+
+template<typename KeyType, typename KeyComparator, typename Visitor>
+inline bool VisitBPlusTreeIndexAs(Index *index, Visitor &visitor) {
+  auto *tree_index = dynamic_cast<BPlusTreeIndex<KeyType, RowId, KeyComparator> *>(index);
+  if (tree_index != nullptr) {
+    visitor(tree_index);
+  }
+  return tree_index != nullptr;
+}
+
+}  // namespace detail
+
+/**
+ * Call visitor with index cast to its BPlusTreeIndex instantiation, visitor is a generic lambda and finds
+ * the key type as IndexKey of its argument
+ * @return false if index is not a b+ tree index
+ */
+template<typename Visitor>
+bool VisitBPlusTreeIndex(Index *index, Visitor &&visitor) {
+  return detail::VisitBPlusTreeIndexAs<NativeKey<int32_t>, NativeComparator<int32_t>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<NativeKey<float>, NativeComparator<float>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<GenericKey<4>, GenericComparator<4>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<GenericKey<8>, GenericComparator<8>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<GenericKey<16>, GenericComparator<16>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<GenericKey<32>, GenericComparator<32>>(index, visitor) ||
+         detail::VisitBPlusTreeIndexAs<GenericKey<64>, GenericComparator<64>>(index, visitor);
+}
+
+#endif  // MINISQL_B_PLUS_TREE_INDEX_TYPES_H
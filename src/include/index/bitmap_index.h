@@ -0,0 +1,62 @@
+#ifndef MINISQL_BITMAP_INDEX_H
+#define MINISQL_BITMAP_INDEX_H
+
+#include <string>
+#include <unordered_map>
+
+#include "index/index.h"
+#include "index/roaring_bitmap.h"
+
+/**
+ * Index for columns with few distinct values. Keys need not be unique: every distinct key, null
+ * included, has a RoaringBitmap of the rows holding it. Queries on several indexed columns combine
+ * the bitmaps with And/Or/Not before any row is fetched, see GetBitmap and GetAllRows.
+ *
+ * The bitmaps are kept in memory only, the catalog rebuilds them from the table when it opens an
+ * existing database.
+ */
+class BitmapIndex : public Index {
+public:
+  BitmapIndex(index_id_t index_id, IndexSchema *key_schema);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  /**
+   * @return DB_KEY_NOT_FOUND if row_id is not indexed under key
+   */
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  /**
+   * Append every row holding key, in row id order
+   */
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
+
+  dberr_t Destroy() override;
+
+  /**
+   * @return rows holding key, nullptr if there are none
+   */
+  const RoaringBitmap *GetBitmap(const Row &key) const;
+
+  /**
+   * @return every indexed row, the universe to complement bitmaps in
+   */
+  inline const RoaringBitmap &GetAllRows() const { return all_rows_; }
+
+  /**
+   * @return number of distinct keys, null counts as one
+   */
+  inline uint32_t GetKeyCount() const { return static_cast<uint32_t>(bitmaps_.size()); }
+
+private:
+  /**
+   * Bytes identifying the key: per field a null flag, then the serialized value
+   */
+  std::string EncodeKey(const Row &key) const;
+
+private:
+  std::unordered_map<std::string, RoaringBitmap> bitmaps_;
+  RoaringBitmap all_rows_;
+};
+
+#endif  // MINISQL_BITMAP_INDEX_H
@@ -3,25 +3,47 @@
 
 #include <cstring>
 
+#include "index/key_codec.h"
 #include "record/row.h"
 #include "record/field.h"
 
+/**
+ * Index key of at most KeySize bytes, stored in the order-preserving encoding of KeyCodec
+ */
 template<size_t KeySize>
 class GenericKey {
 public:
   inline void SerializeFromKey(const Row &key, Schema *schema) {
-    // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= KeySize, "Index key size exceed max key size.");
+    ASSERT(KeyCodec::GetEncodedSize(key, schema) <= KeySize, "Index key size exceed max key size.");
+    // the unused tail is zeroed so that whole keys compare as bytes
+    memset(data, 0, KeySize);
+    KeyCodec::Encode(key, schema, data);
+  }
+
+  /**
+   * Encode key followed by row_id, 8 bytes big-endian, the layout of non-unique index keys: rows of equal
+   * keys stay apart and sort by row id, while a key serialized without a row id sorts before all of them
+   * @return size of the encoded key, without the row id
+   */
+  inline uint32_t SerializeFromKey(const Row &key, RowId row_id, Schema *schema) {
+    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
+    uint32_t size = KeyCodec::GetEncodedSize(key, schema);
+    ASSERT(size + ROW_ID_SIZE <= KeySize, "Index key size exceed max key size.");
     memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    KeyCodec::Encode(key, schema, data);
+    auto rid = static_cast<uint64_t>(row_id.Get());
+    for (uint32_t i = 0; i < ROW_ID_SIZE; i++) {
+      data[size + i] = static_cast<char>(rid >> (8 * (ROW_ID_SIZE - 1 - i)));
+    }
+    return size;
   }
 
+  static constexpr uint32_t ROW_ID_SIZE = sizeof(int64_t);
+
   inline void DeserializeToKey(Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(data), schema);
+    uint32_t ofs = KeyCodec::Decode(data, schema, &key);
     ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
-    return;
   }
 
   // compare
@@ -47,31 +69,16 @@ public:
 };
 
 /**
- * Function object returns true if lhs < rhs, used for trees
+ * Function object comparing two keys, negative if lhs < rhs, used for trees. Keys are compared as bytes,
+ * see KeyCodec, the schema is only needed to encode them.
  */
 template<size_t KeySize>
 class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    int cmp = memcmp(lhs.data, rhs.data, KeySize);
+    return cmp == 0 ? 0 : (cmp < 0 ? -1 : 1);
   }
 
   GenericComparator(const GenericComparator &other) {
@@ -82,7 +89,7 @@ public:
   GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
 private:
-  Schema *key_schema_;
+  [[maybe_unused]] Schema *key_schema_;
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
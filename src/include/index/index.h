@@ -1,6 +1,7 @@
 #ifndef MINISQL_INDEX_H
 #define MINISQL_INDEX_H
 
+#include <functional>
 #include <memory>
 
 #include "common/dberr.h"
@@ -8,6 +9,30 @@
 #include "transaction/transaction.h"
 #include "page/b_plus_tree_leaf_page.h"
 
+/**
+ * Structure behind an Index, chosen by CREATE INDEX ... USING
+ */
+enum IndexType : uint32_t {
+  kIndexBPlusTree = 0,
+  /** non-unique keys, see BitmapIndex */
+  kIndexBitmap
+};
+
+/**
+ * Receives the entries of a bulk load one at a time
+ */
+using IndexEntryConsumer = std::function<void(const Row &key, RowId row_id)>;
+
+/**
+ * Hands every entry of a bulk load to the consumer, e.g. a scan of the indexed table
+ */
+using IndexEntrySource = std::function<void(const IndexEntryConsumer &consume)>;
+
+/**
+ * Receives the rows of a range scan a batch at a time, returns false to end the scan
+ */
+using RowIdBatchConsumer = std::function<bool(const std::vector<RowId> &batch)>;
+
 class Index {
 public:
   explicit Index(index_id_t index_id, IndexSchema *key_schema)
@@ -23,8 +48,43 @@ public:
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * Fill an empty index with the entries of source, which it may sort before building its structure in one
+   * pass. Entries whose key is already in a unique index are skipped as InsertEntry would refuse them.
+   */
+  virtual dberr_t BulkLoad(const IndexEntrySource &source, Transaction *txn) {
+    source([&](const Row &key, RowId row_id) { InsertEntry(key, row_id, txn); });
+    return DB_SUCCESS;
+  }
+
+  /**
+   * Rows whose key lies between lo and hi, in key order, for indexes that keep their keys in order
+   * @param lo smallest key of the range, nullptr for a range open below, where nulls sort first
+   * @param hi largest key of the range, nullptr for a range open above
+   * @param limit number of rows at most, 0 for no limit
+   * @return DB_FAILED if keys are not kept in order
+   */
+  virtual dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, uint64_t limit,
+                            const RowIdBatchConsumer &consume, Transaction *txn) {
+    return DB_FAILED;
+  }
+
+  /**
+   * Smallest key of the index whose first field is not null, for indexes that keep their keys in order
+   * @param[out] key deserialized with the key schema
+   * @return DB_KEY_NOT_FOUND if there is no such key, DB_FAILED if keys are not kept in order
+   */
+  virtual dberr_t GetMinKey(Row &key) { return DB_FAILED; }
 
+  /**
+   * Largest key of the index, see GetMinKey
+   */
+  virtual dberr_t GetMaxKey(Row &key) { return DB_FAILED; }
 
+  /**
+   * @return true if InsertEntry refuses a second row of a key
+   */
+  virtual bool IsUnique() const { return false; }
 
 protected:
   index_id_t index_id_;
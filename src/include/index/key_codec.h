@@ -0,0 +1,59 @@
+#ifndef MINISQL_KEY_CODEC_H
+#define MINISQL_KEY_CODEC_H
+
+#include <cstdint>
+
+#include "record/schema.h"
+
+class Row;
+
+/**
+ * Order-preserving binary encoding of index keys, so that two keys compare like their fields by a
+ * plain memcmp of their encodings.
+ *
+ * Every field starts with a null byte, 0 for null and 1 otherwise, so nulls sort before any value
+ * and equal each other. It is followed by:
+ *  - int: 4 bytes big-endian with the sign bit flipped
+ *  - float: 4 bytes big-endian, the sign bit flipped for positive values and all bits flipped for
+ *    negative ones; -0 is stored as 0
+ *  - char: the bytes of the value with every 0x00 escaped as 0x00 0xFF, ended by 0x00 0x01
+ * Null fields have no value bytes. Each field ends where its own bytes say, so an encoding is never a
+ * prefix of another one and bytes past the end of a key may hold anything equal on both sides,
+ * e.g. the zeroed tail of a GenericKey.
+ */
+class KeyCodec {
+public:
+  /**
+   * @return bytes Encode writes for key
+   */
+  static uint32_t GetEncodedSize(const Row &key, Schema *schema);
+
+  /**
+   * @return bytes Encode may write for any key of schema, a char value made of zeros is twice its length
+   */
+  static uint32_t GetMaxEncodedSize(Schema *schema);
+
+  static uint32_t Encode(const Row &key, Schema *schema, char *buf);
+
+  /**
+   * Write the smallest encoding whose first field is not null, followed by zeros it is above every key whose
+   * first field is null and not above any other key
+   * @return bytes written
+   */
+  static uint32_t EncodeNotNullBound(char *buf);
+
+  /**
+   * Append the fields of an encoded key to an empty row
+   * @return bytes read from buf
+   */
+  static uint32_t Decode(const char *buf, Schema *schema, Row *key);
+
+private:
+  static constexpr char NULL_MARKER = 0;
+  static constexpr char VALUE_MARKER = 1;
+  static constexpr char ESCAPE = 0;
+  static constexpr char ESCAPED_ZERO = static_cast<char>(0xff);
+  static constexpr char TERMINATOR = 1;
+};
+
+#endif  // MINISQL_KEY_CODEC_H
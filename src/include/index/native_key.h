@@ -0,0 +1,60 @@
+#ifndef MINISQL_NATIVE_KEY_H
+#define MINISQL_NATIVE_KEY_H
+
+#include <ostream>
+#include <type_traits>
+
+#include "record/row.h"
+#include "record/field.h"
+
+/**
+ * Index key of a single non-null int or float column, stored as the value itself so that a leaf entry
+ * takes sizeof(T) + sizeof(RowId) bytes and keys compare as numbers
+ */
+template<typename T>
+class NativeKey {
+  static_assert(std::is_same<T, int32_t>::value || std::is_same<T, float>::value, "Unsupported native key type.");
+
+public:
+  inline void SerializeFromKey(const Row &key, Schema *schema) {
+    ASSERT(key.GetFieldCount() == 1 && schema->GetColumnCount() == 1, "Native keys have a single field.");
+    const Field *field = key.GetField(0);
+    ASSERT(!field->IsNull(), "Native keys are never null.");
+    if constexpr (std::is_same<T, int32_t>::value) {
+      value = field->value_.integer_;
+    } else {
+      // -0 and 0 are the same key
+      value = field->value_.float_ == 0.0f ? 0.0f : field->value_.float_;
+    }
+  }
+
+  inline void DeserializeToKey(Row &key, Schema *schema) const {
+    ASSERT(key.fields_.empty(), "Row is not empty");
+    key.fields_.push_back(ALLOC_P(key.heap_, Field)(schema->GetColumn(0)->GetType(), value));
+  }
+
+  inline bool operator==(const NativeKey &other) const { return value == other.value; }
+
+  friend std::ostream &operator<<(std::ostream &os, const NativeKey &key) {
+    os << key.value;
+    return os;
+  }
+
+  T value;
+};
+
+/**
+ * Function object comparing two native keys, negative if lhs < rhs, used for trees
+ */
+template<typename T>
+class NativeComparator {
+public:
+  inline int operator()(const NativeKey<T> &lhs, const NativeKey<T> &rhs) const {
+    return (rhs.value < lhs.value) - (lhs.value < rhs.value);
+  }
+
+  // the schema is fixed by T, it is taken to be constructed like GenericComparator
+  explicit NativeComparator(Schema *) {}
+};
+
+#endif  // MINISQL_NATIVE_KEY_H
@@ -0,0 +1,123 @@
+#ifndef MINISQL_ROARING_BITMAP_H
+#define MINISQL_ROARING_BITMAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+
+/**
+ * Compressed set of row ids, laid out like a Roaring bitmap.
+ *
+ * Row ids are split into a high part, the page id, and a low part, the slot number. Each page holding
+ * at least one member has a container of its slots, containers are kept sorted by page id. A slot
+ * takes at least one byte of its page, so slots are below PAGE_SIZE and a container covers PAGE_SIZE
+ * slots. A container is a sorted array of slots while it holds at most ARRAY_MAX_SIZE of them and a
+ * bitmap of PAGE_SIZE bits beyond, whichever is smaller.
+ *
+ * Set operations work container by container and only touch pages present in both operands (AND,
+ * AND NOT) or in either one (OR). Members are enumerated in row id order, so fetching them visits
+ * every heap page once.
+ */
+class RoaringBitmap {
+public:
+  /**
+   * @return false if rid was already a member
+   */
+  bool Add(const RowId &rid);
+
+  /**
+   * @return false if rid was not a member
+   */
+  bool Remove(const RowId &rid);
+
+  bool Contains(const RowId &rid) const;
+
+  inline uint64_t GetCardinality() const { return cardinality_; }
+
+  inline bool IsEmpty() const { return cardinality_ == 0; }
+
+  void Clear();
+
+  /**
+   * Keep the members that are also members of other
+   */
+  void And(const RoaringBitmap &other);
+
+  /**
+   * Add the members of other
+   */
+  void Or(const RoaringBitmap &other);
+
+  /**
+   * Drop the members of other
+   */
+  void AndNot(const RoaringBitmap &other);
+
+  /**
+   * Complement within universe, i.e. the members of universe that are not members of this bitmap
+   */
+  void Not(const RoaringBitmap &universe);
+
+  /**
+   * Append the members in row id order, page by page and slot by slot
+   */
+  void ToRowIds(std::vector<RowId> *rids) const;
+
+  /**
+   * @return bytes taken by the containers, to compare array and bitmap containers
+   */
+  uint64_t GetSizeInBytes() const;
+
+  /** an array container is no larger than a bitmap container up to this size */
+  static constexpr uint32_t ARRAY_MAX_SIZE = PAGE_SIZE / 8 / sizeof(uint16_t);
+  static constexpr uint32_t BITMAP_WORDS = PAGE_SIZE / 64;
+
+private:
+  struct Container {
+    /** sorted slots of an array container, empty for a bitmap container */
+    std::vector<uint16_t> array_;
+    /** BITMAP_WORDS words of a bitmap container, empty for an array container */
+    std::vector<uint64_t> bits_;
+    uint32_t cardinality_{0};
+
+    inline bool IsBitmap() const { return !bits_.empty(); }
+
+    bool Contains(uint16_t slot) const;
+
+    /**
+     * Switch to the representation that is smaller for the current cardinality
+     */
+    void Normalize();
+
+    /**
+     * Turn into a bitmap container, whatever the cardinality
+     */
+    void ToBitmap();
+  };
+
+  /**
+   * @return position of the container of page_id, or where it would be inserted
+   */
+  size_t FindContainer(page_id_t page_id) const;
+
+  static Container AndContainers(const Container &a, const Container &b);
+
+  static Container OrContainers(const Container &a, const Container &b);
+
+  static Container AndNotContainers(const Container &a, const Container &b);
+
+  /**
+   * Recount cardinality_ after the containers were replaced
+   */
+  void Recount();
+
+private:
+  /** sorted, parallel to containers_ */
+  std::vector<page_id_t> keys_;
+  std::vector<Container> containers_;
+  uint64_t cardinality_{0};
+};
+
+#endif  // MINISQL_ROARING_BITMAP_H
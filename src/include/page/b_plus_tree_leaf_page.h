@@ -48,6 +48,9 @@ public:
 
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
 
+  // index of the first key greater than key, GetSize() if there is none
+  int UpperKeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
   const MappingType &GetItem(int index);
 
   // insert and delete methods
@@ -66,9 +69,11 @@ public:
 
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
-private:
+  // append items after the current entries
   void CopyNFrom(MappingType *items, int size);
 
+private:
+
   void CopyLastFrom(const MappingType &item);
 
   void CopyFirstFrom(const MappingType &item);
@@ -0,0 +1,80 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+/**
+ * Overflow page, holds one slice of a long char value that was moved out of its tuple.
+ * The slices of one value are chained through NextPageId, the tuple keeps a toast pointer
+ * to the first page:
+ *  --------------------------------------------------------
+ *  | TotalLength (4) | FirstPageId (4) | Prefix (<= TOAST_PREFIX_LEN) |
+ *  --------------------------------------------------------
+ * The catalog stores serialized table statistics in the same kind of chain, a table heap the entries of
+ * its column dictionaries.
+ *
+ *  Header format (size in bytes):
+ *  ------------------------------------------------------
+ *  | PageId (4)| LSN (4)| NextPageId (4)| DataSize (4) |
+ *  ------------------------------------------------------
+ **/
+
+#include <cstring>
+
+#include "page/page.h"
+
+class OverflowPage : public Page {
+public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  page_id_t GetOverflowPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  const char *GetPayload() { return GetData() + SIZE_OVERFLOW_PAGE_HEADER; }
+
+  /**
+   * Copy as much of data as fits into this page
+   * @return number of bytes written
+   */
+  uint32_t WritePayload(const char *data, uint32_t len) {
+    uint32_t size = len < MAX_DATA_SIZE ? len : MAX_DATA_SIZE;
+    memcpy(GetData() + SIZE_OVERFLOW_PAGE_HEADER, data, size);
+    SetDataSize(size);
+    return size;
+  }
+
+  /**
+   * Add data after the payload written so far
+   * @return false if it does not fit, nothing is written then
+   */
+  bool AppendPayload(const char *data, uint32_t len) {
+    uint32_t size = GetDataSize();
+    if (len > MAX_DATA_SIZE - size) {
+      return false;
+    }
+    memcpy(GetData() + SIZE_OVERFLOW_PAGE_HEADER + size, data, len);
+    SetDataSize(size + len);
+    return true;
+  }
+
+  static constexpr uint32_t SIZE_OVERFLOW_PAGE_HEADER = 16;
+  static constexpr uint32_t MAX_DATA_SIZE = PAGE_SIZE - SIZE_OVERFLOW_PAGE_HEADER;
+  /** toast pointer stored in the tuple, without its prefix */
+  static constexpr uint32_t SIZE_TOAST_POINTER = sizeof(uint32_t) + sizeof(page_id_t);
+
+private:
+  void SetDataSize(uint32_t size) { memcpy(GetData() + OFFSET_DATA_SIZE, &size, sizeof(uint32_t)); }
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_DATA_SIZE = 12;
+};
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
@@ -0,0 +1,123 @@
+#ifndef MINISQL_PAX_PAGE_H
+#define MINISQL_PAX_PAGE_H
+/**
+ * PAX page format, used by tables created with the PAX layout:
+ *  ------------------------------------------------------------------------------------
+ *  | HEADER | Slot states | Col_1 null bitmap | Col_1 values | ... | Col_N values |
+ *  ------------------------------------------------------------------------------------
+ * The page holds a fixed number of slots, given by the RowCodec of the schema. Every column has
+ * its own minipage, a null bitmap and a vector of fixed-width values, so reading one column of
+ * all rows touches that minipage only. Char values take the declared length of their column, values of
+ * a dictionary column are stored as their 2 byte code.
+ *
+ *  Header format (size in bytes):
+ *  ---------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| SlotCount (4)| UsedSlots (4) |
+ *  ---------------------------------------------------------------------------------------
+ * SlotCount is one past the last slot ever used, UsedSlots counts live and deleted slots.
+ **/
+
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+
+class PaxPage : public Page {
+public:
+  void Init(page_id_t page_id, page_id_t prev_id, Schema *schema, LogManager *log_mgr, Transaction *txn);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /**
+   * @param codes dictionary codes of the values of row, see RowCodec::EncodePax
+   * @return false if the page is full or a char value is longer than its column
+   */
+  bool InsertTuple(Row &row, const uint32_t *codes, Schema *schema, Transaction *txn, LockManager *lock_manager,
+                   LogManager *log_manager);
+
+  bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Overwrite the values of a live tuple in its slot, slots never move
+   * @return false if the tuple does not exist or a char value is longer than its column
+   */
+  bool UpdateTuple(const Row &new_row, const uint32_t *codes, const RowId &rid, Schema *schema, Transaction *txn,
+                   LockManager *lock_manager, LogManager *log_manager);
+
+  void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  void RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  /**
+   * @param fetch_mask one flag per column, columns not set are not read and come back as null
+   * @param dictionaries dictionaries of the table, indexed by column
+   */
+  bool GetTuple(Row *row, Schema *schema, const std::vector<bool> *fetch_mask,
+                const std::vector<ColumnDictionary> *dictionaries, Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * Read every live tuple that passes all code filters, one minipage at a time
+   * @param code_filters filters on dictionary columns, checked on the stored codes, may be nullptr
+   * @param heap fields and char data of the rows are allocated here, it must outlive the rows
+   * @param rows rows are appended in slot order
+   */
+  void GetTuples(Schema *schema, const std::vector<bool> *fetch_mask, const std::vector<CodeFilter> *code_filters,
+                 const std::vector<ColumnDictionary> *dictionaries, MemHeap *heap, std::vector<Row> *rows);
+
+  bool GetFirstTupleRid(RowId *first_rid);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+
+  /** number of slots, including empty and deleted ones */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_SLOT_COUNT); }
+
+  /** fill level of a PAX page, the number of slots that are free for an insert */
+  uint32_t GetFreeSpaceRemaining(Schema *schema) { return schema->GetCodec().GetPaxCapacity() - GetUsedSlots(); }
+
+  static constexpr uint32_t SIZE_PAX_PAGE_HEADER = 24;
+
+private:
+  enum SlotState : uint8_t { kSlotEmpty = 0, kSlotLive, kSlotDeleted };
+
+  char *GetArea() { return GetData() + SIZE_PAX_PAGE_HEADER; }
+
+  uint8_t GetSlotState(uint32_t slot) { return static_cast<uint8_t>(GetArea()[slot]); }
+
+  void SetSlotState(uint32_t slot, SlotState state) { GetArea()[slot] = static_cast<char>(state); }
+
+  void SetTupleCount(uint32_t slot_count) { memcpy(GetData() + OFFSET_SLOT_COUNT, &slot_count, sizeof(uint32_t)); }
+
+  uint32_t GetUsedSlots() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_USED_SLOTS); }
+
+  void SetUsedSlots(uint32_t used_slots) { memcpy(GetData() + OFFSET_USED_SLOTS, &used_slots, sizeof(uint32_t)); }
+
+  bool IsLive(uint32_t slot) { return slot < GetTupleCount() && GetSlotState(slot) == kSlotLive; }
+
+private:
+  static_assert(sizeof(page_id_t) == 4);
+  static_assert(SIZE_PAX_PAGE_HEADER + RowCodec::PAX_AREA_SIZE <= PAGE_SIZE);
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_SLOT_COUNT = 16;
+  static constexpr size_t OFFSET_USED_SLOTS = 20;
+};
+
+#endif  // MINISQL_PAX_PAGE_H
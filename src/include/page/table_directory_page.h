@@ -0,0 +1,76 @@
+#ifndef MINISQL_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_TABLE_DIRECTORY_PAGE_H
+/**
+ * Directory page of a table heap, lists the heap's pages in scan order together with the free space
+ * each of them has left. Directory pages of one table are chained through NextPageId.
+ *
+ *  Header format (size in bytes):
+ *  --------------------------------------------------------
+ *  | PageId (4)| LSN (4)| NextPageId (4)| EntryCount (4) |
+ *  --------------------------------------------------------
+ *  -------------------------------------------------------------------------
+ *  | Page_1 id (4) | Page_1 free space (4) | Page_2 id (4) | ... |
+ *  -------------------------------------------------------------------------
+ **/
+
+#include <cstring>
+
+#include "page/page.h"
+
+class TableDirectoryPage : public Page {
+public:
+  void Init(page_id_t page_id) {
+    memcpy(GetData(), &page_id, sizeof(page_id));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetEntryCount(0);
+  }
+
+  page_id_t GetDirectoryPageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetEntryCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ENTRY_COUNT); }
+
+  page_id_t GetPageId(uint32_t slot) {
+    return *reinterpret_cast<page_id_t *>(GetData() + SIZE_DIRECTORY_PAGE_HEADER + SIZE_ENTRY * slot);
+  }
+
+  uint32_t GetFreeSpace(uint32_t slot) {
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE + SIZE_ENTRY * slot);
+  }
+
+  void SetFreeSpace(uint32_t slot, uint32_t free_space) {
+    memcpy(GetData() + OFFSET_FREE_SPACE + SIZE_ENTRY * slot, &free_space, sizeof(uint32_t));
+  }
+
+  /**
+   * @return false if the page is full
+   */
+  bool Append(page_id_t page_id, uint32_t free_space) {
+    uint32_t slot = GetEntryCount();
+    if (slot >= MAX_ENTRY_COUNT) {
+      return false;
+    }
+    memcpy(GetData() + SIZE_DIRECTORY_PAGE_HEADER + SIZE_ENTRY * slot, &page_id, sizeof(page_id_t));
+    SetFreeSpace(slot, free_space);
+    SetEntryCount(slot + 1);
+    return true;
+  }
+
+  static constexpr uint32_t SIZE_DIRECTORY_PAGE_HEADER = 16;
+  static constexpr uint32_t SIZE_ENTRY = sizeof(page_id_t) + sizeof(uint32_t);
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - SIZE_DIRECTORY_PAGE_HEADER) / SIZE_ENTRY;
+
+private:
+  void SetEntryCount(uint32_t count) { memcpy(GetData() + OFFSET_ENTRY_COUNT, &count, sizeof(uint32_t)); }
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 8;
+  static constexpr size_t OFFSET_ENTRY_COUNT = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = SIZE_DIRECTORY_PAGE_HEADER + sizeof(page_id_t);
+};
+
+#endif  // MINISQL_TABLE_DIRECTORY_PAGE_H
@@ -17,6 +17,10 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> ANALYZE STATS
+%token <syntax_node> DICTIONARY IN
+%token <syntax_node> COMPRESSED
+%token <syntax_node> TRUNCATE
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
@@ -27,7 +31,9 @@
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_set_variable
+%type <syntax_node> sql_analyze sql_show_stats sql_truncate_table
+%type <syntax_node> aggregate_list aggregate
 
 %%
 
@@ -58,6 +64,10 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_set_variable { $$ = $1; }
+  | sql_analyze { $$ = $1; }
+  | sql_show_stats { $$ = $1; }
+  | sql_truncate_table { $$ = $1; }
   ;
 
 sql_create_database:
@@ -101,6 +111,35 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode layout_node = CreateSyntaxNode(kNodeTableLayout, "table layout");
+    SyntaxNodeAddChildren(layout_node, $8);
+    SyntaxNodeAddChildren($$, layout_node);
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' COMPRESSED {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    SyntaxNodeAddChildren($$, CreateSyntaxNode(kNodeTableCompression, "compressed"));
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' USING IDENTIFIER COMPRESSED {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode layout_node = CreateSyntaxNode(kNodeTableLayout, "table layout");
+    SyntaxNodeAddChildren(layout_node, $8);
+    SyntaxNodeAddChildren($$, layout_node);
+    SyntaxNodeAddChildren($$, CreateSyntaxNode(kNodeTableCompression, "compressed"));
+  }
   ;
 
 column_list:
@@ -133,6 +172,11 @@ column_definition:
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
   }
+  | IDENTIFIER column_type DICTIONARY {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, "dictionary");
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+  }
   | IDENTIFIER column_type {
     $$ = CreateSyntaxNode(kNodeColumnDefinition, NULL);
     SyntaxNodeAddChildren($$, $1);
@@ -219,6 +263,31 @@ select_columns:
     $$ = CreateSyntaxNode(kNodeColumnList, "select columns");
     SyntaxNodeAddChildren($$, $1);
   }
+  | aggregate_list {
+    $$ = CreateSyntaxNode(kNodeAggregateList, "select aggregates");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  ;
+
+aggregate_list:
+  aggregate ',' aggregate_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | aggregate {
+    $$ = $1;
+  }
+  ;
+
+aggregate:
+  IDENTIFIER '(' '*' ')' {
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+    SyntaxNodeAddChildren($$, CreateSyntaxNode(kNodeAllColumns, NULL));
+  }
+  | IDENTIFIER '(' IDENTIFIER ')' {
+    $$ = CreateSyntaxNode(kNodeAggregate, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+  }
   ;
 
 where_conditions:
@@ -247,6 +316,27 @@ where_condition:
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
   }
+  | IDENTIFIER IN '(' column_values ')' {
+    /* col in (v1, v2, ...) is read as col = v1 or col = v2 or ... */
+    $$ = NULL;
+    pSyntaxNode val = $4;
+    while (val != NULL) {
+      pSyntaxNode next = val->next_;
+      val->next_ = NULL;
+      pSyntaxNode cmp = CreateSyntaxNode(kNodeCompareOperator, "=");
+      SyntaxNodeAddChildren(cmp, $$ == NULL ? $1 : CreateSyntaxNode(kNodeIdentifier, $1->val_));
+      SyntaxNodeAddChildren(cmp, val);
+      if ($$ == NULL) {
+        $$ = cmp;
+      } else {
+        pSyntaxNode conn = CreateSyntaxNode(kNodeConnector, "or");
+        SyntaxNodeAddChildren(conn, $$);
+        SyntaxNodeAddChildren(conn, cmp);
+        $$ = conn;
+      }
+      val = next;
+    }
+  }
   ;
 
 column_value:
@@ -393,6 +483,34 @@ sql_exec_file:
   }
   ;
 
+sql_set_variable:
+  SET IDENTIFIER EQ NUMBER {
+    $$ = CreateSyntaxNode(kNodeSetVariable, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_analyze:
+  ANALYZE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_show_stats:
+  SHOW STATS {
+    $$ = CreateSyntaxNode(kNodeShowStats, NULL);
+  }
+  ;
+
+sql_truncate_table:
+  TRUNCATE TABLE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeTruncateTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
@@ -43,7 +43,15 @@ typedef enum {
   kNodeIndexType, /** type of index */
   kNodeTrxBegin, /** begin transaction command */
   kNodeTrxCommit, /** commit transaction command */
-  kNodeTrxRollback /** rollback transaction command */
+  kNodeTrxRollback, /** rollback transaction command */
+  kNodeSetVariable, /** set session variable command */
+  kNodeAnalyze, /** analyze table command */
+  kNodeShowStats, /** show table statistics command */
+  kNodeTableLayout, /** page layout of a new table */
+  kNodeTableCompression, /** pages of a new table are stored compressed */
+  kNodeAggregateList, /** aggregates of a select, instead of its columns */
+  kNodeAggregate, /** aggregate function applied to a column or to '*' */
+  kNodeTruncateTable /** truncate table command */
 } SyntaxNodeType;
 
 /**
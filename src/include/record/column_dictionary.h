@@ -0,0 +1,50 @@
+#ifndef MINISQL_COLUMN_DICTIONARY_H
+#define MINISQL_COLUMN_DICTIONARY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Table-level dictionary of one char column. Every distinct value gets a small integer code in the
+ * order values first appear. Codes are never reassigned, so a code stored in a page stays valid for
+ * the life of the table. Callers serialize access, see TableHeap.
+ */
+class ColumnDictionary {
+public:
+  /**
+   * @return code of the value, INVALID_CODE if it is not in the dictionary
+   */
+  uint32_t Find(const char *data, uint32_t len) const;
+
+  /**
+   * Add a value that is not in the dictionary yet
+   * @return its code, INVALID_CODE if all MAX_CODES codes are taken
+   */
+  uint32_t Add(const char *data, uint32_t len);
+
+  inline const std::string &GetValue(uint32_t code) const { return values_[code]; }
+
+  inline uint32_t GetSize() const { return static_cast<uint32_t>(values_.size()); }
+
+  /** codes are stored as 16 bit values */
+  static constexpr uint32_t MAX_CODES = UINT16_MAX;
+  static constexpr uint32_t INVALID_CODE = UINT32_MAX;
+
+private:
+  std::vector<std::string> values_;
+  std::unordered_map<std::string, uint32_t> codes_;
+};
+
+/**
+ * Pre-filter of a scan on a dictionary column. A row passes if the code of its value is set in
+ * codes_, null values never pass. Rows that fail are dropped before any of their values is decoded.
+ */
+struct CodeFilter {
+  uint32_t column_index_;
+  /** indexed by code, codes past the end do not pass */
+  std::vector<bool> codes_;
+};
+
+#endif  // MINISQL_COLUMN_DICTIONARY_H
@@ -17,6 +17,19 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class Row;
+
+  friend class RowView;
+
+  friend class RowCodec;
+
+  friend class KeyCodec;
+
+  template<typename T>
+  friend class NativeKey;
+
+  friend class TableHeap;
+
 public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
@@ -66,6 +79,7 @@ public:
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
+    is_external_ = other.is_external_;
     if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
@@ -84,6 +98,13 @@ public:
     return is_null_;
   }
 
+  /**
+   * The value lives in overflow pages, the field only holds its toast pointer (see overflow_page.h)
+   */
+  inline bool IsExternal() const {
+    return is_external_;
+  }
+
   inline uint32_t GetLength() const {
     return Type::GetInstance(type_id_)->GetLength(*this);
   }
@@ -140,6 +161,7 @@ public:
     std::swap(first.len_, second.len_);
     std::swap(first.is_null_, second.is_null_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.is_external_, second.is_external_);
   }
 
 protected:
@@ -152,6 +174,7 @@ protected:
   uint32_t len_;
   bool is_null_{false};
   bool manage_data_{false};
+  bool is_external_{false};
 };
 
 
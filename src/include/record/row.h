@@ -10,29 +10,45 @@
 #include "utils/mem_heap.h"
 
 /**
- *  Row format:
+ *  Row format v1:
  * -------------------------------------------
  * | Header | Field-1 | ... | Field-N |
  * -------------------------------------------
  *  Header format:
  * --------------------------------------------
- * | Field Nums | Null bitmap |
+ * | RowId | Field Nums | Null bitmap |
  * -------------------------------------------
- *  
  *
+ *  Row format v2 (compact), column positions are precomputed by the Schema:
+ * -------------------------------------------------------------------------------------
+ * | Null bitmap | Fixed-width fields | Var end offsets (2 each) | Var-length data ... |
+ * -------------------------------------------------------------------------------------
+ *  Fixed-width fields keep their slot even when null, a null variable-length field has
+ *  an empty range. The RowId is already known by the page slot and is not stored.
  */
 class Row {
+  friend class RowCodec;
+
+  friend class KeyCodec;
+
+  template<typename T>
+  friend class NativeKey;
+
 public:
   /**
    * Row used for insert
    * Field integrity should check by upper level
    */
   explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
-    // deep copy
-    for (auto &field : fields) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(field));
-    }
+    CopyFields(fields);
+  }
+
+  /**
+   * Row used for insert, fields are deep copied into a heap owned by the caller (e.g. the
+   * statement arena), which must outlive the row
+   */
+  Row(std::vector<Field> &fields, MemHeap *heap) : heap_(heap), own_heap_(false) {
+    CopyFields(fields);
   }
 
   /**
@@ -45,25 +61,45 @@ public:
    */
   Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
 
+  /**
+   * Row used for deserialize and update, fields and char data are allocated from a heap
+   * owned by the caller, which must outlive the row
+   */
+  Row(RowId rid, MemHeap *heap) : rid_(rid), heap_(heap), own_heap_(false) {}
+
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
-    rid_ = other.rid_;
+  Row(const Row &other) : rid_(other.rid_), heap_(new SimpleMemHeap) {
     for (auto &field : other.fields_) {
       void *buf = heap_->Allocate(sizeof(Field));
       fields_.push_back(new(buf)Field(*field));
     }
   }
 
+  /**
+   * Row copy function, fields and char data are copied to a heap owned by the caller, which must
+   * outlive the row, e.g. to keep a row the scan is about to release
+   */
+  Row(const Row &other, MemHeap *heap);
+
+  /**
+   * Row move function, the fields stay in their heap, which goes along with them
+   */
+  Row(Row &&other) noexcept
+      : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_), own_heap_(other.own_heap_) {
+    other.fields_.clear();
+    other.heap_ = nullptr;
+    other.own_heap_ = false;
+  }
+
   virtual ~Row() {
-    delete heap_;
+    for (auto field : fields_) {
+      field->~Field();
+    }
+    if (own_heap_) {
+      delete heap_;
+    }
   }
 
   /**
@@ -96,10 +132,19 @@ public:
 private:
   Row &operator=(const Row &other) = delete;
 
+  void CopyFields(std::vector<Field> &fields) {
+    // deep copy
+    for (auto &field : fields) {
+      void *buf = heap_->Allocate(sizeof(Field));
+      fields_.push_back(new(buf)Field(field));
+    }
+  }
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
   MemHeap *heap_{nullptr};
+  bool own_heap_{true};   /** a borrowed heap releases its memory on its own */
 };
 
 #endif //MINISQL_TUPLE_H
@@ -0,0 +1,181 @@
+#ifndef MINISQL_ROW_CODEC_H
+#define MINISQL_ROW_CODEC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "record/column.h"
+#include "record/column_dictionary.h"
+
+class Field;
+
+class Row;
+
+/**
+ * On-page tuple format of a table, see row.h
+ */
+enum RowFormat {
+  kRowFormatV1 = 0,
+  kRowFormatV2,
+  /** column-major pages, see PaxPage */
+  kRowFormatPax
+};
+
+/**
+ * How a column stores its values in PAX pages
+ */
+enum ColumnEncoding {
+  kEncodingPlain = 0,
+  /** a 16 bit code into the table's ColumnDictionary, char columns only */
+  kEncodingDictionary
+};
+
+/**
+ * RowCodec is the serialization plan of one schema, built once when the schema is created
+ * or loaded. Column kinds, widths and v2 offsets are resolved up front, so encoding and
+ * decoding a row is a pair of straight loops with no per-field Type dispatch.
+ *
+ * Int and float are both 4-byte values and are moved as raw words; char columns are the
+ * only variable-length kind.
+ */
+class RowCodec {
+public:
+  explicit RowCodec(const std::vector<Column *> &columns);
+
+  inline RowFormat GetRowFormat() const { return row_format_; }
+
+  inline void SetRowFormat(RowFormat row_format) { row_format_ = row_format; }
+
+  /**
+   * Note: writes exactly GetSerializedSize(row) bytes
+   */
+  uint32_t Encode(const Row &row, char *buf) const;
+
+  uint32_t Decode(const char *buf, Row *row) const;
+
+  uint32_t GetSerializedSize(const Row &row) const;
+
+  inline bool IsFixedWidth(uint32_t column_index) const { return types_[column_index] != TypeId::kTypeChar; }
+
+  inline uint32_t GetFixedOffset(uint32_t column_index) const { return column_layout_[column_index]; }
+
+  inline uint32_t GetVarIndex(uint32_t column_index) const { return column_layout_[column_index]; }
+
+  inline uint32_t GetNullBitmapSize() const { return (static_cast<uint32_t>(types_.size()) + 7) / 8; }
+
+  inline uint32_t GetVarColumnCount() const { return static_cast<uint32_t>(var_columns_.size()); }
+
+  inline uint32_t GetVarOffsetsBegin() const { return var_offsets_begin_; }
+
+  inline uint32_t GetVarDataBegin() const { return var_offsets_begin_ + GetVarColumnCount() * sizeof(uint16_t); }
+
+  inline ColumnEncoding GetColumnEncoding(uint32_t column_index) const { return encodings_[column_index]; }
+
+  /**
+   * Change the encoding of a column, the PAX layout is planned again
+   */
+  void SetColumnEncoding(uint32_t column_index, ColumnEncoding encoding);
+
+  inline bool HasDictionaryColumns() const { return dictionary_column_count_ > 0; }
+
+  /**
+   * PAX: rows one page holds, 0 if a single row does not fit
+   */
+  inline uint32_t GetPaxCapacity() const { return pax_capacity_; }
+
+  /**
+   * PAX: offset of the null bitmap minipage of a column from the start of the page area
+   */
+  inline uint32_t GetPaxNullOffset(uint32_t column_index) const { return pax_null_offsets_[column_index]; }
+
+  /**
+   * PAX: offset of the value vector of a column, GetPaxWidth bytes per slot
+   */
+  inline uint32_t GetPaxValueOffset(uint32_t column_index) const { return pax_value_offsets_[column_index]; }
+
+  /**
+   * PAX: 4 for int and float, a 2 byte length and the declared length of a char column, a 2 byte code
+   * for a dictionary column
+   */
+  inline uint32_t GetPaxWidth(uint32_t column_index) const { return pax_widths_[column_index]; }
+
+  /**
+   * @return false if some plain char value is longer than its column, it has no room in a PAX slot
+   */
+  bool FitsPax(const Row &row) const;
+
+  /**
+   * Write every value of row into slot of the minipages of a PAX page area
+   * @param codes dictionary code of every non-null value of a dictionary column, indexed by column
+   */
+  void EncodePax(const Row &row, const uint32_t *codes, uint32_t slot, char *area) const;
+
+  /**
+   * Decode one row per slot, column by column so every minipage is read in one pass. Columns not in
+   * fetch_mask are not read and come back as null fields.
+   * @param rows count empty rows, one per slot
+   * @param fetch_mask one flag per column, nullptr reads every column
+   * @param dictionaries indexed by column, needed if a dictionary column is read
+   */
+  void DecodePax(const char *area, const uint32_t *slots, uint32_t count, const std::vector<bool> *fetch_mask,
+                 const std::vector<ColumnDictionary> *dictionaries, Row *rows) const;
+
+  /**
+   * PAX: @return true if the value of a column in slot is null
+   */
+  bool IsPaxNull(const char *area, uint32_t column_index, uint32_t slot) const;
+
+  /**
+   * PAX: @return the stored code of a non-null value of a dictionary column
+   */
+  inline uint32_t GetPaxCode(const char *area, uint32_t column_index, uint32_t slot) const {
+    return *reinterpret_cast<const uint16_t *>(area + pax_value_offsets_[column_index] + slot * sizeof(uint16_t));
+  }
+
+  /** v2: set on a var end offset when the value is a toast pointer, offsets stay below PAGE_SIZE */
+  static constexpr uint16_t VAR_EXTERNAL_FLAG = 0x8000;
+
+  /**
+   * PAX: bytes of a page laid out by the codec, the page header takes the rest. The area starts with
+   * one state byte per slot, followed by the null bitmap and the value vector of every column.
+   */
+  static constexpr uint32_t PAX_AREA_SIZE = PAGE_SIZE - 32;
+
+private:
+  static Field *NewCharField(Row *row, TypeId type, const char *data, uint32_t len);
+
+  uint32_t EncodeV1(const Row &row, char *buf) const;
+
+  uint32_t DecodeV1(const char *buf, Row *row) const;
+
+  uint32_t EncodeV2(const Row &row, char *buf) const;
+
+  uint32_t DecodeV2(const char *buf, Row *row) const;
+
+  void BuildPaxLayout();
+
+private:
+  static constexpr uint32_t FIXED_WIDTH = 4;
+  static constexpr uint32_t V1_HEADER_SIZE = sizeof(int64_t) + sizeof(size_t);
+
+  RowFormat row_format_{kRowFormatV1};
+  std::vector<TypeId> types_;
+  /** v2: offset of a fixed-width column, or ordinal of a variable-length column */
+  std::vector<uint32_t> column_layout_;
+  /** column indexes in column order, split by kind */
+  std::vector<uint32_t> fixed_columns_;
+  std::vector<uint32_t> var_columns_;
+  uint32_t var_offsets_begin_{0};
+  /** declared length of char columns */
+  std::vector<uint32_t> lengths_;
+  std::vector<ColumnEncoding> encodings_;
+  uint32_t dictionary_column_count_{0};
+  /** PAX minipage layout, computed for every schema */
+  uint32_t pax_capacity_{0};
+  std::vector<uint32_t> pax_widths_;
+  std::vector<uint32_t> pax_null_offsets_;
+  std::vector<uint32_t> pax_value_offsets_;
+};
+
+#endif //MINISQL_ROW_CODEC_H
@@ -0,0 +1,137 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+/**
+ * RowView is a read-only, non-owning accessor over a serialized row (see row.h for the formats).
+ *
+ * Nothing is copied or allocated: the view only remembers where the tuple bytes start. For v2
+ * rows every column is reached in O(1) through the schema layout, for v1 rows column offsets
+ * are resolved lazily on first access and cached inline. The caller must keep the underlying
+ * bytes alive (e.g. keep the page pinned) while the view is in use.
+ */
+class RowView {
+public:
+  RowView() = default;
+
+  RowView(const char *data, const Schema *schema, RowId rid = INVALID_ROWID) { Reset(data, schema, rid); }
+
+  /**
+   * Re-point the view at another serialized row, dropping all cached offsets.
+   * v2 rows do not store their RowId, rid is what GetRowId() reports for them.
+   */
+  void Reset(const char *data, const Schema *schema, RowId rid = INVALID_ROWID);
+
+  inline bool IsValid() const { return data_ != nullptr; }
+
+  inline const char *GetData() const { return data_; }
+
+  inline const Schema *GetSchema() const { return schema_; }
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline TypeId GetTypeId(uint32_t idx) const { return schema_->GetColumn(idx)->GetType(); }
+
+  /**
+   * O(1), reads the null bitmap in place
+   */
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_count_, "Failed to access field");
+    return (bitmap_[idx / 8] >> (idx % 8)) & 1u;
+  }
+
+  int32_t GetInt(uint32_t idx) const;
+
+  float GetFloat(uint32_t idx) const;
+
+  /**
+   * v2 only: the char value at idx is a toast pointer, the value itself lives in overflow pages
+   */
+  bool IsExternal(uint32_t idx) const;
+
+  /**
+   * Returns a pointer into the tuple bytes, the value is not null-terminated.
+   * For an external value these are the bytes of its toast pointer.
+   */
+  const char *GetChars(uint32_t idx, uint32_t *len) const;
+
+  /**
+   * Total bytes occupied by the serialized row
+   */
+  uint32_t GetSerializedSize() const;
+
+  /**
+   * Three-way compare of column idx against column other_idx of another view.
+   * Null compares equal to anything, which matches Field::CompareLessThan/CompareGreaterThan
+   * both returning kNull.
+   */
+  int CompareField(uint32_t idx, const RowView &other, uint32_t other_idx) const;
+
+  /**
+   * Three-way compare of column idx against a materialized field of the same type
+   */
+  CmpBool CompareEquals(uint32_t idx, const Field &field) const;
+
+  CmpBool CompareLessThan(uint32_t idx, const Field &field) const;
+
+  CmpBool CompareGreaterThan(uint32_t idx, const Field &field) const;
+
+  /**
+   * Materialize column idx as a Field allocated from heap
+   */
+  Field *GetField(uint32_t idx, MemHeap *heap) const;
+
+private:
+  /**
+   * Offset of column idx from data_, resolving and caching every column in front of it
+   */
+  uint32_t GetFieldOffset(uint32_t idx) const;
+
+  static int CompareChars(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    int ret = memcmp(lhs, rhs, lhs_len < rhs_len ? lhs_len : rhs_len);
+    if (ret == 0 && lhs_len != rhs_len) {
+      ret = lhs_len < rhs_len ? -1 : 1;
+    }
+    return ret;
+  }
+
+  /**
+   * v2 only: start of the var_index-th variable-length value, i.e. the end of the previous one
+   */
+  inline uint32_t GetVarBegin(uint32_t var_index) const {
+    if (var_index == 0) {
+      return schema_->GetVarDataBegin();
+    }
+    return GetVarEnd(var_index - 1) & ~RowCodec::VAR_EXTERNAL_FLAG;
+  }
+
+  inline uint16_t GetVarEnd(uint32_t var_index) const {
+    return MACH_READ_FROM(uint16_t, data_ + schema_->GetVarOffsetsBegin() + var_index * sizeof(uint16_t));
+  }
+
+  int CompareToField(uint32_t idx, const Field &field, bool *is_null) const;
+
+private:
+  static constexpr uint32_t MAX_CACHED_OFFSETS = 32;
+
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowFormat row_format_{kRowFormatV1};
+  RowId rid_{};
+  const unsigned char *bitmap_{nullptr};
+  uint32_t field_count_{0};
+  /** offsets_[i] is valid for i < resolved_ */
+  mutable uint32_t resolved_{0};
+  mutable uint32_t offsets_[MAX_CACHED_OFFSETS + 1]{};
+};
+
+#endif //MINISQL_ROW_VIEW_H
@@ -4,13 +4,14 @@
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/column.h"
+#include "record/row_codec.h"
 
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
 
 class Schema {
  public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)), codec_(columns_) {}
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +29,41 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  inline RowFormat GetRowFormat() const { return codec_.GetRowFormat(); }
+
+  inline void SetRowFormat(RowFormat row_format) { codec_.SetRowFormat(row_format); }
+
+  inline ColumnEncoding GetColumnEncoding(const uint32_t column_index) const {
+    return codec_.GetColumnEncoding(column_index);
+  }
+
+  inline void SetColumnEncoding(const uint32_t column_index, ColumnEncoding encoding) {
+    codec_.SetColumnEncoding(column_index, encoding);
+  }
+
+  /**
+   * Serialization plan of this schema, also describes the row format v2 layout
+   */
+  inline const RowCodec &GetCodec() const { return codec_; }
+
+  inline bool IsFixedWidth(const uint32_t column_index) const { return codec_.IsFixedWidth(column_index); }
+
+  /** v2 offset of a fixed-width column from the start of the tuple */
+  inline uint32_t GetFixedOffset(const uint32_t column_index) const { return codec_.GetFixedOffset(column_index); }
+
+  /** ordinal of a variable-length column among the variable-length columns */
+  inline uint32_t GetVarIndex(const uint32_t column_index) const { return codec_.GetVarIndex(column_index); }
+
+  inline uint32_t GetNullBitmapSize() const { return codec_.GetNullBitmapSize(); }
+
+  inline uint32_t GetVarColumnCount() const { return codec_.GetVarColumnCount(); }
+
+  /** v2 offset of the variable-length end offset array, which directly follows the fixed-width columns */
+  inline uint32_t GetVarOffsetsBegin() const { return codec_.GetVarOffsetsBegin(); }
+
+  /** v2 offset of the first variable-length value */
+  inline uint32_t GetVarDataBegin() const { return codec_.GetVarDataBegin(); }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -75,6 +111,8 @@ class Schema {
  private:
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_; /** don't need to delete pointer to column */
+  /** row format and column encodings are not part of the serialized schema, table metadata keeps them */
+  RowCodec codec_;
 };
 
 using IndexSchema = Schema;
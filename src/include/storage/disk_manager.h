@@ -6,6 +6,9 @@
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
@@ -18,6 +21,15 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages marked with SetPageCompression are compressed when written and decompressed into the caller's
+ * buffer when read. A compressed page is stored in a slot of the slot file, named after the db file with
+ * SLOT_FILE_SUFFIX, and its place in the db file is left unwritten. Slot file format:
+ * | Slot 1 | Slot 2 | ... , every slot a multiple of SLOT_UNIT bytes:
+ * | PageId (4)| Compressed size (2)| Slot units (2)| Compressed page | Unused |
+ * Freed slots keep their size with an INVALID_PAGE_ID and are reused by pages of the same slot size.
+ * The page map, from page id to slot, is rebuilt by reading the slot headers when the db file is opened.
+ * A page that does not shrink by at least one SLOT_UNIT is stored uncompressed in the db file.
  */
 class DiskManager {
 public:
@@ -52,11 +64,33 @@ public:
    */
   void DeAllocatePage(page_id_t logical_page_id);
 
+  /**
+   * Free many pages at once, e.g. all pages of a table or an index. The bitmap page of every extent
+   * involved is read and written once and the meta page written once, instead of once per page.
+   */
+  void DeAllocatePages(const std::vector<page_id_t> &logical_page_ids);
+
   /**
    * Return whether specific logical_page_id is free
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * Store the page compressed from its next write on, or uncompressed if enable is false. A page that is
+   * already stored compressed stays compressed, also after the db file is reopened, until it is freed.
+   */
+  void SetPageCompression(page_id_t logical_page_id, bool enable);
+
+  /**
+   * @return bytes the page takes on disk, PAGE_SIZE if it is stored uncompressed
+   */
+  uint32_t GetStoredSize(page_id_t logical_page_id);
+
+  /**
+   * @return number of pages stored compressed
+   */
+  size_t GetCompressedPageCount();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -71,6 +105,9 @@ public:
   }
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  static constexpr const char *SLOT_FILE_SUFFIX = ".slots";
+  static constexpr uint32_t SLOT_UNIT = 512;
+  static constexpr uint32_t SLOT_HEADER_SIZE = 8;
 
 private:
   /**
@@ -93,6 +130,31 @@ private:
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * Rebuild the page map and the free slots from the slot file
+   */
+  void LoadSlots();
+
+  /**
+   * Store a compressed page in a slot of its size, replacing its previous slot
+   */
+  void WriteSlot(page_id_t logical_page_id, const char *data, uint32_t len);
+
+  /**
+   * Give back the slot of a page, if it is stored compressed
+   */
+  void FreeSlot(page_id_t logical_page_id);
+
+  void WriteSlotHeader(uint64_t offset, page_id_t logical_page_id, uint16_t len, uint16_t units);
+
+  struct Slot {
+    uint64_t offset_;
+    /** size of the compressed page */
+    uint16_t len_;
+    /** size of the slot in SLOT_UNIT, header included */
+    uint16_t units_;
+  };
+
 private:
   // stream to write db file
   std::fstream db_io_;
@@ -101,6 +163,14 @@ private:
   std::recursive_mutex db_io_latch_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
+  std::fstream slot_io_;
+  /** pages stored compressed, the page map */
+  std::unordered_map<page_id_t, Slot> slots_;
+  /** offsets of free slots, indexed by slot units */
+  std::vector<std::vector<uint64_t>> free_slots_;
+  uint64_t slot_file_size_{0};
+  /** pages to compress on their next write */
+  std::unordered_set<page_id_t> compressed_pages_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef MINISQL_PAGE_COMPRESSOR_H
+#define MINISQL_PAGE_COMPRESSOR_H
+
+#include <cstdint>
+
+/**
+ * Byte-oriented LZ77 compression of page images, in the spirit of LZ4.
+ *
+ * The output is a list of sequences, each one a run of literal bytes followed by a match, i.e. a copy
+ * of earlier output:
+ *  --------------------------------------------------------------------------------------
+ *  | Token (1)| Literal length (0+)| Literals | Offset (2)| Match length (0+) |
+ *  --------------------------------------------------------------------------------------
+ * The high nibble of the token is the literal count, the low nibble the match length minus MIN_MATCH.
+ * A nibble of 15 is continued by bytes that are added to it, up to and including the first byte below 255.
+ * The last sequence has literals only and ends the input. Matches are found through a hash table of
+ * the last position of every 4 byte prefix, which finds the runs of zeros and the repeated strings that
+ * make up most of a table page.
+ */
+class PageCompressor {
+public:
+  /**
+   * @param capacity size of dst, compression gives up once the output would be larger
+   * @return size of the compressed data, 0 if it does not fit capacity
+   */
+  static uint32_t Compress(const char *src, uint32_t len, char *dst, uint32_t capacity);
+
+  /**
+   * @param dst_len expected size of the decompressed data
+   * @return false if src is not the complete output of Compress for dst_len bytes
+   */
+  static bool Decompress(const char *src, uint32_t len, char *dst, uint32_t dst_len);
+
+  static constexpr uint32_t MIN_MATCH = 4;
+
+private:
+  static constexpr uint32_t HASH_BITS = 12;
+  static constexpr uint32_t MAX_OFFSET = UINT16_MAX;
+};
+
+#endif  // MINISQL_PAGE_COMPRESSOR_H
@@ -2,8 +2,13 @@
 #define MINISQL_TABLE_HEAP_H
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "page/overflow_page.h"
+#include "page/pax_page.h"
 #include "page/table_page.h"
 #include "storage/table_iterator.h"
+#include "storage/table_page_directory.h"
+#include "storage/table_zone_map.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 
@@ -17,16 +22,32 @@ class TableHeap {
     return new (buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
   }
 
-  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
+  /**
+   * open an existing table heap by the first page of its directory
+   */
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id, Schema *schema,
                            LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+    return Create(buffer_pool_manager, directory_page_id, INVALID_PAGE_ID, schema, log_manager, lock_manager, heap);
+  }
+
+  /**
+   * open an existing table heap with dictionary columns, see GetDictionaryPageId
+   */
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id,
+                           page_id_t dictionary_page_id, Schema *schema, LogManager *log_manager,
+                           LockManager *lock_manager, MemHeap *heap) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new (buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new (buf)
+        TableHeap(buffer_pool_manager, directory_page_id, dictionary_page_id, schema, log_manager, lock_manager);
   }
 
   ~TableHeap() {}
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * In a v2 table, char values longer than TOAST_THRESHOLD are moved to overflow pages first.
+   * In a PAX table, the insert fails if a char value is longer than its column. Values of dictionary
+   * columns are added to the column's dictionary first.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
@@ -42,8 +63,9 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
-   * @param[in] row Tuple of new row
+   * if the new tuple is too large to fit in the old page, it is deleted there and inserted elsewhere
+   * @param[in/out] row Tuple of new row, its rid is that of the tuple after the update, which differs from rid
+   * if the tuple moved
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
    * @return true is update is successful.
@@ -72,6 +94,47 @@ class TableHeap {
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read a tuple, fetching out-of-line values of the given columns only. Any other moved value is left
+   * as its toast pointer (Field::IsExternal()) and must not be read. A PAX table does not read the
+   * other columns at all, they come back as null.
+   * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
+   * @param[in] txn transaction performing the read
+   * @param[in] fetch_columns indexes of the columns the caller is going to read
+   * @return true if the read was successful (i.e. the tuple exists)
+   */
+  bool GetTuple(Row *row, Transaction *txn, const std::vector<uint32_t> &fetch_columns);
+
+  /**
+   * Read every live tuple of one page of this table, pinning the page only once.
+   * @param[in] page_id page to read, see GetPageId
+   * @param[in] txn transaction performing the read
+   * @param[in] fetch_columns as in GetTuple, nullptr fetches every column
+   * @param[in] heap fields and char data of the rows are allocated here, e.g. an arena, it must outlive the rows
+   * @param[out] rows rows are appended in slot order
+   * @param[in] code_filters PAX pages skip the rows that fail these, other pages ignore them
+   * @return false if the page could not be fetched
+   */
+  bool GetPageTuples(page_id_t page_id, Transaction *txn, const std::vector<uint32_t> *fetch_columns, MemHeap *heap,
+                     std::vector<Row> *rows, const std::vector<CodeFilter> *code_filters = nullptr);
+
+  /**
+   * Read the tuples of many rows, e.g. the matches of an index scan, visiting each page once: the slots of
+   * a page are read under one pin and latch instead of fetching the page again for every row.
+   * @param[in] rids rows to read, sorted and without duplicates, see SortRowIds
+   * @param[in] txn transaction performing the read
+   * @param[in] fetch_columns as in GetTuple, nullptr fetches every column
+   * @param[in] heap as in GetPageTuples
+   * @param[out] rows rows that exist are appended in row id order
+   */
+  void GetTuples(const std::vector<RowId> &rids, Transaction *txn, const std::vector<uint32_t> *fetch_columns,
+                 MemHeap *heap, std::vector<Row> *rows);
+
+  /**
+   * Sort row ids by page and slot and drop the duplicates, the order GetTuples reads them in
+   */
+  static void SortRowIds(std::vector<RowId> *rids);
+
   /**
    * Free table heap and release storage in disk file
    */
@@ -82,6 +145,11 @@ class TableHeap {
    */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @return the begin iterator of this table, rows only carry the values of fetch_columns, see GetTuple
+   */
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &fetch_columns);
+
   /**
    * @return the end iterator of this table
    */
@@ -92,37 +160,224 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first directory page, which identifies the heap in the catalog
+   */
+  inline page_id_t GetDirectoryPageId() const { return directory_.GetDirectoryPageId(); }
+
+  /**
+   * @return the number of pages of this table, O(1)
+   */
+  inline uint32_t GetPageCount() const { return directory_.GetPageCount(); }
+
+  /**
+   * @return the id of the index-th page in scan order, O(1)
+   */
+  inline page_id_t GetPageId(uint32_t index) const { return directory_.GetPageId(index); }
+
+  /**
+   * Split the pages into at most k contiguous ranges of page indexes, e.g. one per scan worker
+   */
+  inline std::vector<TablePageDirectory::PageRange> Partition(uint32_t k) const { return directory_.Partition(k); }
+
+  /**
+   * @return per page summaries of the int and float columns, indexed like GetPageId
+   */
+  inline const TableZoneMap &GetZoneMap() const { return zone_map_; }
+
+  /**
+   * @return true if the pages of this table are PaxPage, chosen by the row format of the schema
+   */
+  inline bool IsPax() const { return schema_->GetRowFormat() == kRowFormatPax; }
+
+  /**
+   * @return first page of the dictionary entries, INVALID_PAGE_ID if no column is dictionary encoded
+   */
+  inline page_id_t GetDictionaryPageId() const { return dictionary_page_id_; }
+
+  /**
+   * Store the data and overflow pages of this table compressed on disk, each one from its next write on
+   */
+  void EnableCompression();
+
+  /**
+   * @return true if the pages of this table are stored compressed, see EnableCompression
+   */
+  inline bool IsCompressed() const { return compressed_; }
+
+  /**
+   * Write back the dirty data pages and sum up their size on disk
+   * @param[out] compressed_pages number of data pages stored compressed
+   * @return bytes the data pages take on disk
+   */
+  uint64_t GetStoredSize(uint32_t *compressed_pages) const;
+
+  /**
+   * @return code of a value of a dictionary column, ColumnDictionary::INVALID_CODE if no row ever held it
+   */
+  uint32_t FindCode(uint32_t column_index, const char *data, uint32_t len);
+
+  /**
+   * @return number of distinct values of a dictionary column
+   */
+  uint32_t GetDictionarySize(uint32_t column_index);
+
  private:
+  bool InsertInline(Row &row, Transaction *txn);
+
+  /**
+   * @param codes dictionary codes of a PAX row, see EncodeDictionaryValues
+   */
+  bool InsertIntoPage(page_id_t page_id, Row &row, const uint32_t *codes, Transaction *txn);
+
+  bool FetchTuple(Row *row, Transaction *txn, const std::vector<uint32_t> *fetch_columns);
+
+  /**
+   * Read a tuple from its page, which the caller holds pinned and read-latched. Out-of-line values are
+   * left to DetoastRow.
+   * @param fetch_mask see GetFetchMask, nullptr reads every column
+   */
+  bool ReadTuple(Page *page, Row *row, Transaction *txn, const std::vector<bool> *fetch_mask);
+
+  /**
+   * Update a tuple of a PAX table in its slot, page is pinned by the caller and unpinned here
+   */
+  bool UpdatePax(PaxPage *page, Row &row, const RowId &rid, Transaction *txn);
+
+  /**
+   * Format a new heap page, TablePage or PaxPage
+   * @return free space of the empty page, as kept by the directory
+   */
+  uint32_t InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn);
+
+  void SetNextPageId(page_id_t page_id, page_id_t next_page_id);
+
+  RowId GetFirstRowId();
+
+  /**
+   * @return the live tuple following cur_rid in scan order, an invalid row id at the end
+   */
+  RowId GetNextRowId(const RowId &cur_rid);
+
+  /**
+   * @return one flag per column of the schema, PAX pages only read the columns set
+   */
+  std::vector<bool> GetFetchMask(const std::vector<uint32_t> &fetch_columns) const;
+
+  /**
+   * Look up the codes of the values of dictionary columns, adding the values seen for the first time
+   * @param[out] codes one per column, only set for dictionary columns
+   * @return false if a dictionary is full or its entry could not be written
+   */
+  bool EncodeDictionaryValues(const Row &row, std::vector<uint32_t> *codes);
+
+  /**
+   * Persist a new dictionary value at the tail of the dictionary page chain
+   */
+  bool AppendDictionaryEntry(uint32_t column_index, const char *data, uint32_t len);
+
+  void LoadDictionaries();
+
+  /**
+   * @return dictionaries to decode PAX pages with, nullptr if there are none
+   */
+  inline const std::vector<ColumnDictionary> *GetDictionaries() const {
+    return dictionaries_.empty() ? nullptr : &dictionaries_;
+  }
+
+  void DetoastRow(Row *row, const std::vector<uint32_t> *fetch_columns);
+
+  /**
+   * Copy row into stored, moving long char values to overflow pages
+   * @return false if some value could not be moved, nothing is left allocated in that case
+   */
+  bool ToastRow(const Row &row, std::vector<Field> *stored, MemHeap *heap);
+
+  /**
+   * Replace a toast pointer field by the value it refers to
+   */
+  void Detoast(Field *field);
+
+  /**
+   * @return id of the first page of the chain, or INVALID_PAGE_ID if the buffer pool is exhausted
+   */
+  page_id_t WriteOverflow(const char *data, uint32_t len);
+
+  void ReadOverflow(page_id_t page_id, char *buf, uint32_t len);
+
+  /**
+   * Release the overflow chain a toast pointer refers to
+   */
+  void FreeOverflow(const char *toast_pointer);
+
+  void FreeOverflow(const Row &row);
+
+  void FreeOverflow(const RowView &view);
+
   /**
    * create table heap and initialize first page
    */
-  
+
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
                      LogManager *log_manager, LockManager *lock_manager) :
           buffer_pool_manager_(buffer_pool_manager),
+          directory_(buffer_pool_manager),
           schema_(schema),
+          zone_map_(schema),
           log_manager_(log_manager),
           lock_manager_(lock_manager) {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
-    page->Init(first_page_id_, INVALID_PAGE_ID, log_manager, txn);
+    auto page = buffer_pool_manager_->NewPage(first_page_id_);
+    directory_.AppendPage(first_page_id_, InitPage(page, first_page_id_, INVALID_PAGE_ID, txn));
+    zone_map_.AppendPage(true);
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    if (schema_->GetCodec().HasDictionaryColumns()) {
+      auto dictionary_page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(dictionary_page_id_));
+      ASSERT(dictionary_page != nullptr, "Failed to allocate dictionary page.");
+      dictionary_page->Init(dictionary_page_id_);
+      buffer_pool_manager_->UnpinPage(dictionary_page_id_, true);
+      dictionary_tail_page_id_ = dictionary_page_id_;
+      dictionaries_.resize(schema_->GetColumnCount());
+    }
   };
 
   /**
-   * load existing table heap by first_page_id
+   * load existing table heap by its directory
    */
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id,
+                     page_id_t dictionary_page_id, Schema *schema, LogManager *log_manager,
+                     LockManager *lock_manager)
       : buffer_pool_manager_(buffer_pool_manager),
-        first_page_id_(first_page_id),
+        directory_(buffer_pool_manager, directory_page_id),
         schema_(schema),
+        zone_map_(schema),
+        dictionary_page_id_(dictionary_page_id),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {ASSERT(first_page_id != INVALID_PAGE_ID, "TableHeap Failed: first_page_id can't be INVALID_PAGE_ID");}
+        lock_manager_(lock_manager) {
+    ASSERT(directory_.GetPageCount() > 0, "TableHeap Failed: table heap has no page");
+    first_page_id_ = directory_.GetPageId(0);
+    // the zone map is not persisted, pages are summarized again as scans read them
+    for (uint32_t i = 0; i < directory_.GetPageCount(); i++) {
+      zone_map_.AppendPage(false);
+    }
+    ASSERT(schema_->GetCodec().HasDictionaryColumns() == (dictionary_page_id_ != INVALID_PAGE_ID),
+           "TableHeap Failed: dictionary pages do not match the schema");
+    LoadDictionaries();
+  }
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  /** member pages in scan order, the first one is first_page_id_ */
+  TablePageDirectory directory_;
   Schema *schema_;
+  TableZoneMap zone_map_;
+  /** indexed by column, empty if no column is dictionary encoded */
+  std::vector<ColumnDictionary> dictionaries_;
+  page_id_t dictionary_page_id_{INVALID_PAGE_ID};
+  page_id_t dictionary_tail_page_id_{INVALID_PAGE_ID};
+  /** writers add dictionary values, readers decode pages */
+  ReaderWriterLatch dictionary_latch_;
+  bool compressed_{false};
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
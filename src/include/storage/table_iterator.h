@@ -1,9 +1,12 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <vector>
+
 #include "common/rowid.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
+#include "utils/mem_heap.h"
 
 
 class TableHeap;
@@ -16,6 +19,11 @@ public:
 
   explicit TableIterator(TableHeap *tableheap, RowId rid, Transaction *txn);
 
+  /**
+   * Iterate rows whose out-of-line values are fetched for fetch_columns only, see TableHeap::GetTuple
+   */
+  explicit TableIterator(TableHeap *tableheap, RowId rid, Transaction *txn, const std::vector<uint32_t> &fetch_columns);
+
   TableIterator(const TableIterator &other);
 
   virtual ~TableIterator();
@@ -32,11 +40,21 @@ public:
 
   TableIterator operator++(int);
 
+private:
+  /**
+   * Replace the current row by the tuple at rid, reusing the arena of the previous row
+   */
+  void LoadRow(RowId rid);
+
 private:
   // add your own private member variables here
-  TableHeap *tableheap_;
-  Row *row_;
-  Transaction *txn_;
+  TableHeap *tableheap_{nullptr};
+  Row *row_{nullptr};
+  Transaction *txn_{nullptr};
+  bool fetch_all_{true};
+  std::vector<uint32_t> fetch_columns_;
+  ArenaMemHeap heap_{ROW_ARENA_BLOCK_SIZE}; /** holds the current row only, rewound on every step */
+  static constexpr size_t ROW_ARENA_BLOCK_SIZE = PAGE_SIZE;
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
@@ -0,0 +1,77 @@
+#ifndef MINISQL_TABLE_PAGE_DIRECTORY_H
+#define MINISQL_TABLE_PAGE_DIRECTORY_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/table_directory_page.h"
+
+/**
+ * TablePageDirectory lists the pages of one table heap in scan order, persisted in a chain of
+ * TableDirectoryPage. Page ids are cached in memory when the directory is opened, so counting and
+ * addressing the pages never walks the heap itself. Fill levels stay on the directory pages.
+ */
+class TablePageDirectory {
+public:
+  /** [begin, end) indexes into the directory */
+  using PageRange = std::pair<uint32_t, uint32_t>;
+
+  /**
+   * create an empty directory
+   */
+  explicit TablePageDirectory(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * load an existing directory by its first page
+   */
+  explicit TablePageDirectory(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id);
+
+  inline page_id_t GetDirectoryPageId() const { return directory_pages_.front(); }
+
+  inline uint32_t GetPageCount() const { return static_cast<uint32_t>(pages_.size()); }
+
+  /**
+   * @return id of the index-th page of the heap, in scan order
+   */
+  inline page_id_t GetPageId(uint32_t index) const { return pages_[index]; }
+
+  /**
+   * @return index of page_id in the directory, or -1 if the page is not a member
+   */
+  int GetPageIndex(page_id_t page_id) const;
+
+  uint32_t GetFreeSpace(uint32_t index);
+
+  void SetFreeSpace(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Add a page after the current last one
+   * @return false if no directory page could be allocated
+   */
+  bool AppendPage(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * @return index of the first page with at least free_space bytes left, or -1
+   */
+  int FindFreePage(uint32_t free_space);
+
+  /**
+   * Split the pages into at most k contiguous, non-empty ranges of near-equal size
+   */
+  std::vector<PageRange> Partition(uint32_t k) const;
+
+  /**
+   * Release the directory pages, the heap pages they list are left alone
+   */
+  void FreeDirectory();
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  std::vector<page_id_t> directory_pages_;
+  std::vector<page_id_t> pages_;
+  std::unordered_map<page_id_t, uint32_t> page_index_;
+};
+
+#endif  // MINISQL_TABLE_PAGE_DIRECTORY_H
@@ -0,0 +1,90 @@
+#ifndef MINISQL_TABLE_ZONE_MAP_H
+#define MINISQL_TABLE_ZONE_MAP_H
+
+#include <mutex>
+#include <vector>
+
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Comparisons a zone map can rule out, `column op value`
+ */
+enum class ZoneOp { kEq, kNe, kLt, kLe, kGt, kGe, kIsNull, kNotNull };
+
+/**
+ * Zone map of a table heap: min, max and null count of every int and float column, per heap page.
+ *
+ * Summaries are conservative. Inserts and updates only widen them and deletes leave them alone, so a
+ * summary may cover values that are gone but never misses a live one. A page is summarized when it
+ * is created or read in full by a scan; until then, e.g. after the heap was reopened, it is never
+ * skipped. Page indexes are those of the heap's directory.
+ */
+class TableZoneMap {
+public:
+  explicit TableZoneMap(Schema *schema);
+
+  /**
+   * Add the summary of the next page of the heap
+   * @param summarized true for a new empty page, false for a page with unknown content
+   */
+  void AppendPage(bool summarized);
+
+  /**
+   * Take a new value of a row on the page into its summary
+   */
+  void Widen(uint32_t page_index, const Row &row);
+
+  /**
+   * @return version to pass to Summarize, read it before reading the page
+   */
+  uint64_t GetVersion(uint32_t page_index) const;
+
+  /**
+   * Rebuild the summary of a page from all of its live rows. Ignored if the page was widened since
+   * version was taken, the rows may miss that insert.
+   * @param rows the rows of the page, every tracked column must have been fetched
+   */
+  void Summarize(uint32_t page_index, uint64_t version, const Row *rows, size_t row_count);
+
+  /**
+   * @return true if the column has a zone map, i.e. it is an int or float column
+   */
+  bool IsTracked(uint32_t column_index) const;
+
+  /**
+   * @return false if no row of the page can satisfy `column op value`
+   */
+  bool MayMatch(uint32_t page_index, uint32_t column_index, ZoneOp op, double value) const;
+
+  /**
+   * Convert a non-null int or float field to the representation the summaries compare in
+   */
+  static double ToZoneValue(const Field &field);
+
+private:
+  struct ColumnZone {
+    double min_;
+    double max_;
+    uint32_t null_count_;
+    /** false while no non-null value was seen */
+    bool has_value_;
+  };
+
+  void Clear(uint32_t page_index);
+
+  void WidenUnlocked(uint32_t page_index, const Row &row);
+
+private:
+  /** column index to the position among tracked columns, -1 if the column is not tracked */
+  std::vector<int> tracked_;
+  std::vector<uint32_t> tracked_columns_;
+  std::vector<TypeId> tracked_types_;
+  /** tracked_columns_.size() zones per page */
+  std::vector<ColumnZone> zones_;
+  std::vector<bool> summarized_;
+  std::vector<uint64_t> versions_;
+  mutable std::mutex latch_;
+};
+
+#endif  // MINISQL_TABLE_ZONE_MAP_H
@@ -0,0 +1,150 @@
+#ifndef MINISQL_EXTERNAL_SORTER_H
+#define MINISQL_EXTERNAL_SORTER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * Sort of fixed-size entries that may not fit in memory, e.g. the (key, row id) pairs of an index build.
+ *
+ * Entries are gathered in memory up to memory_limit bytes. A full buffer is sorted and spilled as a run to
+ * an anonymous temporary file, which goes away when it is closed. Next then merges the runs with a heap of
+ * their heads, reading each run sequentially in blocks, so a sort of any size is a write and a read of every
+ * entry. Entries are written as raw bytes and must not hold pointers.
+ */
+template<typename Entry, typename Less>
+class ExternalSorter {
+public:
+  explicit ExternalSorter(Less less, size_t memory_limit = DEFAULT_MEMORY_LIMIT)
+          : less_(less), capacity_(std::max<size_t>(memory_limit / sizeof(Entry), MIN_BLOCK_ENTRIES)) {}
+
+  DISALLOW_COPY(ExternalSorter);
+
+  ~ExternalSorter() {
+    for (auto &run : runs_) {
+      fclose(run.file_);
+    }
+  }
+
+  void Add(const Entry &entry) {
+    ASSERT(!finished_, "Entries added after Finish.");
+    if (buffer_.size() == capacity_) {
+      Spill();
+    }
+    buffer_.push_back(entry);
+    count_++;
+  }
+
+  /**
+   * Sort the entries still in memory and prepare the merge, Next may be called afterwards
+   */
+  void Finish() {
+    ASSERT(!finished_, "Finish called twice.");
+    finished_ = true;
+    if (runs_.empty()) {
+      std::sort(buffer_.begin(), buffer_.end(), less_);
+      return;
+    }
+    if (!buffer_.empty()) {
+      Spill();
+    }
+    std::vector<Entry>().swap(buffer_);
+    // the memory limit is shared by the read blocks of all runs
+    size_t block_entries = std::max<size_t>(capacity_ / runs_.size(), MIN_BLOCK_ENTRIES);
+    for (size_t i = 0; i < runs_.size(); i++) {
+      rewind(runs_[i].file_);
+      runs_[i].block_.resize(block_entries);
+      if (Refill(runs_[i])) {
+        heads_.push(i);
+      }
+    }
+  }
+
+  /**
+   * @return false once every entry was returned, entries come in ascending order
+   */
+  bool Next(Entry *entry) {
+    ASSERT(finished_, "Next called before Finish.");
+    if (runs_.empty()) {
+      if (next_ == buffer_.size()) {
+        return false;
+      }
+      *entry = buffer_[next_++];
+      return true;
+    }
+    if (heads_.empty()) {
+      return false;
+    }
+    size_t i = heads_.top();
+    heads_.pop();
+    Run &run = runs_[i];
+    *entry = run.block_[run.pos_++];
+    if (run.pos_ < run.size_ || Refill(run)) {
+      heads_.push(i);
+    }
+    return true;
+  }
+
+  inline uint64_t GetCount() const { return count_; }
+
+  /**
+   * @return number of runs spilled to disk, 0 if the entries were sorted in memory
+   */
+  inline size_t GetRunCount() const { return runs_.size(); }
+
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 << 20;
+
+private:
+  struct Run {
+    FILE *file_;
+    std::vector<Entry> block_;
+    size_t pos_{0};
+    size_t size_{0};
+  };
+
+  /**
+   * Orders run indexes by their head entry, the smallest on top
+   */
+  struct HeadGreater {
+    const ExternalSorter *sorter_;
+
+    bool operator()(size_t a, size_t b) const {
+      const Run &run_a = sorter_->runs_[a];
+      const Run &run_b = sorter_->runs_[b];
+      return sorter_->less_(run_b.block_[run_b.pos_], run_a.block_[run_a.pos_]);
+    }
+  };
+
+  void Spill() {
+    std::sort(buffer_.begin(), buffer_.end(), less_);
+    FILE *file = tmpfile();
+    ASSERT(file != nullptr, "Failed to create a temporary file.");
+    size_t written = fwrite(buffer_.data(), sizeof(Entry), buffer_.size(), file);
+    ASSERT(written == buffer_.size(), "Failed to write a sorted run.");
+    runs_.push_back(Run{file});
+    buffer_.clear();
+  }
+
+  bool Refill(Run &run) {
+    run.size_ = fread(run.block_.data(), sizeof(Entry), run.block_.size(), run.file_);
+    run.pos_ = 0;
+    return run.size_ > 0;
+  }
+
+  static constexpr size_t MIN_BLOCK_ENTRIES = 1024;
+
+  Less less_;
+  size_t capacity_;
+  std::vector<Entry> buffer_;
+  size_t next_{0};
+  std::vector<Run> runs_;
+  std::priority_queue<size_t, std::vector<size_t>, HeadGreater> heads_{HeadGreater{this}};
+  uint64_t count_{0};
+  bool finished_{false};
+};
+
+#endif  // MINISQL_EXTERNAL_SORTER_H
@@ -1,9 +1,11 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_set>
+#include <vector>
 #include "common/macros.h"
 
 class MemHeap {
@@ -54,4 +56,84 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * ArenaMemHeap is a bump-pointer allocator over a list of fixed-size blocks.
+ *
+ * Free is a no-op, memory is given back all at once by Reset() or the destructor. Reset() only
+ * rewinds to the first block and keeps the blocks for reuse, so a heap that is reset once per
+ * statement (or per row) stops calling malloc after warming up. Requests larger than a quarter
+ * block get a dedicated allocation which is released on Reset().
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  explicit ArenaMemHeap(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~ArenaMemHeap() override {
+    ReleaseLargeBlocks();
+    for (auto block : blocks_) {
+      free(block);
+    }
+  }
+
+  void *Allocate(size_t size) override {
+    // zero-sized requests still get a distinct non-null address
+    size = ((size == 0 ? 1 : size) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > block_size_ / 4) {
+      void *buf = malloc(size);
+      ASSERT(buf != nullptr, "Out of memory exception");
+      large_blocks_.push_back(buf);
+      return buf;
+    }
+    if (cur_ + size > end_) {
+      NextBlock();
+    }
+    void *buf = cur_;
+    cur_ += size;
+    return buf;
+  }
+
+  void Free(void *ptr) override {}
+
+  /**
+   * Drop everything allocated so far, the caller must have destroyed the objects living here
+   */
+  void Reset() {
+    ReleaseLargeBlocks();
+    next_block_ = 0;
+    cur_ = end_ = nullptr;
+  }
+
+  inline size_t GetBlockCount() const { return blocks_.size(); }
+
+  DISALLOW_COPY(ArenaMemHeap);
+
+private:
+  void NextBlock() {
+    if (next_block_ == blocks_.size()) {
+      void *block = malloc(block_size_);
+      ASSERT(block != nullptr, "Out of memory exception");
+      blocks_.push_back(block);
+    }
+    cur_ = reinterpret_cast<char *>(blocks_[next_block_++]);
+    end_ = cur_ + block_size_;
+  }
+
+  void ReleaseLargeBlocks() {
+    for (auto block : large_blocks_) {
+      free(block);
+    }
+    large_blocks_.clear();
+  }
+
+private:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+  static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+  size_t block_size_;
+  std::vector<void *> blocks_;
+  std::vector<void *> large_blocks_;
+  size_t next_block_{0};
+  char *cur_{nullptr};
+  char *end_{nullptr};
+};
+
 #endif //MINISQL_MEM_HEAP_H
@@ -1,8 +1,11 @@
 #include "index/b_plus_tree.h"
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include "glog/logging.h"
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
 #include "page/index_roots_page.h"
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -23,12 +26,39 @@ BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_ma
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy() {
-  while(!this->IsEmpty()){
-    KeyType key;
-    auto *leaf_page = FindLeafPage(key,true);
-    auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-    this->Remove(leaf->KeyAt(0),nullptr);
+  root_latch_.WLock();
+  if (IsEmpty()) {
+    root_latch_.WUnlock();
+    return;
+  }
+  // collect the pages level by level, the tree is balanced so a level of leaves is never read
+  std::vector<page_id_t> page_ids;
+  std::vector<page_id_t> level{root_page_id_};
+  while (!level.empty()) {
+    page_ids.insert(page_ids.end(), level.begin(), level.end());
+    auto *first = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(level[0])->GetData());
+    bool leaf_level = first->IsLeafPage();
+    buffer_pool_manager_->UnpinPage(level[0], false);
+    if (leaf_level) break;
+    std::vector<page_id_t> children;
+    for (auto page_id : level) {
+      auto *internal = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+      for (int i = 0; i < internal->GetSize(); i++) {
+        children.push_back(internal->ValueAt(i));
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    level = std::move(children);
+  }
+  buffer_pool_manager_->DeletePages(page_ids);
+  root_page_id_ = INVALID_PAGE_ID;
+  rightmost_leaf_id_.store(INVALID_PAGE_ID, std::memory_order_relaxed);
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page != nullptr) {
+    reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
   }
+  root_latch_.WUnlock();
 }
 
 /*
@@ -52,20 +82,89 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
-  if (IsEmpty()) return false;
-
-  auto *leaf_page = FindLeafPage(key, false);
-  if (leaf_page != NULL) {
+  root_latch_.RLock();
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kNone, LeafLatch::kRead);
+  bool found = false;
+  if (leaf_page != nullptr) {
     ValueType tmp;
     auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-    if (leaf->Lookup(key, tmp, comparator_)) {
+    found = leaf->Lookup(key, tmp, comparator_);
+    if (found) {
       result.push_back(tmp);
-      buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-      return true;
     }
+    leaf_page->RUnlatch();
     buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
   }
-  return false;
+  root_latch_.RUnlock();
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<ValueType> &values,
+                                 std::vector<bool> &found) {
+  values.assign(keys.size(), ValueType{});
+  found.assign(keys.size(), false);
+  std::vector<uint32_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return comparator_(keys[a], keys[b]) < 0; });
+  // a page of the current level with the run of sorted probes that goes through it, the runs of a level
+  // follow each other in key order and all leaves are on the same level
+  struct Visit {
+    page_id_t page_id_;
+    size_t begin_;
+    size_t end_;
+  };
+  std::vector<Visit> level;
+  std::vector<Visit> next_level;
+  std::vector<Page *> pages;
+  size_t hits = 0;
+  root_latch_.RLock();
+  if (!IsEmpty() && !keys.empty()) {
+    level.push_back({root_page_id_, 0, order.size()});
+  }
+  // internal pages only change under root_latch_ held exclusive, so no latch is coupled across levels
+  while (!level.empty()) {
+    pages.assign(level.size(), nullptr);
+    next_level.clear();
+    size_t fetched = 0;
+    for (size_t i = 0; i < level.size(); i++) {
+      for (; fetched < level.size() && fetched <= i + PROBE_PREFETCH_DISTANCE; fetched++) {
+        pages[fetched] = buffer_pool_manager_->FetchPage(level[fetched].page_id_);
+        // the header and the middle entry, where the search of the page starts
+        __builtin_prefetch(pages[fetched]->GetData());
+        __builtin_prefetch(pages[fetched]->GetData() + PAGE_SIZE / 2);
+      }
+      Page *page = pages[i];
+      const Visit &visit = level[i];
+      page->RLatch();
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        auto *leaf = reinterpret_cast<LeafPage *>(node);
+        for (size_t j = visit.begin_; j < visit.end_; j++) {
+          uint32_t probe = order[j];
+          if (leaf->Lookup(keys[probe], values[probe], comparator_)) {
+            found[probe] = true;
+            hits++;
+          }
+        }
+      } else {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        for (size_t j = visit.begin_; j < visit.end_; j++) {
+          page_id_t child_id = internal->Lookup(keys[order[j]], comparator_);
+          if (next_level.empty() || next_level.back().page_id_ != child_id) {
+            next_level.push_back({child_id, j, j + 1});
+          } else {
+            next_level.back().end_ = j + 1;
+          }
+        }
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(visit.page_id_, false);
+    }
+    level.swap(next_level);
+  }
+  root_latch_.RUnlock();
+  return hits;
 }
 
 /*****************************************************************************
@@ -80,16 +179,217 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  bool inserted;
+  root_latch_.RLock();
+  bool done = AppendToRightmostLeaf(key, value, &inserted) || OptimisticInsert(key, value, &inserted);
+  root_latch_.RUnlock();
+  if (done) {
+    return inserted;
+  }
+  // the leaf splits or the tree starts, with the tree to ourselves the leaf is looked up again
+  root_latch_.WLock();
   if (!IsEmpty()) {
-    if (InsertIntoLeaf(key, value))
-      return true;
-    else
-      return false;
+    inserted = InsertIntoLeaf(key, value);
   } else {
     StartNewTree(key, value);
+    inserted = true;
+  }
+  root_latch_.WUnlock();
+  return inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::AppendToRightmostLeaf(const KeyType &key, const ValueType &value, bool *inserted) {
+  page_id_t page_id = rightmost_leaf_id_.load(std::memory_order_relaxed);
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  page->WLatch();
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  // a key above the largest one is new, and Insert puts it at the end without a search
+  *inserted = leaf->IsLeafPage() && leaf->GetNextPageId() == INVALID_PAGE_ID && leaf->GetSize() > 0 &&
+              leaf->GetSize() < leaf->GetMaxSize() && comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) > 0;
+  if (*inserted) {
+    leaf->Insert(key, value, comparator_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, *inserted);
+  return *inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticInsert(const KeyType &key, const ValueType &value, bool *inserted) {
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kNone, LeafLatch::kWrite);
+  if (leaf_page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+    rightmost_leaf_id_.store(leaf_page->GetPageId(), std::memory_order_relaxed);
+  }
+  ValueType tmp;
+  bool duplicate = leaf->Lookup(key, tmp, comparator_);
+  bool done = duplicate || leaf->GetSize() < leaf->GetMaxSize();
+  *inserted = done && !duplicate;
+  if (*inserted) {
+    leaf->Insert(key, value, comparator_);
+  }
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), *inserted);
+  return done;
+}
+namespace {
+
+/**
+ * Entries of the index-th of nodes pages that share entries evenly
+ */
+inline int BulkNodeSize(uint64_t entries, uint64_t nodes, uint64_t index) {
+  return static_cast<int>(entries / nodes + (index < entries % nodes ? 1 : 0));
+}
+
+/**
+ * Pages needed for entries at fill_factor of max_size each, and no fewer than min_entries each
+ */
+inline uint64_t BulkNodeNums(uint64_t entries, int max_size, double fill_factor, int min_entries) {
+  auto per_node = static_cast<uint64_t>(std::max(min_entries, static_cast<int>(max_size * fill_factor)));
+  return std::max<uint64_t>(1, (entries + per_node - 1) / per_node);
+}
+
+}  // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::function<bool(MappingType *)> &next, uint64_t count, double fill_factor) {
+  root_latch_.WLock();
+  bool loaded = IsEmpty() && BulkLoadEmpty(next, count, fill_factor);
+  root_latch_.WUnlock();
+  return loaded;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoadEmpty(const std::function<bool(MappingType *)> &next, uint64_t count,
+                                   double fill_factor) {
+  if (count == 0) {
+    return true;
+  }
+  fill_factor = std::min(1.0, std::max(0.5, fill_factor));
+  // plan every level up front, the level with a single page is the root
+  uint64_t leaf_nums = BulkNodeNums(count, leaf_max_size_, fill_factor, 1);
+  std::vector<BulkLevel> levels;
+  for (uint64_t entries = leaf_nums; entries > 1;) {
+    BulkLevel level;
+    level.entry_nums_ = entries;
+    // with three children or more per page an even share never leaves a page with a single child
+    level.node_nums_ = BulkNodeNums(entries, internal_max_size_, fill_factor, std::min(3, internal_max_size_));
+    levels.push_back(level);
+    entries = level.node_nums_;
+  }
+  // levels[0] is unused so that levels[i] is i levels above the leaves
+  levels.insert(levels.begin(), BulkLevel());
+
+  std::vector<MappingType> items(leaf_max_size_);
+  MappingType pending;
+  bool has_next = next(&pending);
+  if (!has_next) {
     return true;
   }
+  LeafPage *leaf = nullptr;
+  page_id_t page_id;
+  for (uint64_t i = 0; has_next; i++) {
+    ASSERT(i < leaf_nums, "More bulk load entries than counted.");
+    if (leaf == nullptr) {
+      leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(page_id)->GetData());
+      leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    }
+    int target_size = BulkNodeSize(count, leaf_nums, i);
+    int size = 0;
+    for (; has_next && size < target_size; size++) {
+      items[size] = pending;
+      has_next = next(&pending);
+    }
+    leaf->CopyNFrom(items.data(), size);
+    LeafPage *next_leaf = nullptr;
+    if (has_next) {
+      // the next leaf is allocated first to link to it
+      next_leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(page_id)->GetData());
+      next_leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      leaf->SetNextPageId(page_id);
+    }
+    if (next_leaf == nullptr) {
+      rightmost_leaf_id_.store(leaf->GetPageId(), std::memory_order_relaxed);
+    }
+    if (levels.size() > 1) {
+      BulkAppendChild(levels, 1, leaf->KeyAt(0), leaf);
+    } else {
+      root_page_id_ = leaf->GetPageId();
+    }
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+    leaf = next_leaf;
+  }
+  // with fewer entries than counted the pages on the right edge are complete as they are
+  for (size_t level = 1; level < levels.size(); level++) {
+    InternalPage *page = levels[level].page_;
+    if (page == nullptr) {
+      continue;
+    }
+    levels[level].page_ = nullptr;
+    if (level + 1 < levels.size()) {
+      BulkAppendChild(levels, level + 1, page->KeyAt(0), page);
+    } else {
+      root_page_id_ = page->GetPageId();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  // which may leave roots of a single child
+  while (true) {
+    auto *root = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
+    if (root->IsLeafPage() || root->GetSize() > 1) {
+      buffer_pool_manager_->UnpinPage(root_page_id_, false);
+      break;
+    }
+    page_id_t child_id = reinterpret_cast<InternalPage *>(root)->ValueAt(0);
+    buffer_pool_manager_->UnpinPage(root_page_id_, false);
+    buffer_pool_manager_->DeletePage(root_page_id_);
+    root_page_id_ = child_id;
+    auto *child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(child_id)->GetData());
+    child->SetParentPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(child_id, true);
+  }
+  UpdateRootPageId(true);
+  return true;
 }
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkAppendChild(std::vector<BulkLevel> &levels, size_t level, const KeyType &key,
+                                     BPlusTreePage *child) {
+  BulkLevel &open = levels[level];
+  if (open.page_ == nullptr) {
+    page_id_t page_id;
+    open.page_ = reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(page_id)->GetData());
+    open.page_->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    // Init counts the invalid first key, which is filled here like any other
+    open.page_->SetSize(0);
+    open.target_size_ = BulkNodeSize(open.entry_nums_, open.node_nums_, open.next_node_++);
+  }
+  InternalPage *page = open.page_;
+  // the key of the first child is never read but kept as the key of the page for the level above
+  int index = page->GetSize();
+  page->SetSize(index + 1);
+  page->SetKeyAt(index, key);
+  page->SetValueAt(index, child->GetPageId());
+  child->SetParentPageId(page->GetPageId());
+  if (page->GetSize() < open.target_size_) {
+    return;
+  }
+  open.page_ = nullptr;
+  if (level + 1 < levels.size()) {
+    BulkAppendChild(levels, level + 1, page->KeyAt(0), page);
+  } else {
+    root_page_id_ = page->GetPageId();
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -103,6 +403,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   UpdateRootPageId(true);
   root->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
   root->Insert(key, value, comparator_);
+  rightmost_leaf_id_.store(root_page_id_, std::memory_order_relaxed);
 
   buffer_pool_manager_->UnpinPage(root->GetPageId(), true);
 }
@@ -117,7 +418,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  auto *leaf_page = FindLeafPage(key);
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kNone, LeafLatch::kNone);
   ValueType tmp;
   if (leaf_page == nullptr)  //没有复合插入条件的叶节点
     return false;
@@ -132,6 +433,18 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
         leaf->Insert(key, value, comparator_);
         buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
         return true;
+      } else if (leaf->GetNextPageId() == INVALID_PAGE_ID &&
+                 comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) > 0) {
+        // appends to the right edge leave the full leaf as it is and start an empty one, so that
+        // increasing keys fill their pages instead of leaving each of them half full
+        page_id_t new_id;
+        auto *new_leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(new_id)->GetData());
+        ASSERT(new_leaf != nullptr, "No free page!");
+        new_leaf->Init(new_id, leaf->GetParentPageId(), leaf_max_size_);
+        new_leaf->Insert(key, value, comparator_);
+        leaf->SetNextPageId(new_id);
+        rightmost_leaf_id_.store(new_id, std::memory_order_relaxed);
+        InsertIntoParent(leaf, key, new_leaf);
       } else {  //若结点已满，分裂出一个新节点
         auto *new_leaf = Split(leaf);
         //根据新叶节点的首元素和待插入元素的大小关系，决定要插入哪一个叶节点
@@ -142,6 +455,9 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
         //新的叶结点中含有原叶节点的后一半元素，因此按如下方式更新两个节点的信息
         new_leaf->SetNextPageId(leaf->GetNextPageId());
         leaf->SetNextPageId(new_leaf->GetPageId());
+        if (new_leaf->GetNextPageId() == INVALID_PAGE_ID) {
+          rightmost_leaf_id_.store(new_leaf->GetPageId(), std::memory_order_relaxed);
+        }
 
         //将分裂键递归上移
         InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf);
@@ -305,11 +621,21 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  root_latch_.RLock();
+  bool done = OptimisticRemove(key);
+  root_latch_.RUnlock();
+  if (done) {
+    return;
+  }
+  // the parent or the siblings of the leaf change, with the tree to ourselves the leaf is looked up again
+  root_latch_.WLock();
+  // the rightmost leaf may merge away, the next insert that reaches the right edge finds it again
+  rightmost_leaf_id_.store(INVALID_PAGE_ID, std::memory_order_relaxed);
   if (IsEmpty()) {
+    root_latch_.WUnlock();
     return;
   }
-
-  auto *leaf_page = FindLeafPage(key, false);
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kNone, LeafLatch::kNone);
   auto *leaf = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(leaf_page->GetData());
   int tmp = leaf->GetSize();
   if (leaf->RemoveAndDeleteRecord(key, comparator_) < tmp) {
@@ -329,9 +655,31 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     }
     CoalesceOrRedistribute(leaf);
     buffer_pool_manager_->UnpinPage(leaf->GetPageId(),true);
+    root_latch_.WUnlock();
     return;
   }  //叶节点中存在该key值
   buffer_pool_manager_->UnpinPage(leaf->GetPageId(),false);
+  root_latch_.WUnlock();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::OptimisticRemove(const KeyType &key) {
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kNone, LeafLatch::kWrite);
+  if (leaf_page == nullptr) {
+    return true;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  // the parent keeps the first key of the leaf, a root leaf that empties drops the tree
+  bool done = !found || (leaf->IsRootPage() ? leaf->GetSize() > 1
+                                             : index > 0 && leaf->GetSize() > leaf->GetMinSize());
+  if (found && done) {
+    leaf->RemoveAndDeleteRecord(key, comparator_);
+  }
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), found && done);
+  return done;
 }
 
 /*
@@ -557,6 +905,122 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
   return IndexIterator<KeyType, ValueType, KeyComparator>(leaf, 0, buffer_pool_manager_,0);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetMinKey(KeyType &key, const KeyType *from) {
+  root_latch_.RLock();
+  auto *leaf_page = DescendToLeaf(from == nullptr ? key : *from,
+                                  from == nullptr ? LeafEdge::kLeftmost : LeafEdge::kNone, LeafLatch::kRead);
+  bool found = false;
+  if (leaf_page != nullptr) {
+    auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    int index = from == nullptr ? 0 : leaf->KeyIndex(*from, comparator_);
+    // every key of the leaf is smaller than from, the next leaf starts past it
+    while (index == leaf->GetSize() && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+      auto *next_page = buffer_pool_manager_->FetchPage(leaf->GetNextPageId());
+      next_page->RLatch();
+      leaf_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+      leaf_page = next_page;
+      leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+      index = 0;
+    }
+    found = index < leaf->GetSize();
+    if (found) {
+      key = leaf->KeyAt(index);
+    }
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+  root_latch_.RUnlock();
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetMaxKey(KeyType &key) {
+  root_latch_.RLock();
+  auto *leaf_page = DescendToLeaf(key, LeafEdge::kRightmost, LeafLatch::kRead);
+  bool found = false;
+  if (leaf_page != nullptr) {
+    auto leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    found = leaf->GetSize() > 0;
+    if (found) {
+      key = leaf->KeyAt(leaf->GetSize() - 1);
+    }
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+  root_latch_.RUnlock();
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+                               uint64_t limit, const std::function<bool(const std::vector<ValueType> &)> &consume) {
+  std::vector<ValueType> batch;
+  KeyType from{};
+  bool has_from = lo != nullptr;
+  if (has_from) {
+    from = *lo;
+  }
+  bool from_inclusive = lo_inclusive;
+  uint64_t count = 0;
+  while (limit == 0 || count < limit) {
+    root_latch_.RLock();
+    auto *page = DescendToLeaf(from, has_from ? LeafEdge::kNone : LeafEdge::kLeftmost, LeafLatch::kRead);
+    if (page == nullptr) {
+      root_latch_.RUnlock();
+      return;
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    auto begin_of = [&](LeafPage *node) {
+      if (!has_from) {
+        return 0;
+      }
+      return from_inclusive ? node->KeyIndex(from, comparator_) : node->UpperKeyIndex(from, comparator_);
+    };
+    int begin = begin_of(leaf);
+    // resuming past the last key of a leaf lands on that leaf, the range goes on in the next one
+    while (begin == leaf->GetSize() && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+      auto *next_page = buffer_pool_manager_->FetchPage(leaf->GetNextPageId());
+      next_page->RLatch();
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = next_page;
+      leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      begin = begin_of(leaf);
+    }
+    int end = leaf->GetSize();
+    bool last = leaf->GetNextPageId() == INVALID_PAGE_ID;
+    if (hi != nullptr) {
+      int bound = hi_inclusive ? leaf->UpperKeyIndex(*hi, comparator_) : leaf->KeyIndex(*hi, comparator_);
+      if (bound < end) {
+        end = std::max(bound, begin);
+        last = true;
+      }
+    }
+    if (limit != 0 && static_cast<uint64_t>(end - begin) >= limit - count) {
+      end = begin + static_cast<int>(limit - count);
+      last = true;
+    }
+    batch.clear();
+    for (int i = begin; i < end; i++) {
+      batch.push_back(leaf->GetItem(i).second);
+    }
+    if (end > begin) {
+      from = leaf->KeyAt(end - 1);
+      has_from = true;
+      from_inclusive = false;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    root_latch_.RUnlock();
+    count += batch.size();
+    if ((!batch.empty() && !consume(batch)) || last) {
+      return;
+    }
+  }
+}
+
 /*
  * Input parameter is low key, find the leaf page that contains the input key
  * first, then construct index iterator
@@ -564,17 +1028,18 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  int flag;
   auto *leaf_page = FindLeafPage(key, false);
   auto leaf = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(leaf_page->GetData());
   int index = leaf->KeyIndex(key, comparator_);
-  if(comparator_(leaf->KeyAt(index),key) == 0) flag = 1;
-  else flag = 0;
-  if(index == leaf->GetSize()){
-    return ++IndexIterator<KeyType, ValueType, KeyComparator>(leaf, index, buffer_pool_manager_,flag);
-  }else{
-    return IndexIterator<KeyType,ValueType,KeyComparator>(leaf,index,buffer_pool_manager_,flag);
+  if (index == leaf->GetSize() && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+    // every key of the leaf is smaller, the first one of the next leaf is not
+    page_id_t next_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_id)->GetData());
+    index = 0;
   }
+  int flag = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0 ? 1 : 0;
+  return IndexIterator<KeyType, ValueType, KeyComparator>(leaf, index, buffer_pool_manager_, flag);
 }
 
 /*
@@ -584,17 +1049,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
-  auto *internal = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto page = reinterpret_cast<BPlusTreePage *>(internal->GetData());
-  while (!page->IsLeafPage()) {
-    auto node = reinterpret_cast<InternalPage *>(page);
-
-    internal = buffer_pool_manager_->FetchPage(node->ValueAt(node->GetSize() - 1));
-    page = reinterpret_cast<BPlusTreePage *>(internal->GetData());
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-  }
-
-  auto node = reinterpret_cast<LeafPage *>(page);
+  auto node = reinterpret_cast<LeafPage *>(FindEdgeLeafPage(true)->GetData());
   return IndexIterator<KeyType, ValueType, KeyComparator>(node, node->GetSize(), buffer_pool_manager_,0);
 }
 
@@ -608,32 +1063,58 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  // TODO:
-  if (IsEmpty()) return nullptr;
-
-  auto *cur_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  if (cur_page != NULL) {
-    auto *cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());
-    while (!cur_node->IsLeafPage()) {
-      auto cur_inter = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(cur_node);
-      page_id_t child_id;
-      if (leftMost)  //找到子结点
-        child_id = cur_inter->ValueAt(0);
-      else
-        child_id = cur_inter->Lookup(key, comparator_);
-
-      buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);  //释放父节点
+  root_latch_.RLock();
+  auto *page = DescendToLeaf(key, leftMost ? LeafEdge::kLeftmost : LeafEdge::kNone, LeafLatch::kNone);
+  root_latch_.RUnlock();
+  return page;
+}
 
-      cur_page = buffer_pool_manager_->FetchPage(child_id);  //下移至子节点
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindEdgeLeafPage(bool rightmost) {
+  KeyType tmp;
+  root_latch_.RLock();
+  auto *page = DescendToLeaf(tmp, rightmost ? LeafEdge::kRightmost : LeafEdge::kLeftmost, LeafLatch::kNone);
+  root_latch_.RUnlock();
+  return page;
+}
 
-      cur_node = reinterpret_cast<BPlusTreePage *>(cur_page->GetData());
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::DescendToLeaf(const KeyType &key, LeafEdge edge, LeafLatch latch) {
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  // pages do not change type under root_latch_, so the type picks the latch before the page is read
+  auto latch_page = [latch](Page *page) {
+    if (latch == LeafLatch::kNone) {
+      return;
     }
-
-    buffer_pool_manager_->UnpinPage(cur_page->GetPageId(),false);
-    return cur_page;
+    if (latch == LeafLatch::kWrite && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+  };
+  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  latch_page(page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id;
+    if (edge == LeafEdge::kNone) {
+      child_id = internal->Lookup(key, comparator_);
+    } else {
+      child_id = internal->ValueAt(edge == LeafEdge::kRightmost ? internal->GetSize() - 1 : 0);
+    }
+    auto *child = buffer_pool_manager_->FetchPage(child_id);
+    latch_page(child);
+    if (latch != LeafLatch::kNone) {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   }
-
-  return nullptr;
+  return page;
 }
 
 /*
@@ -649,9 +1130,10 @@ void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
   if (page != nullptr) {
     auto *header = reinterpret_cast<IndexRootsPage *>(page->GetData());
-    if (insert_record) {
-      header->Insert(index_id_, root_page_id_);
-    } else {
+    // the record of an emptied tree is kept, it is updated when the tree starts again
+    if (insert_record && !header->Insert(index_id_, root_page_id_)) {
+      header->Update(index_id_, root_page_id_);
+    } else if (!insert_record) {
       header->Update(index_id_, root_page_id_);
     }
 
@@ -796,3 +1278,7 @@ template class BPlusTree<GenericKey<16>, RowId, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template class BPlusTree<NativeKey<int32_t>, RowId, NativeComparator<int32_t>>;
+
+template class BPlusTree<NativeKey<float>, RowId, NativeComparator<float>>;
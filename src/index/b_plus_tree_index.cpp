@@ -1,20 +1,50 @@
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "utils/external_sorter.h"
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
-                                     BufferPoolManager *buffer_pool_manager)
+                                     BufferPoolManager *buffer_pool_manager, bool unique)
         : Index(index_id, key_schema),
+          unique_(unique),
           comparator_(key_schema_),
           container_(index_id, buffer_pool_manager, comparator_) {
+  ASSERT(unique_ || HoldsRowId<KeyType>::value, "Non-unique indexes need keys that hold a row id.");
+  if constexpr (IsCodecKey<KeyType>::value) {
+    keys_fit_ = KeyCodec::GetMaxEncodedSize(key_schema_) + (unique_ ? 0 : KeyType::ROW_ID_SIZE) <= sizeof(KeyType);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::KeyFits(const Row &key) const {
+  if constexpr (IsCodecKey<KeyType>::value) {
+    if (!keys_fit_) {
+      return KeyCodec::GetEncodedSize(key, key_schema_) + (unique_ ? 0 : KeyType::ROW_ID_SIZE) <= sizeof(KeyType);
+    }
+  }
+  return true;
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t BPLUSTREE_INDEX_TYPE::SerializeKey(const Row &key, RowId row_id, KeyType *index_key) const {
+  if constexpr (HoldsRowId<KeyType>::value) {
+    if (!unique_) {
+      return index_key->SerializeFromKey(key, row_id, key_schema_);
+    }
+  }
+  index_key->SerializeFromKey(key, key_schema_);
+  return 0;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  if (!KeyFits(key)) {
+    return DB_KEY_TOO_LARGE;
+  }
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  SerializeKey(key, row_id, &index_key);
 
   bool status = container_.Insert(index_key, row_id, txn);
 
@@ -26,8 +56,11 @@ dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transact
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key,RowId row_id,Transaction *txn) {
+  if (!KeyFits(key)) {
+    return DB_KEY_NOT_FOUND;
+  }
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  SerializeKey(key, row_id, &index_key);
 
   container_.Remove(index_key, txn);
   return DB_SUCCESS;
@@ -35,12 +68,28 @@ dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key,RowId row_id,Transactio
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
-  KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
-  if (container_.GetValue(index_key, result, txn)) {
-    return DB_SUCCESS;
+  if (!KeyFits(key)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  if (unique_) {
+    KeyType index_key;
+    index_key.SerializeFromKey(key, key_schema_);
+    if (container_.GetValue(index_key, result, txn)) {
+      return DB_SUCCESS;
+    }
+    return DB_KEY_NOT_FOUND;
   }
-  return DB_KEY_NOT_FOUND;
+  // the rows of the key lie between its smallest and its largest row id, as in ScanRange
+  KeyType lo_key;
+  KeyType hi_key;
+  SerializeKey(key, RowId(0, 0), &lo_key);
+  SerializeKey(key, RowId(INVALID_PAGE_ID, UINT32_MAX), &hi_key);
+  size_t count = result.size();
+  container_.ScanRange(&lo_key, true, &hi_key, true, 0, [&result](const std::vector<RowId> &batch) {
+    result.insert(result.end(), batch.begin(), batch.end());
+    return true;
+  });
+  return result.size() > count ? DB_SUCCESS : DB_KEY_NOT_FOUND;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -49,6 +98,109 @@ dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   return DB_SUCCESS;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::BulkLoad(const IndexEntrySource &source, Transaction *txn) {
+  if (!container_.IsEmpty()) {
+    return DB_FAILED;
+  }
+  using Entry = std::pair<KeyType, RowId>;
+  // equal keys in row id order, the first one stays as if the rows were inserted in table order, keys of a
+  // non-unique index end with the row id and are never equal
+  auto less = [this](const Entry &a, const Entry &b) {
+    int cmp = comparator_(a.first, b.first);
+    return cmp != 0 ? cmp < 0 : a.second.Get() < b.second.Get();
+  };
+  ExternalSorter<Entry, decltype(less)> sorter(less);
+  Entry entry;
+  bool fits = true;
+  source([&](const Row &key, RowId row_id) {
+    ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+    fits = fits && KeyFits(key);
+    if (!fits) {
+      return;
+    }
+    SerializeKey(key, row_id, &entry.first);
+    entry.second = row_id;
+    sorter.Add(entry);
+  });
+  if (!fits) {
+    return DB_KEY_TOO_LARGE;
+  }
+  sorter.Finish();
+  bool has_last = false;
+  KeyType last_key;
+  auto next = [&](Entry *item) {
+    while (sorter.Next(item)) {
+      if (!has_last || comparator_(item->first, last_key) != 0) {
+        has_last = true;
+        last_key = item->first;
+        return true;
+      }
+    }
+    return false;
+  };
+  // the count of duplicate keys is not known before the merge, the tree takes up to the count of entries
+  if (!container_.BulkLoad(next, sorter.GetCount())) {
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                                        uint64_t limit, const RowIdBatchConsumer &consume, Transaction *txn) {
+  // in a non-unique index the rows of a bound key lie between its smallest and its largest row id
+  const RowId first_row(0, 0);
+  const RowId last_row(INVALID_PAGE_ID, UINT32_MAX);
+  if ((lo != nullptr && !KeyFits(*lo)) || (hi != nullptr && !KeyFits(*hi))) {
+    return DB_FAILED;
+  }
+  KeyType lo_key;
+  KeyType hi_key;
+  if (lo != nullptr) {
+    SerializeKey(*lo, lo_inclusive ? first_row : last_row, &lo_key);
+  }
+  if (hi != nullptr) {
+    SerializeKey(*hi, hi_inclusive ? last_row : first_row, &hi_key);
+  }
+  container_.ScanRange(lo == nullptr ? nullptr : &lo_key, lo_inclusive, hi == nullptr ? nullptr : &hi_key,
+                       hi_inclusive, limit, consume);
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::GetMinKey(Row &key) {
+  KeyType index_key;
+  bool found;
+  if constexpr (IsCodecKey<KeyType>::value) {
+    KeyType bound;
+    memset(bound.data, 0, sizeof(bound.data));
+    KeyCodec::EncodeNotNullBound(bound.data);
+    found = container_.GetMinKey(index_key, &bound);
+  } else {
+    found = container_.GetMinKey(index_key);
+  }
+  if (!found) {
+    return DB_KEY_NOT_FOUND;
+  }
+  index_key.DeserializeToKey(key, key_schema_);
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::GetMaxKey(Row &key) {
+  KeyType index_key;
+  if (!container_.GetMaxKey(index_key)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  index_key.DeserializeToKey(key, key_schema_);
+  // nulls sort first, the largest key is only null if every key is
+  if (key.GetField(0)->IsNull()) {
+    return DB_KEY_NOT_FOUND;
+  }
+  return DB_SUCCESS;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() {
   return container_.Begin();
@@ -78,4 +230,10 @@ template
 class BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeIndex<NativeKey<int32_t>, RowId, NativeComparator<int32_t>>;
+
+template
+class BPlusTreeIndex<NativeKey<float>, RowId, NativeComparator<float>>;
\ No newline at end of file
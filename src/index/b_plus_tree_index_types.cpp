@@ -0,0 +1,51 @@
+#include "index/b_plus_tree_index_types.h"
+
+#include "index/key_codec.h"
+
+Index *CreateBPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                            bool unique) {
+  if (unique && key_schema->GetColumnCount() == 1 && !key_schema->GetColumn(0)->IsNullable()) {
+    switch (key_schema->GetColumn(0)->GetType()) {
+      case kTypeInt:
+        return new BPlusTreeIndex<NativeKey<int32_t>, RowId, NativeComparator<int32_t>>(index_id, key_schema,
+                                                                                         buffer_pool_manager);
+      case kTypeFloat:
+        return new BPlusTreeIndex<NativeKey<float>, RowId, NativeComparator<float>>(index_id, key_schema,
+                                                                                     buffer_pool_manager);
+      default:
+        break;
+    }
+  }
+  uint32_t key_size = KeyCodec::GetMaxEncodedSize(key_schema);
+  if (!unique) {
+    key_size += GenericKey<64>::ROW_ID_SIZE;
+  }
+  if (key_size <= 4) {
+    return new BPlusTreeIndex<GenericKey<4>, RowId, GenericComparator<4>>(index_id, key_schema, buffer_pool_manager,
+                                                                          unique);
+  }
+  if (key_size <= 8) {
+    return new BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>(index_id, key_schema, buffer_pool_manager,
+                                                                          unique);
+  }
+  if (key_size <= 16) {
+    return new BPlusTreeIndex<GenericKey<16>, RowId, GenericComparator<16>>(index_id, key_schema, buffer_pool_manager,
+                                                                            unique);
+  }
+  if (key_size <= 32) {
+    return new BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>(index_id, key_schema, buffer_pool_manager,
+                                                                            unique);
+  }
+  // wider keys fit as long as their char values are short, longer ones are refused, see BPlusTreeIndex::KeyFits
+  return new BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>(index_id, key_schema, buffer_pool_manager,
+                                                                          unique);
+}
+
+bool IsUniqueKeySchema(IndexSchema *key_schema) {
+  for (auto *column : key_schema->GetColumns()) {
+    if (column->IsUnique()) {
+      return true;
+    }
+  }
+  return false;
+}
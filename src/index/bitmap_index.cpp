@@ -0,0 +1,59 @@
+#include "index/bitmap_index.h"
+
+BitmapIndex::BitmapIndex(index_id_t index_id, IndexSchema *key_schema) : Index(index_id, key_schema) {}
+
+dberr_t BitmapIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  bitmaps_[EncodeKey(key)].Add(row_id);
+  all_rows_.Add(row_id);
+  return DB_SUCCESS;
+}
+
+dberr_t BitmapIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
+  auto it = bitmaps_.find(EncodeKey(key));
+  if (it == bitmaps_.end() || !it->second.Remove(row_id)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  if (it->second.IsEmpty()) {
+    bitmaps_.erase(it);
+  }
+  all_rows_.Remove(row_id);
+  return DB_SUCCESS;
+}
+
+dberr_t BitmapIndex::ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) {
+  const RoaringBitmap *bitmap = GetBitmap(key);
+  if (bitmap == nullptr) {
+    return DB_KEY_NOT_FOUND;
+  }
+  bitmap->ToRowIds(&result);
+  return DB_SUCCESS;
+}
+
+dberr_t BitmapIndex::Destroy() {
+  bitmaps_.clear();
+  all_rows_.Clear();
+  return DB_SUCCESS;
+}
+
+const RoaringBitmap *BitmapIndex::GetBitmap(const Row &key) const {
+  auto it = bitmaps_.find(EncodeKey(key));
+  return it == bitmaps_.end() ? nullptr : &it->second;
+}
+
+std::string BitmapIndex::EncodeKey(const Row &key) const {
+  std::string encoded;
+  for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+    Field *field = key.GetField(i);
+    // nulls of the executor have no type, they are only flagged
+    if (field->IsNull()) {
+      encoded.push_back(0);
+      continue;
+    }
+    encoded.push_back(1);
+    size_t ofs = encoded.size();
+    encoded.resize(ofs + field->GetSerializedSize());
+    field->SerializeTo(&encoded[ofs]);
+  }
+  return encoded;
+}
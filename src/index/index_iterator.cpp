@@ -1,5 +1,6 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
 #include "index/index_iterator.h"
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf,int index,BufferPoolManager *buff_pool_manager,int flag) {
@@ -77,3 +78,9 @@ class IndexIterator<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class IndexIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class IndexIterator<NativeKey<int32_t>, RowId, NativeComparator<int32_t>>;
+
+template
+class IndexIterator<NativeKey<float>, RowId, NativeComparator<float>>;
@@ -0,0 +1,142 @@
+#include "index/key_codec.h"
+
+#include <string>
+
+#include "record/row.h"
+
+namespace {
+
+constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+inline void WriteBigEndian(char *buf, uint32_t value) {
+  for (int i = 3; i >= 0; i--, value >>= 8) {
+    buf[i] = static_cast<char>(value & 0xff);
+  }
+}
+
+inline uint32_t ReadBigEndian(const char *buf) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value = (value << 8) | static_cast<uint8_t>(buf[i]);
+  }
+  return value;
+}
+
+inline uint32_t EncodeFloat(float f) {
+  if (f == 0.0f) {
+    f = 0.0f;
+  }
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return (bits & SIGN_BIT) ? ~bits : bits ^ SIGN_BIT;
+}
+
+inline float DecodeFloat(uint32_t bits) {
+  bits = (bits & SIGN_BIT) ? bits ^ SIGN_BIT : ~bits;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+}  // namespace
+
+uint32_t KeyCodec::GetEncodedSize(const Row &key, Schema *schema) {
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    const Field *field = key.GetField(i);
+    size++;
+    if (field->is_null_) {
+      continue;
+    }
+    if (schema->GetColumn(i)->GetType() != kTypeChar) {
+      size += sizeof(uint32_t);
+      continue;
+    }
+    for (uint32_t j = 0; j < field->len_; j++) {
+      size += field->value_.chars_[j] == ESCAPE ? 2 : 1;
+    }
+    size += 2;
+  }
+  return size;
+}
+
+uint32_t KeyCodec::GetMaxEncodedSize(Schema *schema) {
+  uint32_t size = 0;
+  for (auto *column : schema->GetColumns()) {
+    size += 1 + (column->GetType() == kTypeChar ? 2 * column->GetLength() + 2 : sizeof(uint32_t));
+  }
+  return size;
+}
+
+uint32_t KeyCodec::EncodeNotNullBound(char *buf) {
+  buf[0] = VALUE_MARKER;
+  return 1;
+}
+
+uint32_t KeyCodec::Encode(const Row &key, Schema *schema, char *buf) {
+  uint32_t ofs = 0;
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    const Field *field = key.GetField(i);
+    if (field->is_null_) {
+      buf[ofs++] = NULL_MARKER;
+      continue;
+    }
+    buf[ofs++] = VALUE_MARKER;
+    switch (schema->GetColumn(i)->GetType()) {
+      case kTypeInt:
+        WriteBigEndian(buf + ofs, static_cast<uint32_t>(field->value_.integer_) ^ SIGN_BIT);
+        ofs += sizeof(uint32_t);
+        break;
+      case kTypeFloat:
+        WriteBigEndian(buf + ofs, EncodeFloat(field->value_.float_));
+        ofs += sizeof(uint32_t);
+        break;
+      default:
+        for (uint32_t j = 0; j < field->len_; j++) {
+          char c = field->value_.chars_[j];
+          buf[ofs++] = c;
+          if (c == ESCAPE) {
+            buf[ofs++] = ESCAPED_ZERO;
+          }
+        }
+        buf[ofs++] = ESCAPE;
+        buf[ofs++] = TERMINATOR;
+        break;
+    }
+  }
+  return ofs;
+}
+
+uint32_t KeyCodec::Decode(const char *buf, Schema *schema, Row *key) {
+  ASSERT(key->fields_.empty(), "Row is not empty");
+  uint32_t ofs = 0;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    Field *field;
+    if (buf[ofs++] == NULL_MARKER) {
+      field = ALLOC_P(key->heap_, Field)(type);
+    } else if (type == kTypeInt) {
+      field = ALLOC_P(key->heap_, Field)(type, static_cast<int32_t>(ReadBigEndian(buf + ofs) ^ SIGN_BIT));
+      ofs += sizeof(uint32_t);
+    } else if (type == kTypeFloat) {
+      field = ALLOC_P(key->heap_, Field)(type, DecodeFloat(ReadBigEndian(buf + ofs)));
+      ofs += sizeof(uint32_t);
+    } else {
+      std::string value;
+      for (;; ofs++) {
+        if (buf[ofs] == ESCAPE) {
+          if (buf[++ofs] == TERMINATOR) {
+            ofs++;
+            break;
+          }
+          value.push_back(ESCAPE);
+        } else {
+          value.push_back(buf[ofs]);
+        }
+      }
+      field = ALLOC_P(key->heap_, Field)(type, const_cast<char *>(value.data()), value.size(), true);
+    }
+    key->fields_.push_back(field);
+  }
+  return ofs;
+}
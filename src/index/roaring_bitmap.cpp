@@ -0,0 +1,312 @@
+#include "index/roaring_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/macros.h"
+
+bool RoaringBitmap::Container::Contains(uint16_t slot) const {
+  if (IsBitmap()) {
+    return (bits_[slot / 64] >> (slot % 64)) & 1;
+  }
+  return std::binary_search(array_.begin(), array_.end(), slot);
+}
+
+void RoaringBitmap::Container::Normalize() {
+  if (IsBitmap() && cardinality_ <= ARRAY_MAX_SIZE) {
+    array_.clear();
+    array_.reserve(cardinality_);
+    for (uint32_t w = 0; w < BITMAP_WORDS; w++) {
+      for (uint64_t word = bits_[w]; word != 0; word &= word - 1) {
+        array_.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+      }
+    }
+    std::vector<uint64_t>().swap(bits_);
+  } else if (!IsBitmap() && cardinality_ > ARRAY_MAX_SIZE) {
+    ToBitmap();
+  }
+}
+
+void RoaringBitmap::Container::ToBitmap() {
+  if (IsBitmap()) {
+    return;
+  }
+  bits_.assign(BITMAP_WORDS, 0);
+  for (auto slot : array_) {
+    bits_[slot / 64] |= uint64_t(1) << (slot % 64);
+  }
+  std::vector<uint16_t>().swap(array_);
+}
+
+size_t RoaringBitmap::FindContainer(page_id_t page_id) const {
+  return std::lower_bound(keys_.begin(), keys_.end(), page_id) - keys_.begin();
+}
+
+bool RoaringBitmap::Add(const RowId &rid) {
+  ASSERT(rid.GetSlotNum() < static_cast<uint32_t>(PAGE_SIZE), "Slot number out of range.");
+  auto slot = static_cast<uint16_t>(rid.GetSlotNum());
+  size_t pos = FindContainer(rid.GetPageId());
+  if (pos == keys_.size() || keys_[pos] != rid.GetPageId()) {
+    keys_.insert(keys_.begin() + pos, rid.GetPageId());
+    containers_.insert(containers_.begin() + pos, Container());
+  }
+  Container &container = containers_[pos];
+  if (container.IsBitmap()) {
+    uint64_t &word = container.bits_[slot / 64];
+    uint64_t mask = uint64_t(1) << (slot % 64);
+    if (word & mask) {
+      return false;
+    }
+    word |= mask;
+  } else {
+    auto it = std::lower_bound(container.array_.begin(), container.array_.end(), slot);
+    if (it != container.array_.end() && *it == slot) {
+      return false;
+    }
+    container.array_.insert(it, slot);
+  }
+  container.cardinality_++;
+  container.Normalize();
+  cardinality_++;
+  return true;
+}
+
+bool RoaringBitmap::Remove(const RowId &rid) {
+  if (rid.GetSlotNum() >= static_cast<uint32_t>(PAGE_SIZE)) {
+    return false;
+  }
+  auto slot = static_cast<uint16_t>(rid.GetSlotNum());
+  size_t pos = FindContainer(rid.GetPageId());
+  if (pos == keys_.size() || keys_[pos] != rid.GetPageId()) {
+    return false;
+  }
+  Container &container = containers_[pos];
+  if (container.IsBitmap()) {
+    uint64_t &word = container.bits_[slot / 64];
+    uint64_t mask = uint64_t(1) << (slot % 64);
+    if (!(word & mask)) {
+      return false;
+    }
+    word &= ~mask;
+  } else {
+    auto it = std::lower_bound(container.array_.begin(), container.array_.end(), slot);
+    if (it == container.array_.end() || *it != slot) {
+      return false;
+    }
+    container.array_.erase(it);
+  }
+  cardinality_--;
+  if (--container.cardinality_ == 0) {
+    keys_.erase(keys_.begin() + pos);
+    containers_.erase(containers_.begin() + pos);
+  } else {
+    container.Normalize();
+  }
+  return true;
+}
+
+bool RoaringBitmap::Contains(const RowId &rid) const {
+  if (rid.GetSlotNum() >= static_cast<uint32_t>(PAGE_SIZE)) {
+    return false;
+  }
+  size_t pos = FindContainer(rid.GetPageId());
+  return pos < keys_.size() && keys_[pos] == rid.GetPageId() &&
+         containers_[pos].Contains(static_cast<uint16_t>(rid.GetSlotNum()));
+}
+
+void RoaringBitmap::Clear() {
+  keys_.clear();
+  containers_.clear();
+  cardinality_ = 0;
+}
+
+RoaringBitmap::Container RoaringBitmap::AndContainers(const Container &a, const Container &b) {
+  Container result;
+  if (a.IsBitmap() && b.IsBitmap()) {
+    result.bits_.resize(BITMAP_WORDS);
+    for (uint32_t w = 0; w < BITMAP_WORDS; w++) {
+      result.bits_[w] = a.bits_[w] & b.bits_[w];
+      result.cardinality_ += __builtin_popcountll(result.bits_[w]);
+    }
+  } else if (!a.IsBitmap() && !b.IsBitmap()) {
+    std::set_intersection(a.array_.begin(), a.array_.end(), b.array_.begin(), b.array_.end(),
+                          std::back_inserter(result.array_));
+    result.cardinality_ = result.array_.size();
+  } else {
+    // probe the bitmap with the slots of the array
+    const Container &array = a.IsBitmap() ? b : a;
+    const Container &bitmap = a.IsBitmap() ? a : b;
+    for (auto slot : array.array_) {
+      if (bitmap.Contains(slot)) {
+        result.array_.push_back(slot);
+      }
+    }
+    result.cardinality_ = result.array_.size();
+  }
+  result.Normalize();
+  return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::OrContainers(const Container &a, const Container &b) {
+  Container result;
+  if (!a.IsBitmap() && !b.IsBitmap()) {
+    std::set_union(a.array_.begin(), a.array_.end(), b.array_.begin(), b.array_.end(),
+                   std::back_inserter(result.array_));
+    result.cardinality_ = result.array_.size();
+  } else {
+    result = a;
+    result.ToBitmap();
+    if (b.IsBitmap()) {
+      for (uint32_t w = 0; w < BITMAP_WORDS; w++) {
+        result.bits_[w] |= b.bits_[w];
+      }
+    } else {
+      for (auto slot : b.array_) {
+        result.bits_[slot / 64] |= uint64_t(1) << (slot % 64);
+      }
+    }
+    result.cardinality_ = 0;
+    for (auto word : result.bits_) {
+      result.cardinality_ += __builtin_popcountll(word);
+    }
+  }
+  result.Normalize();
+  return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::AndNotContainers(const Container &a, const Container &b) {
+  Container result;
+  if (!a.IsBitmap()) {
+    for (auto slot : a.array_) {
+      if (!b.Contains(slot)) {
+        result.array_.push_back(slot);
+      }
+    }
+    result.cardinality_ = result.array_.size();
+  } else {
+    result = a;
+    if (b.IsBitmap()) {
+      for (uint32_t w = 0; w < BITMAP_WORDS; w++) {
+        result.bits_[w] &= ~b.bits_[w];
+      }
+    } else {
+      for (auto slot : b.array_) {
+        result.bits_[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+      }
+    }
+    result.cardinality_ = 0;
+    for (auto word : result.bits_) {
+      result.cardinality_ += __builtin_popcountll(word);
+    }
+  }
+  result.Normalize();
+  return result;
+}
+
+void RoaringBitmap::And(const RoaringBitmap &other) {
+  std::vector<page_id_t> keys;
+  std::vector<Container> containers;
+  size_t i = 0, j = 0;
+  while (i < keys_.size() && j < other.keys_.size()) {
+    if (keys_[i] < other.keys_[j]) {
+      i++;
+    } else if (keys_[i] > other.keys_[j]) {
+      j++;
+    } else {
+      Container container = AndContainers(containers_[i], other.containers_[j]);
+      if (container.cardinality_ > 0) {
+        keys.push_back(keys_[i]);
+        containers.push_back(std::move(container));
+      }
+      i++;
+      j++;
+    }
+  }
+  keys_ = std::move(keys);
+  containers_ = std::move(containers);
+  Recount();
+}
+
+void RoaringBitmap::Or(const RoaringBitmap &other) {
+  std::vector<page_id_t> keys;
+  std::vector<Container> containers;
+  size_t i = 0, j = 0;
+  while (i < keys_.size() || j < other.keys_.size()) {
+    if (j == other.keys_.size() || (i < keys_.size() && keys_[i] < other.keys_[j])) {
+      keys.push_back(keys_[i]);
+      containers.push_back(std::move(containers_[i++]));
+    } else if (i == keys_.size() || keys_[i] > other.keys_[j]) {
+      keys.push_back(other.keys_[j]);
+      containers.push_back(other.containers_[j++]);
+    } else {
+      keys.push_back(keys_[i]);
+      containers.push_back(OrContainers(containers_[i++], other.containers_[j++]));
+    }
+  }
+  keys_ = std::move(keys);
+  containers_ = std::move(containers);
+  Recount();
+}
+
+void RoaringBitmap::AndNot(const RoaringBitmap &other) {
+  std::vector<page_id_t> keys;
+  std::vector<Container> containers;
+  size_t j = 0;
+  for (size_t i = 0; i < keys_.size(); i++) {
+    while (j < other.keys_.size() && other.keys_[j] < keys_[i]) {
+      j++;
+    }
+    if (j == other.keys_.size() || other.keys_[j] != keys_[i]) {
+      keys.push_back(keys_[i]);
+      containers.push_back(std::move(containers_[i]));
+      continue;
+    }
+    Container container = AndNotContainers(containers_[i], other.containers_[j]);
+    if (container.cardinality_ > 0) {
+      keys.push_back(keys_[i]);
+      containers.push_back(std::move(container));
+    }
+  }
+  keys_ = std::move(keys);
+  containers_ = std::move(containers);
+  Recount();
+}
+
+void RoaringBitmap::Not(const RoaringBitmap &universe) {
+  RoaringBitmap complement(universe);
+  complement.AndNot(*this);
+  *this = std::move(complement);
+}
+
+void RoaringBitmap::ToRowIds(std::vector<RowId> *rids) const {
+  rids->reserve(rids->size() + cardinality_);
+  for (size_t i = 0; i < keys_.size(); i++) {
+    const Container &container = containers_[i];
+    if (!container.IsBitmap()) {
+      for (auto slot : container.array_) {
+        rids->emplace_back(keys_[i], slot);
+      }
+      continue;
+    }
+    for (uint32_t w = 0; w < BITMAP_WORDS; w++) {
+      for (uint64_t word = container.bits_[w]; word != 0; word &= word - 1) {
+        rids->emplace_back(keys_[i], w * 64 + __builtin_ctzll(word));
+      }
+    }
+  }
+}
+
+uint64_t RoaringBitmap::GetSizeInBytes() const {
+  uint64_t size = keys_.size() * sizeof(page_id_t);
+  for (auto &container : containers_) {
+    size += container.IsBitmap() ? BITMAP_WORDS * sizeof(uint64_t) : container.array_.size() * sizeof(uint16_t);
+  }
+  return size;
+}
+
+void RoaringBitmap::Recount() {
+  cardinality_ = 0;
+  for (auto &container : containers_) {
+    cardinality_ += container.cardinality_;
+  }
+}
@@ -1,6 +1,8 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
 #include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_node_search.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -83,19 +85,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType& valu
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  // replace with your own code
-  int lim = GetSize();
-  int i;
-  if(comparator(key,array_[1].first)<0)
-    return array_[0].second;
-  if(comparator(key,array_[lim-1].first)>=0)
-    return array_[lim-1].second;
-
-  for(i=1;i<lim-1;i++){
-    if(comparator(key,array_[i+1].first)<0)
-      break;
-  }
-
+  // the first key is invalid, the child is the one after the last key not greater than key
+  int i = NodeSearch<KeyType, KeyComparator>::UpperBound(array_ + 1, GetSize() - 1, key, comparator);
   return array_[i].second;
 }
 
@@ -346,4 +337,10 @@ template
 class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 
 template
-class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<int32_t>, page_id_t, NativeComparator<int32_t>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<float>, page_id_t, NativeComparator<float>>;
\ No newline at end of file
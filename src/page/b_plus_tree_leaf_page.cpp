@@ -1,7 +1,9 @@
 #include <algorithm>
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
 #include "page/b_plus_tree_leaf_page.h"
+#include "page/b_plus_tree_node_search.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -43,12 +45,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int i;
-  for(i=0;i<GetSize();i++)
-    if(comparator(array_[i].first,key)>=0)
-      break;
-  
-  return i;
+  return NodeSearch<KeyType, KeyComparator>::LowerBound(array_, GetSize(), key, comparator);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::UpperKeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return NodeSearch<KeyType, KeyComparator>::UpperBound(array_, GetSize(), key, comparator);
 }
 
 /*
@@ -93,18 +95,9 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
     memmove((void *)(array_ + 1), (void *)array_, static_cast<size_t>(GetSize()*sizeof(MappingType)));
     array_[0] = {key, value};
   } else {
-    int low = 0, high = GetSize() - 1, mid;
-    while (low < high && low + 1 != high) {
-      mid = low + (high - low)/2;
-      if (comparator(key, array_[mid].first) < 0) {
-        high = mid;
-      } else if (comparator(key, array_[mid].first) > 0) {
-        low = mid;
-      } else {
-        // only support unique key
-        assert(0);
-      }
-    }
+    int high = KeyIndex(key, comparator);
+    // only support unique key
+    assert(comparator(key, array_[high].first) != 0);
     memmove((void *)(array_ + high + 1), (void *)(array_ + high),
             static_cast<size_t>((GetSize() - high)*sizeof(MappingType)));
     array_[high] = {key, value};
@@ -151,26 +144,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  if (GetSize() == 0 || comparator(key, KeyAt(0)) < 0 ||
-      comparator(key, KeyAt(GetSize() - 1)) > 0) {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(key, array_[index].first) != 0) {
     return false;
   }
-
-  int low = 0;
-  int high = GetSize()-1;
-  int mid;
-  while(low<=high){
-    mid = low +(high -low)/2;
-    if(comparator(key,array_[mid].first)<0)
-      high = mid - 1;
-    else if(comparator(key,array_[mid].first)>0)
-      low = mid + 1;
-    else{
-      value = array_[mid].second;
-      return true;
-    }
-  }
-  return false;
+  value = array_[index].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -184,14 +163,11 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-  int i;
-  for(i=0;i<GetSize();i++){
-    if(array_[i].first == key){
-      for(int j=i;j<GetSize()-1;j++)
-        array_[j] = array_[j+1];
-      IncreaseSize(-1);
-      break;
-    }
+  int i = KeyIndex(key, comparator);
+  if (i < GetSize() && comparator(array_[i].first, key) == 0) {
+    for(int j=i;j<GetSize()-1;j++)
+      array_[j] = array_[j+1];
+    IncreaseSize(-1);
   }
   return GetSize();
 }
@@ -284,4 +260,10 @@ template
 class BPlusTreeLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<int32_t>, RowId, NativeComparator<int32_t>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<float>, RowId, NativeComparator<float>>;
\ No newline at end of file
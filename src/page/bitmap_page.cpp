@@ -4,9 +4,11 @@ template<size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   const size_t MaxSize = GetMaxSupportedSize();
   if (page_allocated_ == MaxSize) return false;
-  page_offset = next_free_page_++;
+  page_offset = next_free_page_;
   SetPage(page_offset, 1);
-  while (page_allocated_ < MaxSize && !IsPageFree(page_allocated_)) ++page_allocated_;
+  page_allocated_++;
+  // pages freed out of order leave allocated pages behind the lowest free one, skip them
+  while (next_free_page_ < MaxSize && !IsPageFree(next_free_page_)) ++next_free_page_;
   return true;
 }
 
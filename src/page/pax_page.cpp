@@ -0,0 +1,143 @@
+#include "page/pax_page.h"
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_id, Schema *schema, LogManager *log_mgr, Transaction *txn) {
+  ASSERT(schema->GetCodec().GetPaxCapacity() > 0, "PAX page can not hold a row of this schema.");
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetTupleCount(0);
+  SetUsedSlots(0);
+  memset(GetArea(), kSlotEmpty, schema->GetCodec().GetPaxCapacity());
+}
+
+bool PaxPage::InsertTuple(Row &row, const uint32_t *codes, Schema *schema, Transaction *txn,
+                          LockManager *lock_manager, LogManager *log_manager) {
+  const RowCodec &codec = schema->GetCodec();
+  if (GetUsedSlots() >= codec.GetPaxCapacity() || !codec.FitsPax(row)) {
+    return false;
+  }
+  // reuse the first empty slot, slots past the slot count are all empty
+  uint32_t slot = 0;
+  while (slot < GetTupleCount() && GetSlotState(slot) != kSlotEmpty) {
+    slot++;
+  }
+  codec.EncodePax(row, codes, slot, GetArea());
+  SetSlotState(slot, kSlotLive);
+  SetUsedSlots(GetUsedSlots() + 1);
+  if (slot == GetTupleCount()) {
+    SetTupleCount(slot + 1);
+  }
+  row.SetRowId(RowId(GetTablePageId(), slot));
+  return true;
+}
+
+bool PaxPage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  if (!IsLive(rid.GetSlotNum())) {
+    return false;
+  }
+  SetSlotState(rid.GetSlotNum(), kSlotDeleted);
+  return true;
+}
+
+bool PaxPage::UpdateTuple(const Row &new_row, const uint32_t *codes, const RowId &rid, Schema *schema,
+                          Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  if (!IsLive(rid.GetSlotNum()) || !schema->GetCodec().FitsPax(new_row)) {
+    return false;
+  }
+  schema->GetCodec().EncodePax(new_row, codes, rid.GetSlotNum(), GetArea());
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot = rid.GetSlotNum();
+  ASSERT(slot < GetTupleCount(), "Cannot have more slots than tuples.");
+  if (GetSlotState(slot) == kSlotEmpty) {
+    return;
+  }
+  SetSlotState(slot, kSlotEmpty);
+  SetUsedSlots(GetUsedSlots() - 1);
+  // trailing empty slots are given back, scans stop earlier
+  uint32_t slot_count = GetTupleCount();
+  while (slot_count > 0 && GetSlotState(slot_count - 1) == kSlotEmpty) {
+    slot_count--;
+  }
+  SetTupleCount(slot_count);
+}
+
+void PaxPage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot = rid.GetSlotNum();
+  ASSERT(slot < GetTupleCount(), "We can't have more slots than tuples.");
+  if (GetSlotState(slot) == kSlotDeleted) {
+    SetSlotState(slot, kSlotLive);
+  }
+}
+
+bool PaxPage::GetTuple(Row *row, Schema *schema, const std::vector<bool> *fetch_mask,
+                       const std::vector<ColumnDictionary> *dictionaries, Transaction *txn,
+                       LockManager *lock_manager) {
+  uint32_t slot = row->GetRowId().GetSlotNum();
+  if (!IsLive(slot)) {
+    return false;
+  }
+  schema->GetCodec().DecodePax(GetArea(), &slot, 1, fetch_mask, dictionaries, row);
+  return true;
+}
+
+void PaxPage::GetTuples(Schema *schema, const std::vector<bool> *fetch_mask,
+                        const std::vector<CodeFilter> *code_filters, const std::vector<ColumnDictionary> *dictionaries,
+                        MemHeap *heap, std::vector<Row> *rows) {
+  const RowCodec &codec = schema->GetCodec();
+  std::vector<uint32_t> slots;
+  slots.reserve(GetTupleCount());
+  for (uint32_t slot = 0; slot < GetTupleCount(); slot++) {
+    if (GetSlotState(slot) == kSlotLive) {
+      slots.push_back(slot);
+    }
+  }
+  // filters only look at the code vectors, rejected rows are never decoded
+  for (uint32_t i = 0; code_filters != nullptr && i < code_filters->size() && !slots.empty(); i++) {
+    const CodeFilter &filter = (*code_filters)[i];
+    size_t kept = 0;
+    for (auto slot : slots) {
+      if (codec.IsPaxNull(GetArea(), filter.column_index_, slot)) {
+        continue;
+      }
+      uint32_t code = codec.GetPaxCode(GetArea(), filter.column_index_, slot);
+      if (code < filter.codes_.size() && filter.codes_[code]) {
+        slots[kept++] = slot;
+      }
+    }
+    slots.resize(kept);
+  }
+  size_t begin = rows->size();
+  page_id_t page_id = GetTablePageId();
+  rows->reserve(begin + slots.size());
+  for (auto slot : slots) {
+    rows->emplace_back(RowId(page_id, slot), heap);
+  }
+  codec.DecodePax(GetArea(), slots.data(), static_cast<uint32_t>(slots.size()), fetch_mask, dictionaries,
+                  rows->data() + begin);
+}
+
+bool PaxPage::GetFirstTupleRid(RowId *first_rid) {
+  for (uint32_t slot = 0; slot < GetTupleCount(); slot++) {
+    if (GetSlotState(slot) == kSlotLive) {
+      first_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool PaxPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+  ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (uint32_t slot = cur_rid.GetSlotNum() + 1; slot < GetTupleCount(); slot++) {
+    if (GetSlotState(slot) == kSlotLive) {
+      next_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
@@ -164,6 +164,19 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+bool TablePage::GetTupleView(const RowId &rid, Schema *schema, RowView *view, bool include_deleted) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (include_deleted ? tuple_size == 0 : IsDeleted(tuple_size)) {
+    return false;
+  }
+  view->Reset(GetData() + GetTupleOffsetAtSlot(slot_num), schema, rid);
+  return true;
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
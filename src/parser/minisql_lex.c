@@ -592,12 +592,37 @@ char *yytext;
 #line 2 "minisql.l"
 
 #include <stdio.h>
+#include <string.h>
 #include "parser/parser.h"
 #include "parser/minisql_yacc.h"
 
 int yywrap();
 
 extern YYSTYPE yylval;
+
+/**
+ * Keywords matched through the identifier rule, looked up before an identifier is returned
+ */
+static const struct {
+  const char *name;
+  int token;
+} keywords[] = {
+  {"analyze", ANALYZE},
+  {"stats", STATS},
+  {"dictionary", DICTIONARY},
+  {"in", IN},
+  {"compressed", COMPRESSED},
+  {"truncate", TRUNCATE},
+};
+
+static int FindKeyword(const char *text) {
+  for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+    if (strcmp(keywords[i].name, text) == 0) {
+      return keywords[i].token;
+    }
+  }
+  return 0;
+}
 #line 585 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
@@ -1182,6 +1207,10 @@ YY_DECL {
 #line 208 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
+        int keyword = FindKeyword(yytext);
+        if (keyword != 0) {
+          return keyword;
+        }
         yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
         return IDENTIFIER;
       }
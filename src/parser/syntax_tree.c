@@ -169,6 +169,22 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeSetVariable:
+      return "kNodeSetVariable";
+    case kNodeAnalyze:
+      return "kNodeAnalyze";
+    case kNodeShowStats:
+      return "kNodeShowStats";
+    case kNodeTableLayout:
+      return "kNodeTableLayout";
+    case kNodeTableCompression:
+      return "kNodeTableCompression";
+    case kNodeAggregateList:
+      return "kNodeAggregateList";
+    case kNodeAggregate:
+      return "kNodeAggregate";
+    case kNodeTruncateTable:
+      return "kNodeTruncateTable";
     default:
       return "error type";
   }
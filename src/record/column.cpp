@@ -47,7 +47,8 @@ uint32_t Column::SerializeTo(char *buf) const {
 }
 
 uint32_t Column::GetSerializedSize() const {
-  return sizeof(uint32_t) + sizeof(size_t) + name_.size() + sizeof(TypeId) + sizeof(uint32_t) * 2 + sizeof(bool) * 2;
+  // the magic number occupies a size_t slot, see SerializeTo
+  return sizeof(size_t) + sizeof(size_t) + name_.size() + sizeof(TypeId) + sizeof(uint32_t) * 2 + sizeof(bool) * 2;
 }
 
 uint32_t Column::DeserializeFrom(char *buf, Column *&column, MemHeap *heap) {
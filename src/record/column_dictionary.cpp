@@ -0,0 +1,16 @@
+#include "record/column_dictionary.h"
+
+uint32_t ColumnDictionary::Find(const char *data, uint32_t len) const {
+  auto iter = codes_.find(std::string(data, len));
+  return iter == codes_.end() ? INVALID_CODE : iter->second;
+}
+
+uint32_t ColumnDictionary::Add(const char *data, uint32_t len) {
+  if (values_.size() >= MAX_CODES) {
+    return INVALID_CODE;
+  }
+  uint32_t code = static_cast<uint32_t>(values_.size());
+  values_.emplace_back(data, len);
+  codes_.emplace(values_.back(), code);
+  return code;
+}
@@ -0,0 +1,310 @@
+#include "record/row_codec.h"
+#include "record/row.h"
+
+namespace {
+
+inline bool IsNullBit(const unsigned char *bitmap, uint32_t i) { return (bitmap[i / 8] >> (i % 8)) & 1u; }
+
+inline void SetNullBit(unsigned char *bitmap, uint32_t i) { bitmap[i / 8] |= 1u << (i % 8); }
+
+inline void ClearNullBit(unsigned char *bitmap, uint32_t i) { bitmap[i / 8] &= ~(1u << (i % 8)); }
+
+}  // namespace
+
+Field *RowCodec::NewCharField(Row *row, TypeId type, const char *data, uint32_t len) {
+  if (row->own_heap_) {
+    return ALLOC_P(row->heap_, Field)(type, const_cast<char *>(data), len, true);
+  }
+  // a borrowed heap (e.g. an arena) owns the bytes as well, no separate new[] per value
+  char *chars = reinterpret_cast<char *>(row->heap_->Allocate(len));
+  memcpy(chars, data, len);
+  return ALLOC_P(row->heap_, Field)(type, chars, len, false);
+}
+
+RowCodec::RowCodec(const std::vector<Column *> &columns) {
+  types_.reserve(columns.size());
+  column_layout_.resize(columns.size());
+  for (auto column : columns) {
+    types_.push_back(column->GetType());
+    lengths_.push_back(column->GetLength());
+  }
+  encodings_.resize(columns.size(), kEncodingPlain);
+  uint32_t ofs = GetNullBitmapSize();
+  for (uint32_t i = 0; i < types_.size(); i++) {
+    if (IsFixedWidth(i)) {
+      ASSERT(Type::GetTypeSize(types_[i]) == FIXED_WIDTH, "Unexpected fixed-width column size.");
+      column_layout_[i] = ofs;
+      ofs += FIXED_WIDTH;
+      fixed_columns_.push_back(i);
+    } else {
+      column_layout_[i] = static_cast<uint32_t>(var_columns_.size());
+      var_columns_.push_back(i);
+    }
+  }
+  var_offsets_begin_ = ofs;
+  BuildPaxLayout();
+}
+
+void RowCodec::SetColumnEncoding(uint32_t column_index, ColumnEncoding encoding) {
+  ASSERT(encoding == kEncodingPlain || types_[column_index] == TypeId::kTypeChar,
+         "Only char columns have a dictionary.");
+  if (encodings_[column_index] == encoding) {
+    return;
+  }
+  dictionary_column_count_ += encoding == kEncodingDictionary ? 1 : -1;
+  encodings_[column_index] = encoding;
+  BuildPaxLayout();
+}
+
+void RowCodec::BuildPaxLayout() {
+  uint32_t column_count = static_cast<uint32_t>(types_.size());
+  pax_widths_.resize(column_count);
+  pax_null_offsets_.resize(column_count);
+  pax_value_offsets_.resize(column_count);
+  uint64_t slot_size = 1;
+  for (uint32_t i = 0; i < column_count; i++) {
+    if (IsFixedWidth(i)) {
+      pax_widths_[i] = FIXED_WIDTH;
+    } else if (encodings_[i] == kEncodingDictionary) {
+      pax_widths_[i] = sizeof(uint16_t);
+    } else {
+      pax_widths_[i] = sizeof(uint16_t) + lengths_[i];
+    }
+    slot_size += pax_widths_[i];
+  }
+  // every slot takes its state byte, its values and one null bit per column
+  auto area_size = [&](uint64_t capacity) { return capacity * slot_size + column_count * ((capacity + 7) / 8); };
+  uint64_t capacity = uint64_t(PAX_AREA_SIZE) * 8 / (8 * slot_size + column_count);
+  while (capacity > 0 && area_size(capacity) > PAX_AREA_SIZE) {
+    capacity--;
+  }
+  pax_capacity_ = static_cast<uint32_t>(capacity);
+  uint32_t ofs = pax_capacity_;
+  for (uint32_t i = 0; i < column_count; i++) {
+    pax_null_offsets_[i] = ofs;
+    ofs += (pax_capacity_ + 7) / 8;
+    pax_value_offsets_[i] = ofs;
+    ofs += pax_capacity_ * pax_widths_[i];
+  }
+}
+
+uint32_t RowCodec::Encode(const Row &row, char *buf) const {
+  ASSERT(row.fields_.size() == types_.size(), "field nums not match.");
+  return row_format_ == kRowFormatV2 ? EncodeV2(row, buf) : EncodeV1(row, buf);
+}
+
+uint32_t RowCodec::Decode(const char *buf, Row *row) const {
+  ASSERT(row->fields_.empty(), "Row is not empty");
+  row->fields_.reserve(types_.size());
+  return row_format_ == kRowFormatV2 ? DecodeV2(buf, row) : DecodeV1(buf, row);
+}
+
+uint32_t RowCodec::GetSerializedSize(const Row &row) const {
+  const auto &fields = row.fields_;
+  ASSERT(fields.size() == types_.size(), "field nums not match.");
+  if (row_format_ == kRowFormatV2) {
+    uint32_t size = GetVarDataBegin();
+    for (auto i : var_columns_) {
+      size += fields[i]->is_null_ ? 0 : fields[i]->len_;
+    }
+    return size;
+  }
+  uint32_t size = V1_HEADER_SIZE + GetNullBitmapSize();
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    if (!fields[i]->is_null_) {
+      size += IsFixedWidth(i) ? FIXED_WIDTH : sizeof(uint32_t) + fields[i]->len_;
+    }
+  }
+  return size;
+}
+
+uint32_t RowCodec::EncodeV1(const Row &row, char *buf) const {
+  const auto &fields = row.fields_;
+  MACH_WRITE_TO(int64_t, buf, row.rid_.Get());
+  MACH_WRITE_TO(size_t, buf + sizeof(int64_t), fields.size());
+  unsigned char *bitmap = reinterpret_cast<unsigned char *>(buf + V1_HEADER_SIZE);
+  memset(bitmap, 0, GetNullBitmapSize());
+  uint32_t ofs = V1_HEADER_SIZE + GetNullBitmapSize();
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    const Field *field = fields[i];
+    ASSERT(!field->is_external_, "v1 rows can not hold toast pointers.");
+    if (field->is_null_) {
+      SetNullBit(bitmap, i);
+    } else if (IsFixedWidth(i)) {
+      memcpy(buf + ofs, &field->value_, FIXED_WIDTH);
+      ofs += FIXED_WIDTH;
+    } else {
+      MACH_WRITE_UINT32(buf + ofs, field->len_);
+      memcpy(buf + ofs + sizeof(uint32_t), field->value_.chars_, field->len_);
+      ofs += sizeof(uint32_t) + field->len_;
+    }
+  }
+  return ofs;
+}
+
+uint32_t RowCodec::DecodeV1(const char *buf, Row *row) const {
+  row->rid_ = RowId(MACH_READ_FROM(int64_t, buf));
+  ASSERT(MACH_READ_FROM(size_t, buf + sizeof(int64_t)) == types_.size(), "field nums not match.");
+  const unsigned char *bitmap = reinterpret_cast<const unsigned char *>(buf + V1_HEADER_SIZE);
+  uint32_t ofs = V1_HEADER_SIZE + GetNullBitmapSize();
+  for (uint32_t i = 0; i < types_.size(); i++) {
+    bool is_null = IsNullBit(bitmap, i);
+    Field *field;
+    if (is_null || IsFixedWidth(i)) {
+      field = ALLOC_P(row->heap_, Field)(types_[i]);
+      if (!is_null) {
+        memcpy(&field->value_, buf + ofs, FIXED_WIDTH);
+        field->len_ = FIXED_WIDTH;
+        field->is_null_ = false;
+        ofs += FIXED_WIDTH;
+      }
+    } else {
+      uint32_t len = MACH_READ_UINT32(buf + ofs);
+      field = NewCharField(row, types_[i], buf + ofs + sizeof(uint32_t), len);
+      ofs += sizeof(uint32_t) + len;
+    }
+    row->fields_.push_back(field);
+  }
+  return ofs;
+}
+
+uint32_t RowCodec::EncodeV2(const Row &row, char *buf) const {
+  const auto &fields = row.fields_;
+  // bitmap and fixed-width slots are cleared together, null fields leave their slot zeroed
+  memset(buf, 0, var_offsets_begin_);
+  unsigned char *bitmap = reinterpret_cast<unsigned char *>(buf);
+  for (auto i : fixed_columns_) {
+    if (fields[i]->is_null_) {
+      SetNullBit(bitmap, i);
+    } else {
+      memcpy(buf + column_layout_[i], &fields[i]->value_, FIXED_WIDTH);
+    }
+  }
+  char *var_offsets = buf + var_offsets_begin_;
+  uint32_t ofs = GetVarDataBegin();
+  for (auto i : var_columns_) {
+    const Field *field = fields[i];
+    if (field->is_null_) {
+      SetNullBit(bitmap, i);
+    } else {
+      memcpy(buf + ofs, field->value_.chars_, field->len_);
+      ofs += field->len_;
+    }
+    uint16_t var_end = static_cast<uint16_t>(ofs);
+    if (field->is_external_) {
+      var_end |= VAR_EXTERNAL_FLAG;
+    }
+    MACH_WRITE_TO(uint16_t, var_offsets, var_end);
+    var_offsets += sizeof(uint16_t);
+  }
+  return ofs;
+}
+
+uint32_t RowCodec::DecodeV2(const char *buf, Row *row) const {
+  const unsigned char *bitmap = reinterpret_cast<const unsigned char *>(buf);
+  const char *var_offsets = buf + var_offsets_begin_;
+  uint32_t var_begin = GetVarDataBegin();
+  for (uint32_t i = 0; i < types_.size(); i++) {
+    bool is_null = IsNullBit(bitmap, i);
+    Field *field;
+    if (IsFixedWidth(i)) {
+      field = ALLOC_P(row->heap_, Field)(types_[i]);
+      if (!is_null) {
+        memcpy(&field->value_, buf + column_layout_[i], FIXED_WIDTH);
+        field->len_ = FIXED_WIDTH;
+        field->is_null_ = false;
+      }
+    } else {
+      uint16_t raw_end = MACH_READ_FROM(uint16_t, var_offsets + column_layout_[i] * sizeof(uint16_t));
+      uint32_t var_end = raw_end & ~VAR_EXTERNAL_FLAG;
+      if (is_null) {
+        field = ALLOC_P(row->heap_, Field)(types_[i]);
+      } else {
+        field = NewCharField(row, types_[i], buf + var_begin, var_end - var_begin);
+        field->is_external_ = (raw_end & VAR_EXTERNAL_FLAG) != 0;
+      }
+      var_begin = var_end;
+    }
+    row->fields_.push_back(field);
+  }
+  return var_begin;
+}
+
+bool RowCodec::FitsPax(const Row &row) const {
+  ASSERT(row.fields_.size() == types_.size(), "field nums not match.");
+  for (auto i : var_columns_) {
+    const Field *field = row.fields_[i];
+    if (encodings_[i] == kEncodingDictionary) {
+      continue;
+    }
+    if (!field->is_null_ && (field->is_external_ || field->len_ + sizeof(uint16_t) > pax_widths_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RowCodec::EncodePax(const Row &row, const uint32_t *codes, uint32_t slot, char *area) const {
+  const auto &fields = row.fields_;
+  for (uint32_t i = 0; i < types_.size(); i++) {
+    unsigned char *bitmap = reinterpret_cast<unsigned char *>(area + pax_null_offsets_[i]);
+    char *value = area + pax_value_offsets_[i] + slot * pax_widths_[i];
+    const Field *field = fields[i];
+    if (field->is_null_) {
+      SetNullBit(bitmap, slot);
+      continue;
+    }
+    ClearNullBit(bitmap, slot);
+    if (IsFixedWidth(i)) {
+      memcpy(value, &field->value_, FIXED_WIDTH);
+    } else if (encodings_[i] == kEncodingDictionary) {
+      MACH_WRITE_TO(uint16_t, value, static_cast<uint16_t>(codes[i]));
+    } else {
+      MACH_WRITE_TO(uint16_t, value, static_cast<uint16_t>(field->len_));
+      memcpy(value + sizeof(uint16_t), field->value_.chars_, field->len_);
+    }
+  }
+}
+
+void RowCodec::DecodePax(const char *area, const uint32_t *slots, uint32_t count,
+                         const std::vector<bool> *fetch_mask, const std::vector<ColumnDictionary> *dictionaries,
+                         Row *rows) const {
+  for (uint32_t r = 0; r < count; r++) {
+    ASSERT(rows[r].fields_.empty(), "Row is not empty");
+    rows[r].fields_.reserve(types_.size());
+  }
+  for (uint32_t i = 0; i < types_.size(); i++) {
+    if (fetch_mask != nullptr && !(*fetch_mask)[i]) {
+      for (uint32_t r = 0; r < count; r++) {
+        rows[r].fields_.push_back(ALLOC_P(rows[r].heap_, Field)(types_[i]));
+      }
+      continue;
+    }
+    const unsigned char *bitmap = reinterpret_cast<const unsigned char *>(area + pax_null_offsets_[i]);
+    const char *values = area + pax_value_offsets_[i];
+    uint32_t width = pax_widths_[i];
+    for (uint32_t r = 0; r < count; r++) {
+      Row *row = &rows[r];
+      const char *value = values + slots[r] * width;
+      Field *field;
+      if (IsNullBit(bitmap, slots[r])) {
+        field = ALLOC_P(row->heap_, Field)(types_[i]);
+      } else if (IsFixedWidth(i)) {
+        field = ALLOC_P(row->heap_, Field)(types_[i]);
+        memcpy(&field->value_, value, FIXED_WIDTH);
+        field->len_ = FIXED_WIDTH;
+        field->is_null_ = false;
+      } else if (encodings_[i] == kEncodingDictionary) {
+        const std::string &text = (*dictionaries)[i].GetValue(MACH_READ_FROM(uint16_t, value));
+        field = NewCharField(row, types_[i], text.data(), static_cast<uint32_t>(text.size()));
+      } else {
+        field = NewCharField(row, types_[i], value + sizeof(uint16_t), MACH_READ_FROM(uint16_t, value));
+      }
+      row->fields_.push_back(field);
+    }
+  }
+}
+
+bool RowCodec::IsPaxNull(const char *area, uint32_t column_index, uint32_t slot) const {
+  return IsNullBit(reinterpret_cast<const unsigned char *>(area + pax_null_offsets_[column_index]), slot);
+}
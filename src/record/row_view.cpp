@@ -0,0 +1,166 @@
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, const Schema *schema, RowId rid) {
+  data_ = data;
+  schema_ = schema;
+  row_format_ = schema->GetRowFormat();
+  if (row_format_ == kRowFormatV2) {
+    rid_ = rid;
+    field_count_ = schema->GetColumnCount();
+    bitmap_ = reinterpret_cast<const unsigned char *>(data);
+    resolved_ = 0;
+    return;
+  }
+  rid_ = RowId(MACH_READ_FROM(int64_t, data));
+  field_count_ = static_cast<uint32_t>(MACH_READ_FROM(size_t, data + sizeof(int64_t)));
+  ASSERT(field_count_ == schema->GetColumnCount(), "field nums not match.");
+  bitmap_ = reinterpret_cast<const unsigned char *>(data + sizeof(int64_t) + sizeof(size_t));
+  offsets_[0] = sizeof(int64_t) + sizeof(size_t) + (field_count_ + 7) / 8;
+  resolved_ = 1;
+}
+
+uint32_t RowView::GetFieldOffset(uint32_t idx) const {
+  ASSERT(idx <= field_count_, "Failed to access field");
+  if (row_format_ == kRowFormatV2) {
+    if (idx == field_count_) {
+      return GetVarBegin(schema_->GetVarColumnCount());
+    }
+    return schema_->IsFixedWidth(idx) ? schema_->GetFixedOffset(idx) : GetVarBegin(schema_->GetVarIndex(idx));
+  }
+  if (idx < resolved_) {
+    return offsets_[idx];
+  }
+  uint32_t i = resolved_ - 1;
+  uint32_t ofs = offsets_[i];
+  for (; i < idx; i++) {
+    if (!IsNull(i)) {
+      TypeId type = GetTypeId(i);
+      ofs += (type == TypeId::kTypeChar) ? sizeof(uint32_t) + MACH_READ_UINT32(data_ + ofs) : Type::GetTypeSize(type);
+    }
+    if (i + 1 <= MAX_CACHED_OFFSETS) {
+      offsets_[i + 1] = ofs;
+      resolved_ = i + 2;
+    }
+  }
+  return ofs;
+}
+
+int32_t RowView::GetInt(uint32_t idx) const {
+  ASSERT(GetTypeId(idx) == TypeId::kTypeInt && !IsNull(idx), "Invalid int access.");
+  return MACH_READ_FROM(int32_t, data_ + GetFieldOffset(idx));
+}
+
+float RowView::GetFloat(uint32_t idx) const {
+  ASSERT(GetTypeId(idx) == TypeId::kTypeFloat && !IsNull(idx), "Invalid float access.");
+  return MACH_READ_FROM(float, data_ + GetFieldOffset(idx));
+}
+
+bool RowView::IsExternal(uint32_t idx) const {
+  if (row_format_ != kRowFormatV2 || schema_->IsFixedWidth(idx) || IsNull(idx)) {
+    return false;
+  }
+  return (GetVarEnd(schema_->GetVarIndex(idx)) & RowCodec::VAR_EXTERNAL_FLAG) != 0;
+}
+
+const char *RowView::GetChars(uint32_t idx, uint32_t *len) const {
+  ASSERT(GetTypeId(idx) == TypeId::kTypeChar && !IsNull(idx), "Invalid char access.");
+  if (row_format_ == kRowFormatV2) {
+    uint32_t var_index = schema_->GetVarIndex(idx);
+    uint32_t begin = GetVarBegin(var_index);
+    *len = GetVarBegin(var_index + 1) - begin;
+    return data_ + begin;
+  }
+  const char *p = data_ + GetFieldOffset(idx);
+  *len = MACH_READ_UINT32(p);
+  return p + sizeof(uint32_t);
+}
+
+uint32_t RowView::GetSerializedSize() const {
+  return GetFieldOffset(field_count_);
+}
+
+int RowView::CompareField(uint32_t idx, const RowView &other, uint32_t other_idx) const {
+  if (IsNull(idx) || other.IsNull(other_idx)) {
+    return 0;
+  }
+  switch (GetTypeId(idx)) {
+    case TypeId::kTypeInt: {
+      int32_t lhs = GetInt(idx), rhs = other.GetInt(other_idx);
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    case TypeId::kTypeFloat: {
+      float lhs = GetFloat(idx), rhs = other.GetFloat(other_idx);
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    case TypeId::kTypeChar: {
+      uint32_t lhs_len, rhs_len;
+      const char *lhs = GetChars(idx, &lhs_len);
+      const char *rhs = other.GetChars(other_idx, &rhs_len);
+      return CompareChars(lhs, lhs_len, rhs, rhs_len);
+    }
+    default:
+      break;
+  }
+  ASSERT(false, "Unknown field type.");
+  return 0;
+}
+
+int RowView::CompareToField(uint32_t idx, const Field &field, bool *is_null) const {
+  ASSERT(GetTypeId(idx) == field.GetTypeId(), "Not comparable.");
+  *is_null = IsNull(idx) || field.IsNull();
+  if (*is_null) {
+    return 0;
+  }
+  switch (field.GetTypeId()) {
+    case TypeId::kTypeInt: {
+      int32_t lhs = GetInt(idx), rhs = field.value_.integer_;
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    case TypeId::kTypeFloat: {
+      float lhs = GetFloat(idx), rhs = field.value_.float_;
+      return (lhs > rhs) - (lhs < rhs);
+    }
+    case TypeId::kTypeChar: {
+      uint32_t len;
+      const char *lhs = GetChars(idx, &len);
+      return CompareChars(lhs, len, field.value_.chars_, field.len_);
+    }
+    default:
+      break;
+  }
+  ASSERT(false, "Unknown field type.");
+  return 0;
+}
+
+CmpBool RowView::CompareEquals(uint32_t idx, const Field &field) const {
+  bool is_null;
+  int cmp = CompareToField(idx, field, &is_null);
+  return is_null ? CmpBool::kNull : GetCmpBool(cmp == 0);
+}
+
+CmpBool RowView::CompareLessThan(uint32_t idx, const Field &field) const {
+  bool is_null;
+  int cmp = CompareToField(idx, field, &is_null);
+  return is_null ? CmpBool::kNull : GetCmpBool(cmp < 0);
+}
+
+CmpBool RowView::CompareGreaterThan(uint32_t idx, const Field &field) const {
+  bool is_null;
+  int cmp = CompareToField(idx, field, &is_null);
+  return is_null ? CmpBool::kNull : GetCmpBool(cmp > 0);
+}
+
+Field *RowView::GetField(uint32_t idx, MemHeap *heap) const {
+  Field *field = nullptr;
+  TypeId type = GetTypeId(idx);
+  bool is_null = IsNull(idx);
+  if (row_format_ == kRowFormatV2 && type == TypeId::kTypeChar && !is_null) {
+    uint32_t len;
+    const char *chars = GetChars(idx, &len);
+    field = ALLOC_P(heap, Field)(type, const_cast<char *>(chars), len, true);
+    field->is_external_ = IsExternal(idx);
+    return field;
+  }
+  Field::DeserializeFrom(const_cast<char *>(data_) + (is_null ? 0 : GetFieldOffset(idx)), type, &field, is_null, heap);
+  return field;
+}
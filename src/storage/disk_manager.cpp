@@ -1,13 +1,24 @@
+#include <algorithm>
 #include <stdexcept>
 #include <sys/stat.h>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "storage/disk_manager.h"
+#include "storage/page_compressor.h"
+
+namespace {
+
+/** a compressed page must save at least one slot unit */
+constexpr uint32_t MAX_SLOT_UNITS = PAGE_SIZE / DiskManager::SLOT_UNIT - 1;
+constexpr uint32_t MAX_COMPRESSED_SIZE = MAX_SLOT_UNITS * DiskManager::SLOT_UNIT - DiskManager::SLOT_HEADER_SIZE;
+
+}  // namespace
 
 DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  bool created = !db_io_.is_open();
   // directory or file does not exist
   if (!db_io_.is_open()) {
     db_io_.clear();
@@ -21,26 +32,83 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  // slots left by an earlier db file of the same name do not belong to a new one
+  std::string slot_file = db_file + SLOT_FILE_SUFFIX;
+  if (!created) {
+    slot_io_.open(slot_file, std::ios::binary | std::ios::in | std::ios::out);
+  }
+  if (!slot_io_.is_open()) {
+    slot_io_.clear();
+    slot_io_.open(slot_file, std::ios::binary | std::ios::trunc | std::ios::out);
+    slot_io_.close();
+    slot_io_.open(slot_file, std::ios::binary | std::ios::in | std::ios::out);
+    if (!slot_io_.is_open()) {
+      throw std::exception();
+    }
+  }
+  LoadSlots();
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
     db_io_.close();
+    slot_io_.close();
     closed = true;
   }
 }
 
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto iter = slots_.find(logical_page_id);
+  if (iter == slots_.end()) {
+    ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+    return;
+  }
+  char buf[PAGE_SIZE];
+  slot_io_.seekg(iter->second.offset_ + SLOT_HEADER_SIZE);
+  slot_io_.read(buf, iter->second.len_);
+  bool decompressed = slot_io_.gcount() == iter->second.len_ &&
+                      PageCompressor::Decompress(buf, iter->second.len_, page_data, PAGE_SIZE);
+  ASSERT(decompressed, "Corrupted compressed page.");
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (compressed_pages_.count(logical_page_id) != 0) {
+    char buf[PAGE_SIZE];
+    uint32_t len = PageCompressor::Compress(page_data, PAGE_SIZE, buf, MAX_COMPRESSED_SIZE);
+    if (len > 0) {
+      WriteSlot(logical_page_id, buf, len);
+      return;
+    }
+  }
+  FreeSlot(logical_page_id);
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+void DiskManager::SetPageCompression(page_id_t logical_page_id, bool enable) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (enable) {
+    compressed_pages_.insert(logical_page_id);
+  } else {
+    compressed_pages_.erase(logical_page_id);
+  }
+}
+
+uint32_t DiskManager::GetStoredSize(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto iter = slots_.find(logical_page_id);
+  return iter == slots_.end() ? PAGE_SIZE : iter->second.units_ * SLOT_UNIT;
+}
+
+size_t DiskManager::GetCompressedPageCount() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  return slots_.size();
+}
+
 page_id_t DiskManager::AllocatePage() {
   DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   ASSERT(meta_page->num_allocated_pages_ < MAX_VALID_PAGE_ID, "Pages exceed!");
@@ -62,6 +130,9 @@ page_id_t DiskManager::AllocatePage() {
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  compressed_pages_.erase(logical_page_id);
+  FreeSlot(logical_page_id);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
   DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   meta_page->num_allocated_pages_--;
@@ -78,6 +149,33 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
   return;
 }
 
+void DiskManager::DeAllocatePages(const std::vector<page_id_t> &logical_page_ids) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  std::vector<page_id_t> page_ids(logical_page_ids);
+  std::sort(page_ids.begin(), page_ids.end());
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  char bitmap_data_[PAGE_SIZE];
+  BitmapPage<PAGE_SIZE> *bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap_data_);
+  for (size_t i = 0; i < page_ids.size();) {
+    uint32_t extent_id = page_ids[i] / BITMAP_SIZE;
+    ReadPhysicalPage(extent_id * BITMAP_SIZE + 1, bitmap_data_);
+    for (; i < page_ids.size() && page_ids[i] / BITMAP_SIZE == extent_id; i++) {
+      compressed_pages_.erase(page_ids[i]);
+      FreeSlot(page_ids[i]);
+      // a page listed twice or already free is only freed once
+      if (bitmap->DeAllocatePage(page_ids[i] % BITMAP_SIZE)) {
+        meta_page->num_allocated_pages_--;
+        meta_page->extent_used_page_[extent_id]--;
+      }
+    }
+    WritePhysicalPage(extent_id * BITMAP_SIZE + 1, bitmap_data_);
+  }
+  while (meta_page->num_extents_ > 0 && meta_page->extent_used_page_[meta_page->num_extents_ - 1] == 0) {
+    meta_page->num_extents_--;
+  }
+  WritePhysicalPage(META_PAGE_ID, meta_data_);
+}
+
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
   char bitmap_data_[PAGE_SIZE];
   ReadPhysicalPage(logical_page_id / BITMAP_SIZE * BITMAP_SIZE + 1, bitmap_data_);
@@ -89,6 +187,89 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   return logical_page_id + logical_page_id / BITMAP_SIZE + 2;
 }
 
+void DiskManager::LoadSlots() {
+  free_slots_.assign(MAX_SLOT_UNITS + 1, {});
+  slot_io_.seekg(0, std::ios::end);
+  auto file_size = static_cast<uint64_t>(slot_io_.tellg());
+  uint64_t offset = 0;
+  char header[SLOT_HEADER_SIZE];
+  while (offset + SLOT_HEADER_SIZE <= file_size) {
+    slot_io_.seekg(offset);
+    slot_io_.read(header, SLOT_HEADER_SIZE);
+    page_id_t page_id = MACH_READ_FROM(page_id_t, header);
+    uint16_t len = MACH_READ_FROM(uint16_t, header + sizeof(page_id_t));
+    uint16_t units = MACH_READ_FROM(uint16_t, header + sizeof(page_id_t) + sizeof(uint16_t));
+    // a slot cut short by a crash is dropped along with everything after it
+    if (units == 0 || units > MAX_SLOT_UNITS || offset + units * SLOT_UNIT > file_size) {
+      break;
+    }
+    if (page_id == INVALID_PAGE_ID) {
+      free_slots_[units].push_back(offset);
+    } else {
+      slots_[page_id] = {offset, len, units};
+      compressed_pages_.insert(page_id);
+    }
+    offset += units * SLOT_UNIT;
+  }
+  slot_io_.clear();
+  slot_file_size_ = offset;
+}
+
+void DiskManager::WriteSlot(page_id_t logical_page_id, const char *data, uint32_t len) {
+  auto units = static_cast<uint16_t>((SLOT_HEADER_SIZE + len + SLOT_UNIT - 1) / SLOT_UNIT);
+  auto iter = slots_.find(logical_page_id);
+  uint64_t offset;
+  if (iter != slots_.end() && iter->second.units_ == units) {
+    offset = iter->second.offset_;
+  } else if (!free_slots_[units].empty()) {
+    offset = free_slots_[units].back();
+    free_slots_[units].pop_back();
+  } else {
+    offset = slot_file_size_;
+    slot_file_size_ += units * SLOT_UNIT;
+  }
+  // whole slots are written, the slot file always ends on a slot boundary
+  char buf[PAGE_SIZE];
+  memset(buf, 0, units * SLOT_UNIT);
+  MACH_WRITE_TO(page_id_t, buf, logical_page_id);
+  MACH_WRITE_TO(uint16_t, buf + sizeof(page_id_t), static_cast<uint16_t>(len));
+  MACH_WRITE_TO(uint16_t, buf + sizeof(page_id_t) + sizeof(uint16_t), units);
+  memcpy(buf + SLOT_HEADER_SIZE, data, len);
+  slot_io_.seekp(offset);
+  slot_io_.write(buf, units * SLOT_UNIT);
+  if (slot_io_.bad()) {
+    LOG(ERROR) << "I/O error while writing";
+    return;
+  }
+  slot_io_.flush();
+  // the old slot is only given back once the new one is written
+  if (iter != slots_.end() && iter->second.offset_ != offset) {
+    WriteSlotHeader(iter->second.offset_, INVALID_PAGE_ID, 0, iter->second.units_);
+    free_slots_[iter->second.units_].push_back(iter->second.offset_);
+  }
+  slots_[logical_page_id] = {offset, static_cast<uint16_t>(len), units};
+}
+
+void DiskManager::FreeSlot(page_id_t logical_page_id) {
+  auto iter = slots_.find(logical_page_id);
+  if (iter == slots_.end()) {
+    return;
+  }
+  WriteSlotHeader(iter->second.offset_, INVALID_PAGE_ID, 0, iter->second.units_);
+  free_slots_[iter->second.units_].push_back(iter->second.offset_);
+  slots_.erase(iter);
+}
+
+void DiskManager::WriteSlotHeader(uint64_t offset, page_id_t logical_page_id, uint16_t len, uint16_t units) {
+  char header[SLOT_HEADER_SIZE];
+  MACH_WRITE_TO(page_id_t, header, logical_page_id);
+  MACH_WRITE_TO(uint16_t, header + sizeof(page_id_t), len);
+  MACH_WRITE_TO(uint16_t, header + sizeof(page_id_t) + sizeof(uint16_t), units);
+  slot_io_.seekp(offset);
+  slot_io_.write(header, SLOT_HEADER_SIZE);
+  slot_io_.flush();
+}
+
 int DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
@@ -0,0 +1,149 @@
+#include "storage/page_compressor.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t NIBBLE_MAX = 15;
+constexpr uint32_t EMPTY_POSITION = UINT32_MAX;
+
+inline uint32_t Load32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/**
+ * Append the part of a length that does not fit its nibble
+ */
+bool WriteLength(uint32_t len, char *dst, uint32_t *pos, uint32_t capacity) {
+  for (; len >= 255; len -= 255) {
+    if (*pos >= capacity) {
+      return false;
+    }
+    dst[(*pos)++] = static_cast<char>(255);
+  }
+  if (*pos >= capacity) {
+    return false;
+  }
+  dst[(*pos)++] = static_cast<char>(len);
+  return true;
+}
+
+bool ReadLength(const char *src, uint32_t len, uint32_t *pos, uint32_t *value) {
+  uint8_t byte;
+  do {
+    if (*pos >= len) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(src[(*pos)++]);
+    *value += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Append a sequence, match_len is 0 for the last one which has no match
+ */
+bool WriteSequence(const char *literals, uint32_t literal_len, uint32_t offset, uint32_t match_len, char *dst,
+                   uint32_t *pos, uint32_t capacity) {
+  if (*pos >= capacity) {
+    return false;
+  }
+  uint32_t match_code = match_len == 0 ? 0 : match_len - PageCompressor::MIN_MATCH;
+  uint8_t token = (std::min(literal_len, NIBBLE_MAX) << 4) | std::min(match_code, NIBBLE_MAX);
+  dst[(*pos)++] = static_cast<char>(token);
+  if (literal_len >= NIBBLE_MAX && !WriteLength(literal_len - NIBBLE_MAX, dst, pos, capacity)) {
+    return false;
+  }
+  if (*pos + literal_len > capacity) {
+    return false;
+  }
+  memcpy(dst + *pos, literals, literal_len);
+  *pos += literal_len;
+  if (match_len == 0) {
+    return true;
+  }
+  if (*pos + sizeof(uint16_t) > capacity) {
+    return false;
+  }
+  dst[(*pos)++] = static_cast<char>(offset & 0xff);
+  dst[(*pos)++] = static_cast<char>(offset >> 8);
+  return match_code < NIBBLE_MAX || WriteLength(match_code - NIBBLE_MAX, dst, pos, capacity);
+}
+
+}  // namespace
+
+uint32_t PageCompressor::Compress(const char *src, uint32_t len, char *dst, uint32_t capacity) {
+  uint32_t table[1 << HASH_BITS];
+  for (auto &position : table) {
+    position = EMPTY_POSITION;
+  }
+  uint32_t pos = 0;
+  uint32_t anchor = 0;
+  uint32_t ip = 0;
+  while (ip + MIN_MATCH <= len) {
+    uint32_t sequence = Load32(src + ip);
+    uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+    uint32_t ref = table[hash];
+    table[hash] = ip;
+    if (ref == EMPTY_POSITION || ip - ref > MAX_OFFSET || Load32(src + ref) != sequence) {
+      ip++;
+      continue;
+    }
+    uint32_t match_len = MIN_MATCH;
+    while (ip + match_len < len && src[ref + match_len] == src[ip + match_len]) {
+      match_len++;
+    }
+    if (!WriteSequence(src + anchor, ip - anchor, ip - ref, match_len, dst, &pos, capacity)) {
+      return 0;
+    }
+    ip += match_len;
+    anchor = ip;
+  }
+  if (!WriteSequence(src + anchor, len - anchor, 0, 0, dst, &pos, capacity)) {
+    return 0;
+  }
+  return pos;
+}
+
+bool PageCompressor::Decompress(const char *src, uint32_t len, char *dst, uint32_t dst_len) {
+  uint32_t pos = 0;
+  uint32_t op = 0;
+  while (pos < len) {
+    auto token = static_cast<uint8_t>(src[pos++]);
+    uint32_t literal_len = token >> 4;
+    if (literal_len == NIBBLE_MAX && !ReadLength(src, len, &pos, &literal_len)) {
+      return false;
+    }
+    if (pos + literal_len > len || op + literal_len > dst_len) {
+      return false;
+    }
+    memcpy(dst + op, src + pos, literal_len);
+    pos += literal_len;
+    op += literal_len;
+    // the last sequence has no match
+    if (pos == len) {
+      break;
+    }
+    if (pos + sizeof(uint16_t) > len) {
+      return false;
+    }
+    uint32_t offset = static_cast<uint8_t>(src[pos]) | (static_cast<uint8_t>(src[pos + 1]) << 8);
+    pos += sizeof(uint16_t);
+    uint32_t match_len = token & NIBBLE_MAX;
+    if (match_len == NIBBLE_MAX && !ReadLength(src, len, &pos, &match_len)) {
+      return false;
+    }
+    match_len += MIN_MATCH;
+    if (offset == 0 || offset > op || op + match_len > dst_len) {
+      return false;
+    }
+    // matches may overlap their own output, e.g. a run of zeros, so copy byte by byte
+    for (uint32_t i = 0; i < match_len; i++, op++) {
+      dst[op] = dst[op - offset];
+    }
+  }
+  return op == dst_len;
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "storage/table_heap.h"
 
 /*
@@ -31,30 +33,114 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
 */
 
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  page->WLatch();
-  bool status = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  if (status) {
-    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  ArenaMemHeap heap;
+  std::vector<Field> stored_fields;
+  if (!ToastRow(row, &stored_fields, &heap)) {
+    return false;
+  }
+  if (stored_fields.empty()) {
+    return InsertInline(row, txn);
+  }
+  Row stored(stored_fields, &heap);
+  if (!InsertInline(stored, txn)) {
+    FreeOverflow(stored);
+    return false;
+  }
+  row.SetRowId(stored.GetRowId());
+  return true;
+}
+
+bool TableHeap::InsertInline(Row &row, Transaction *txn) {
+  uint32_t required_space;
+  std::vector<uint32_t> codes;
+  if (IsPax()) {
+    // a value that does not fit a slot fits no page
+    if (!schema_->GetCodec().FitsPax(row) || !EncodeDictionaryValues(row, &codes)) {
+      return false;
+    }
+    required_space = 1;
+  } else {
+    uint32_t serialized_size = row.GetSerializedSize(schema_);
+    if (serialized_size > TablePage::SIZE_MAX_ROW) {
+      return false;
+    }
+    required_space = serialized_size + TablePage::SIZE_TUPLE;
+  }
+  // the last page takes most inserts, fill levels are only searched once it is full
+  page_id_t last_page_id = directory_.GetPageId(directory_.GetPageCount() - 1);
+  if (InsertIntoPage(last_page_id, row, codes.data(), txn)) {
+    return true;
+  }
+  int index = directory_.FindFreePage(required_space);
+  if (index >= 0 && directory_.GetPageId(index) != last_page_id &&
+      InsertIntoPage(directory_.GetPageId(index), row, codes.data(), txn)) {
     return true;
   }
+  // append a new page at the tail, the first page never changes
   page_id_t new_page_id;
-  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-  page->WLatch();
-  page->SetPrevPageId(new_page_id);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+  if (new_page == nullptr) {
+    return false;
+  }
+  if (compressed_) {
+    buffer_pool_manager_->SetPageCompression(new_page_id, true);
+  }
   new_page->WLatch();
-  new_page->Init(new_page_id, INVALID_PAGE_ID, log_manager_, txn);
-  new_page->SetNextPageId(first_page_id_);
-  status = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_space = InitPage(new_page, new_page_id, last_page_id, txn);
   new_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(new_page_id, true);
-  first_page_id_ = new_page_id;
+  SetNextPageId(last_page_id, new_page_id);
+  directory_.AppendPage(new_page_id, free_space);
+  zone_map_.AppendPage(true);
+  return InsertIntoPage(new_page_id, row, codes.data(), txn);
+}
+
+bool TableHeap::InsertIntoPage(page_id_t page_id, Row &row, const uint32_t *codes, Transaction *txn) {
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  bool status;
+  uint32_t free_space;
+  page->WLatch();
+  if (IsPax()) {
+    auto pax_page = reinterpret_cast<PaxPage *>(page);
+    status = pax_page->InsertTuple(row, codes, schema_, txn, lock_manager_, log_manager_);
+    free_space = pax_page->GetFreeSpaceRemaining(schema_);
+  } else {
+    auto table_page = reinterpret_cast<TablePage *>(page);
+    status = table_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    free_space = table_page->GetFreeSpaceRemaining();
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, status);
+  if (status) {
+    directory_.SetFreeSpace(page_id, free_space);
+    zone_map_.Widen(directory_.GetPageIndex(page_id), row);
+  }
   return status;
 }
 
+uint32_t TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn) {
+  if (IsPax()) {
+    auto pax_page = reinterpret_cast<PaxPage *>(page);
+    pax_page->Init(page_id, prev_page_id, schema_, log_manager_, txn);
+    return pax_page->GetFreeSpaceRemaining(schema_);
+  }
+  auto table_page = reinterpret_cast<TablePage *>(page);
+  table_page->Init(page_id, prev_page_id, log_manager_, txn);
+  return table_page->GetFreeSpaceRemaining();
+}
+
+void TableHeap::SetNextPageId(page_id_t page_id, page_id_t next_page_id) {
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  page->WLatch();
+  if (IsPax()) {
+    reinterpret_cast<PaxPage *>(page)->SetNextPageId(next_page_id);
+  } else {
+    reinterpret_cast<TablePage *>(page)->SetNextPageId(next_page_id);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
@@ -64,9 +150,13 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (IsPax()) {
+    reinterpret_cast<PaxPage *>(page)->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  } else {
+    page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
   return true;
 }
 
@@ -77,17 +167,63 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
   if (page == nullptr) {
     return false;
   }
+  if (IsPax()) {
+    return UpdatePax(reinterpret_cast<PaxPage *>(page), row, rid, txn);
+  }
+  ArenaMemHeap heap;
+  std::vector<Field> stored_fields;
+  if (!ToastRow(row, &stored_fields, &heap)) {
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return false;
+  }
+  Row stored(stored_fields, &heap);
+  Row &new_row = stored_fields.empty() ? row : stored;
   // Otherwise, mark
-  Row *old_row = new Row(rid);
+  Row old_row(rid, &heap);
   row.SetRowId(rid);
-  //GetTuple(old_row, txn);
+  new_row.SetRowId(rid);
   page->WLatch();
-  int status = page->UpdateTuple(row, old_row, schema_, txn, lock_manager_, log_manager_);
+  int status = page->UpdateTuple(new_row, &old_row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  delete old_row;
+  if (status > 0) {
+    directory_.SetFreeSpace(rid.GetPageId(), free_space);
+    zone_map_.Widen(directory_.GetPageIndex(rid.GetPageId()), new_row);
+    // the replaced values are unreachable now
+    FreeOverflow(old_row);
+    return true;
+  }
+  FreeOverflow(stored);
   if (status < 0) {
-    return MarkDelete(rid, txn) && InsertTuple(row, txn);
+    // the tuple moves to another page, the old one and its overflow chains go once the new one is in
+    if (!MarkDelete(rid, txn)) {
+      return false;
+    }
+    if (!InsertTuple(row, txn)) {
+      RollbackDelete(rid, txn);
+      row.SetRowId(rid);
+      return false;
+    }
+    ApplyDelete(rid, txn);
+    return true;
+  }
+  return false;
+}
+
+bool TableHeap::UpdatePax(PaxPage *page, Row &row, const RowId &rid, Transaction *txn) {
+  std::vector<uint32_t> codes;
+  if (!EncodeDictionaryValues(row, &codes)) {
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return false;
+  }
+  row.SetRowId(rid);
+  page->WLatch();
+  bool status = page->UpdateTuple(row, codes.data(), rid, schema_, txn, lock_manager_, log_manager_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), status);
+  if (status) {
+    zone_map_.Widen(directory_.GetPageIndex(rid.GetPageId()), row);
   }
   return status;
 }
@@ -97,11 +233,26 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   assert(page != nullptr);
   // Step2: Delete the tuple from the page.
+  if (IsPax()) {
+    auto pax_page = reinterpret_cast<PaxPage *>(page);
+    pax_page->WLatch();
+    pax_page->ApplyDelete(rid, txn, log_manager_);
+    uint32_t free_space = pax_page->GetFreeSpaceRemaining(schema_);
+    pax_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+    directory_.SetFreeSpace(rid.GetPageId(), free_space);
+    return;
+  }
   page->WLatch();
+  RowView view;
+  if (page->GetTupleView(rid, schema_, &view, true)) {
+    FreeOverflow(view);
+  }
   page->ApplyDelete(rid, txn, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return;
+  directory_.SetFreeSpace(rid.GetPageId(), free_space);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
@@ -110,22 +261,56 @@ void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
   assert(page != nullptr);
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  if (IsPax()) {
+    reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid, txn, log_manager_);
+  } else {
+    page->RollbackDelete(rid, txn, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
 void TableHeap::FreeHeap() {
-  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID; ) {
+  bool toastable = schema_->GetRowFormat() == kRowFormatV2 && schema_->GetVarColumnCount() > 0;
+  // the data pages are listed by the directory, only pages owning overflow chains are read
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(directory_.GetPageCount());
+  for (uint32_t i = 0; i < directory_.GetPageCount(); i++) {
+    page_id_t page_id = directory_.GetPageId(i);
+    page_ids.push_back(page_id);
+    if (!toastable) {
+      continue;
+    }
     auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    // tuples only marked as deleted still own their overflow chains
+    for (uint32_t slot = 0; slot < page->GetTupleCount(); slot++) {
+      RowView view;
+      if (page->GetTupleView(RowId(page_id, slot), schema_, &view, true)) {
+        FreeOverflow(view);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  for (page_id_t page_id = dictionary_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
     page_id_t next_page_id = page->GetNextPageId();
     buffer_pool_manager_->UnpinPage(page_id, false);
-    buffer_pool_manager_->DeletePage(page_id);
+    page_ids.push_back(page_id);
     page_id = next_page_id;
   }
+  buffer_pool_manager_->DeletePages(page_ids);
+  directory_.FreeDirectory();
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
+  return FetchTuple(row, txn, nullptr);
+}
+
+bool TableHeap::GetTuple(Row *row, Transaction *txn, const std::vector<uint32_t> &fetch_columns) {
+  return FetchTuple(row, txn, &fetch_columns);
+}
+
+bool TableHeap::FetchTuple(Row *row, Transaction *txn, const std::vector<uint32_t> *fetch_columns) {
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage((row->GetRowId()).GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -133,28 +318,441 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
     return false;
   }
   // Otherwise, get the tuple.
+  std::vector<bool> fetch_mask;
+  if (IsPax() && fetch_columns != nullptr) {
+    fetch_mask = GetFetchMask(*fetch_columns);
+  }
   page->RLatch();
-  page->GetTuple(row, schema_, txn, lock_manager_);
+  bool status = ReadTuple(page, row, txn, fetch_columns == nullptr ? nullptr : &fetch_mask);
   page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false);
+  if (!status) {
+    return false;
+  }
+  DetoastRow(row, fetch_columns);
   return true;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
-  RowId first_rid;
-  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID; ) {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+bool TableHeap::ReadTuple(Page *page, Row *row, Transaction *txn, const std::vector<bool> *fetch_mask) {
+  if (!IsPax()) {
+    return reinterpret_cast<TablePage *>(page)->GetTuple(row, schema_, txn, lock_manager_);
+  }
+  dictionary_latch_.RLock();
+  bool status = reinterpret_cast<PaxPage *>(page)->GetTuple(row, schema_, fetch_mask, GetDictionaries(), txn,
+                                                            lock_manager_);
+  dictionary_latch_.RUnlock();
+  return status;
+}
+
+void TableHeap::GetTuples(const std::vector<RowId> &rids, Transaction *txn, const std::vector<uint32_t> *fetch_columns,
+                          MemHeap *heap, std::vector<Row> *rows) {
+  std::vector<bool> fetch_mask;
+  if (IsPax() && fetch_columns != nullptr) {
+    fetch_mask = GetFetchMask(*fetch_columns);
+  }
+  size_t begin = rows->size();
+  for (size_t i = 0; i < rids.size();) {
+    ASSERT(i == 0 || rids[i - 1].Get() < rids[i].Get(), "Row ids are not sorted.");
+    page_id_t page_id = rids[i].GetPageId();
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      for (; i < rids.size() && rids[i].GetPageId() == page_id; i++) {
+      }
+      continue;
+    }
     page->RLatch();
-    bool status = page->GetFirstTupleRid(&first_rid);
+    for (; i < rids.size() && rids[i].GetPageId() == page_id; i++) {
+      rows->emplace_back(rids[i], heap);
+      if (!ReadTuple(page, &rows->back(), txn, fetch_columns == nullptr ? nullptr : &fetch_mask)) {
+        rows->pop_back();
+      }
+    }
     page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  // overflow pages are read after the heap page is released
+  for (size_t i = begin; i < rows->size(); i++) {
+    DetoastRow(&(*rows)[i], fetch_columns);
+  }
+}
+
+void TableHeap::SortRowIds(std::vector<RowId> *rids) {
+  std::sort(rids->begin(), rids->end(), [](const RowId &a, const RowId &b) { return a.Get() < b.Get(); });
+  rids->erase(std::unique(rids->begin(), rids->end()), rids->end());
+}
+
+bool TableHeap::GetPageTuples(page_id_t page_id, Transaction *txn, const std::vector<uint32_t> *fetch_columns,
+                              MemHeap *heap, std::vector<Row> *rows, const std::vector<CodeFilter> *code_filters) {
+  int page_index = directory_.GetPageIndex(page_id);
+  uint64_t version = page_index >= 0 ? zone_map_.GetVersion(page_index) : 0;
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  size_t begin = rows->size();
+  page->RLatch();
+  if (IsPax()) {
+    // only the minipages of the fetched columns are read
+    std::vector<bool> fetch_mask;
+    if (fetch_columns != nullptr) {
+      fetch_mask = GetFetchMask(*fetch_columns);
+    }
+    dictionary_latch_.RLock();
+    reinterpret_cast<PaxPage *>(page)->GetTuples(schema_, fetch_columns == nullptr ? nullptr : &fetch_mask,
+                                                 code_filters, GetDictionaries(), heap, rows);
+    dictionary_latch_.RUnlock();
+  } else {
+    auto table_page = reinterpret_cast<TablePage *>(page);
+    for (uint32_t slot = 0; slot < table_page->GetTupleCount(); slot++) {
+      rows->emplace_back(RowId(page_id, slot), heap);
+      if (!table_page->GetTuple(&rows->back(), schema_, txn, lock_manager_)) {
+        rows->pop_back();
+      }
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  // numeric columns are never moved out of line, so the rows have all values the zone map needs,
+  // unless a PAX page left columns or rows unread
+  if (page_index >= 0 && (!IsPax() || (fetch_columns == nullptr && code_filters == nullptr))) {
+    zone_map_.Summarize(page_index, version, rows->data() + begin, rows->size() - begin);
+  }
+  for (size_t i = begin; i < rows->size(); i++) {
+    DetoastRow(&(*rows)[i], fetch_columns);
+  }
+  return true;
+}
+
+std::vector<bool> TableHeap::GetFetchMask(const std::vector<uint32_t> &fetch_columns) const {
+  std::vector<bool> fetch_mask(schema_->GetColumnCount(), false);
+  for (auto column_index : fetch_columns) {
+    fetch_mask[column_index] = true;
+  }
+  return fetch_mask;
+}
+
+uint32_t TableHeap::FindCode(uint32_t column_index, const char *data, uint32_t len) {
+  ASSERT(schema_->GetColumnEncoding(column_index) == kEncodingDictionary, "Column has no dictionary.");
+  dictionary_latch_.RLock();
+  uint32_t code = dictionaries_[column_index].Find(data, len);
+  dictionary_latch_.RUnlock();
+  return code;
+}
+
+uint32_t TableHeap::GetDictionarySize(uint32_t column_index) {
+  ASSERT(schema_->GetColumnEncoding(column_index) == kEncodingDictionary, "Column has no dictionary.");
+  dictionary_latch_.RLock();
+  uint32_t size = dictionaries_[column_index].GetSize();
+  dictionary_latch_.RUnlock();
+  return size;
+}
+
+void TableHeap::EnableCompression() {
+  compressed_ = true;
+  // overflow pages written so far stay as they are, those stored compressed are known to the disk manager
+  for (uint32_t i = 0; i < directory_.GetPageCount(); i++) {
+    buffer_pool_manager_->SetPageCompression(directory_.GetPageId(i), true);
+  }
+}
+
+uint64_t TableHeap::GetStoredSize(uint32_t *compressed_pages) const {
+  uint64_t stored_size = 0;
+  *compressed_pages = 0;
+  for (uint32_t i = 0; i < directory_.GetPageCount(); i++) {
+    buffer_pool_manager_->FlushPage(directory_.GetPageId(i));
+    uint32_t page_size = buffer_pool_manager_->GetStoredSize(directory_.GetPageId(i));
+    stored_size += page_size;
+    *compressed_pages += page_size < PAGE_SIZE;
+  }
+  return stored_size;
+}
+
+bool TableHeap::EncodeDictionaryValues(const Row &row, std::vector<uint32_t> *codes) {
+  if (dictionaries_.empty()) {
+    return true;
+  }
+  codes->assign(schema_->GetColumnCount(), ColumnDictionary::INVALID_CODE);
+  // values seen before only need the read latch
+  bool missing = false;
+  dictionary_latch_.RLock();
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    Field *field = row.GetField(i);
+    if (schema_->GetColumnEncoding(i) == kEncodingDictionary && !field->IsNull()) {
+      (*codes)[i] = dictionaries_[i].Find(field->GetData(), field->GetLength());
+      missing |= (*codes)[i] == ColumnDictionary::INVALID_CODE;
+    }
+  }
+  dictionary_latch_.RUnlock();
+  if (!missing) {
+    return true;
+  }
+  bool status = true;
+  dictionary_latch_.WLock();
+  for (uint32_t i = 0; i < schema_->GetColumnCount() && status; i++) {
+    Field *field = row.GetField(i);
+    if (schema_->GetColumnEncoding(i) != kEncodingDictionary || field->IsNull() ||
+        (*codes)[i] != ColumnDictionary::INVALID_CODE) {
+      continue;
+    }
+    ColumnDictionary &dictionary = dictionaries_[i];
+    // another writer may have added the value in between
+    uint32_t code = dictionary.Find(field->GetData(), field->GetLength());
+    if (code == ColumnDictionary::INVALID_CODE) {
+      status = dictionary.GetSize() < ColumnDictionary::MAX_CODES &&
+               AppendDictionaryEntry(i, field->GetData(), field->GetLength());
+      if (status) {
+        code = dictionary.Add(field->GetData(), field->GetLength());
+      }
+    }
+    (*codes)[i] = code;
+  }
+  dictionary_latch_.WUnlock();
+  return status;
+}
+
+bool TableHeap::AppendDictionaryEntry(uint32_t column_index, const char *data, uint32_t len) {
+  // entry: column index (2) | length (2) | value, never split across pages
+  uint32_t entry_len = 2 * sizeof(uint16_t) + len;
+  ASSERT(entry_len <= OverflowPage::MAX_DATA_SIZE, "Dictionary value too long.");
+  char entry[OverflowPage::MAX_DATA_SIZE];
+  MACH_WRITE_TO(uint16_t, entry, static_cast<uint16_t>(column_index));
+  MACH_WRITE_TO(uint16_t, entry + sizeof(uint16_t), static_cast<uint16_t>(len));
+  memcpy(entry + 2 * sizeof(uint16_t), data, len);
+  auto tail_page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(dictionary_tail_page_id_));
+  if (tail_page == nullptr) {
+    return false;
+  }
+  if (tail_page->AppendPayload(entry, entry_len)) {
+    buffer_pool_manager_->UnpinPage(dictionary_tail_page_id_, true);
+    return true;
+  }
+  page_id_t new_page_id;
+  auto new_page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(new_page_id));
+  if (new_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(dictionary_tail_page_id_, false);
+    return false;
+  }
+  new_page->Init(new_page_id);
+  new_page->AppendPayload(entry, entry_len);
+  tail_page->SetNextPageId(new_page_id);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  buffer_pool_manager_->UnpinPage(dictionary_tail_page_id_, true);
+  dictionary_tail_page_id_ = new_page_id;
+  return true;
+}
+
+void TableHeap::LoadDictionaries() {
+  if (dictionary_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  dictionaries_.resize(schema_->GetColumnCount());
+  // entries are in code order, adding them again hands out the same codes
+  for (page_id_t page_id = dictionary_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Failed to fetch dictionary page.");
+    const char *payload = page->GetPayload();
+    for (uint32_t ofs = 0; ofs < page->GetDataSize(); ) {
+      uint16_t column_index = MACH_READ_FROM(uint16_t, payload + ofs);
+      uint16_t len = MACH_READ_FROM(uint16_t, payload + ofs + sizeof(uint16_t));
+      dictionaries_[column_index].Add(payload + ofs + 2 * sizeof(uint16_t), len);
+      ofs += 2 * sizeof(uint16_t) + len;
+    }
+    dictionary_tail_page_id_ = page_id;
     page_id_t next_page_id = page->GetNextPageId();
-    buffer_pool_manager_->UnpinPage(page_id, status);
-    if (status) return TableIterator(this, first_rid, txn);
+    buffer_pool_manager_->UnpinPage(page_id, false);
     page_id = next_page_id;
   }
-  return TableIterator(this, first_rid, txn);
+}
+
+void TableHeap::DetoastRow(Row *row, const std::vector<uint32_t> *fetch_columns) {
+  // overflow pages are only visited for the values the caller asked for
+  if (fetch_columns == nullptr) {
+    for (auto field : row->GetFields()) {
+      if (field->IsExternal()) {
+        Detoast(field);
+      }
+    }
+  } else {
+    for (auto column_index : *fetch_columns) {
+      Field *field = row->GetField(column_index);
+      if (field->IsExternal()) {
+        Detoast(field);
+      }
+    }
+  }
+}
+
+RowId TableHeap::GetFirstRowId() {
+  // slot -1 makes the search start at the first slot of the first page
+  return GetNextRowId(RowId(first_page_id_, -1));
+}
+
+RowId TableHeap::GetNextRowId(const RowId &cur_rid) {
+  RowId rid = cur_rid, next_rid;
+  while (rid.GetPageId() != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+    bool status;
+    page_id_t next_page_id;
+    page->RLatch();
+    if (IsPax()) {
+      auto pax_page = reinterpret_cast<PaxPage *>(page);
+      status = pax_page->GetNextTupleRid(rid, &next_rid);
+      next_page_id = pax_page->GetNextPageId();
+    } else {
+      auto table_page = reinterpret_cast<TablePage *>(page);
+      status = table_page->GetNextTupleRid(rid, &next_rid);
+      next_page_id = table_page->GetNextPageId();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    if (status) break;
+    rid = RowId(next_page_id, -1);
+  }
+  return next_rid;
+}
+
+TableIterator TableHeap::Begin(Transaction *txn) {
+  return TableIterator(this, GetFirstRowId(), txn);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &fetch_columns) {
+  return TableIterator(this, GetFirstRowId(), txn, fetch_columns);
 }
 
 TableIterator TableHeap::End() {
   return TableIterator(this, RowId(), nullptr);
 }
+
+bool TableHeap::ToastRow(const Row &row, std::vector<Field> *stored, MemHeap *heap) {
+  if (schema_->GetRowFormat() != kRowFormatV2) {
+    return true;
+  }
+  uint32_t field_count = static_cast<uint32_t>(row.GetFieldCount());
+  uint32_t i = 0;
+  for (; i < field_count; i++) {
+    Field *field = row.GetField(i);
+    if (field->GetTypeId() == TypeId::kTypeChar && !field->IsNull() && field->len_ > TOAST_THRESHOLD) {
+      break;
+    }
+  }
+  if (i == field_count) {
+    return true;
+  }
+  stored->reserve(field_count);
+  for (i = 0; i < field_count; i++) {
+    Field *field = row.GetField(i);
+    if (field->GetTypeId() != TypeId::kTypeChar || field->IsNull() || field->len_ <= TOAST_THRESHOLD) {
+      stored->emplace_back(*field);
+      continue;
+    }
+    page_id_t first_page_id = WriteOverflow(field->value_.chars_, field->len_);
+    if (first_page_id == INVALID_PAGE_ID) {
+      for (auto &moved : *stored) {
+        if (moved.IsExternal()) {
+          FreeOverflow(moved.value_.chars_);
+        }
+      }
+      stored->clear();
+      return false;
+    }
+    uint32_t prefix_len = std::min(field->len_, TOAST_PREFIX_LEN);
+    uint32_t pointer_len = OverflowPage::SIZE_TOAST_POINTER + prefix_len;
+    char *pointer = reinterpret_cast<char *>(heap->Allocate(pointer_len));
+    MACH_WRITE_UINT32(pointer, field->len_);
+    MACH_WRITE_TO(page_id_t, pointer + sizeof(uint32_t), first_page_id);
+    memcpy(pointer + OverflowPage::SIZE_TOAST_POINTER, field->value_.chars_, prefix_len);
+    stored->emplace_back(TypeId::kTypeChar, pointer, pointer_len, false);
+    stored->back().is_external_ = true;
+  }
+  return true;
+}
+
+void TableHeap::Detoast(Field *field) {
+  uint32_t len = MACH_READ_UINT32(field->value_.chars_);
+  page_id_t first_page_id = MACH_READ_FROM(page_id_t, field->value_.chars_ + sizeof(uint32_t));
+  char *chars = new char[len];
+  ReadOverflow(first_page_id, chars, len);
+  // hand the buffer over instead of copying it once more
+  Field value(TypeId::kTypeChar, chars, len, false);
+  value.manage_data_ = true;
+  *field = value;
+}
+
+page_id_t TableHeap::WriteOverflow(const char *data, uint32_t len) {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  for (uint32_t ofs = 0; ofs < len; ) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(page_id));
+    if (page == nullptr) {
+      if (prev_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+      }
+      if (first_page_id != INVALID_PAGE_ID) {
+        char pointer[OverflowPage::SIZE_TOAST_POINTER];
+        MACH_WRITE_UINT32(pointer, len);
+        MACH_WRITE_TO(page_id_t, pointer + sizeof(uint32_t), first_page_id);
+        FreeOverflow(pointer);
+      }
+      return INVALID_PAGE_ID;
+    }
+    if (compressed_) {
+      buffer_pool_manager_->SetPageCompression(page_id, true);
+    }
+    page->Init(page_id);
+    ofs += page->WritePayload(data + ofs, len - ofs);
+    if (prev_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+    }
+    prev_page = page;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetOverflowPageId(), true);
+  }
+  return first_page_id;
+}
+
+void TableHeap::ReadOverflow(page_id_t page_id, char *buf, uint32_t len) {
+  for (uint32_t ofs = 0; ofs < len && page_id != INVALID_PAGE_ID; ) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Failed to fetch overflow page.");
+    uint32_t size = std::min(page->GetDataSize(), len - ofs);
+    memcpy(buf + ofs, page->GetPayload(), size);
+    ofs += size;
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::FreeOverflow(const char *toast_pointer) {
+  page_id_t page_id = MACH_READ_FROM(page_id_t, toast_pointer + sizeof(uint32_t));
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::FreeOverflow(const Row &row) {
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    Field *field = row.GetField(i);
+    if (field->IsExternal()) {
+      FreeOverflow(field->value_.chars_);
+    }
+  }
+}
+
+void TableHeap::FreeOverflow(const RowView &view) {
+  for (uint32_t i = 0; i < view.GetFieldCount(); i++) {
+    if (view.IsExternal(i)) {
+      uint32_t len;
+      FreeOverflow(view.GetChars(i, &len));
+    }
+  }
+}
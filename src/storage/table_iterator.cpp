@@ -7,20 +7,41 @@ TableIterator::TableIterator() {
 }
 
 TableIterator::TableIterator(TableHeap *tableheap, RowId rid, Transaction *txn)
-    : tableheap_(tableheap), row_(new Row(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    tableheap_->GetTuple(row_, txn_);
-  }
+    : tableheap_(tableheap), txn_(txn) {
+  LoadRow(rid);
 }
 
-TableIterator::TableIterator(const TableIterator &other) {
-  tableheap_ = other.tableheap_;
-  row_ = other.row_;
-  txn_ = other.txn_;
+TableIterator::TableIterator(TableHeap *tableheap, RowId rid, Transaction *txn,
+                             const std::vector<uint32_t> &fetch_columns)
+    : tableheap_(tableheap), txn_(txn), fetch_all_(false), fetch_columns_(fetch_columns) {
+  LoadRow(rid);
+}
+
+TableIterator::TableIterator(const TableIterator &other)
+    : tableheap_(other.tableheap_), txn_(other.txn_), fetch_all_(other.fetch_all_),
+      fetch_columns_(other.fetch_columns_) {
+  if (other.row_ != nullptr) {
+    LoadRow(other.row_->GetRowId());
+  }
 }
 
 TableIterator::~TableIterator() {
-  if (row_ != nullptr) delete row_;
+  if (row_ != nullptr) row_->~Row();
+}
+
+void TableIterator::LoadRow(RowId rid) {
+  if (row_ != nullptr) {
+    row_->~Row();
+  }
+  heap_.Reset();
+  row_ = ALLOC(heap_, Row)(rid, &heap_);
+  if (rid.GetPageId() != INVALID_PAGE_ID) {
+    if (fetch_all_) {
+      tableheap_->GetTuple(row_, txn_);
+    } else {
+      tableheap_->GetTuple(row_, txn_, fetch_columns_);
+    }
+  }
 }
 
 bool TableIterator::operator==(const TableIterator &itr) const {
@@ -40,28 +61,7 @@ Row *TableIterator::operator->() {
 }
 
 TableIterator &TableIterator::operator++() {
-  BufferPoolManager *buffer_pool_manager = tableheap_->buffer_pool_manager_;
-  RowId cur_rid = row_->GetRowId(), next_rid;
-  while (cur_rid.GetPageId() != INVALID_PAGE_ID && next_rid.GetPageId() == INVALID_PAGE_ID) {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_rid.GetPageId()));
-    page->RLatch();
-    bool status = page->GetNextTupleRid(cur_rid, &next_rid);
-    page->RUnlatch();
-    if (status) {
-      buffer_pool_manager->UnpinPage(cur_rid.GetPageId(), false);
-      break;
-    }
-    page->RLatch();
-    page_id_t next_page_id = page->GetNextPageId();
-    page->RUnlatch();
-    buffer_pool_manager->UnpinPage(cur_rid.GetPageId(), false);
-    cur_rid = RowId(next_page_id, -1);
-  }
-  delete row_;
-  row_ = new Row(next_rid);
-  if (next_rid.GetPageId() != INVALID_PAGE_ID) {
-    tableheap_->GetTuple(row_, txn_);
-  }
+  LoadRow(tableheap_->GetNextRowId(row_->GetRowId()));
   return *this;
 }
 
@@ -0,0 +1,119 @@
+#include <algorithm>
+
+#include "storage/table_page_directory.h"
+
+TablePageDirectory::TablePageDirectory(BufferPoolManager *buffer_pool_manager)
+    : buffer_pool_manager_(buffer_pool_manager) {
+  page_id_t page_id;
+  auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->NewPage(page_id));
+  ASSERT(page != nullptr, "Failed to allocate directory page.");
+  page->Init(page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  directory_pages_.push_back(page_id);
+}
+
+TablePageDirectory::TablePageDirectory(BufferPoolManager *buffer_pool_manager, page_id_t directory_page_id)
+    : buffer_pool_manager_(buffer_pool_manager) {
+  ASSERT(directory_page_id != INVALID_PAGE_ID, "Invalid directory page.");
+  for (page_id_t page_id = directory_page_id; page_id != INVALID_PAGE_ID; ) {
+    auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->FetchPage(page_id));
+    directory_pages_.push_back(page_id);
+    for (uint32_t slot = 0; slot < page->GetEntryCount(); slot++) {
+      page_index_.emplace(page->GetPageId(slot), static_cast<uint32_t>(pages_.size()));
+      pages_.push_back(page->GetPageId(slot));
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+int TablePageDirectory::GetPageIndex(page_id_t page_id) const {
+  auto iter = page_index_.find(page_id);
+  return iter == page_index_.end() ? -1 : static_cast<int>(iter->second);
+}
+
+uint32_t TablePageDirectory::GetFreeSpace(uint32_t index) {
+  page_id_t page_id = directory_pages_[index / TableDirectoryPage::MAX_ENTRY_COUNT];
+  auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->FetchPage(page_id));
+  uint32_t free_space = page->GetFreeSpace(index % TableDirectoryPage::MAX_ENTRY_COUNT);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return free_space;
+}
+
+void TablePageDirectory::SetFreeSpace(page_id_t page_id, uint32_t free_space) {
+  int index = GetPageIndex(page_id);
+  ASSERT(index >= 0, "Page is not listed in the directory.");
+  page_id_t directory_page_id = directory_pages_[index / TableDirectoryPage::MAX_ENTRY_COUNT];
+  auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id));
+  uint32_t slot = index % TableDirectoryPage::MAX_ENTRY_COUNT;
+  bool changed = page->GetFreeSpace(slot) != free_space;
+  if (changed) {
+    page->SetFreeSpace(slot, free_space);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, changed);
+}
+
+bool TablePageDirectory::AppendPage(page_id_t page_id, uint32_t free_space) {
+  page_id_t last_page_id = directory_pages_.back();
+  auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (!page->Append(page_id, free_space)) {
+    // last directory page is full, chain a new one
+    page_id_t new_page_id;
+    auto new_page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->NewPage(new_page_id));
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+      return false;
+    }
+    new_page->Init(new_page_id);
+    new_page->Append(page_id, free_space);
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    directory_pages_.push_back(new_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  page_index_.emplace(page_id, static_cast<uint32_t>(pages_.size()));
+  pages_.push_back(page_id);
+  return true;
+}
+
+int TablePageDirectory::FindFreePage(uint32_t free_space) {
+  uint32_t index = 0;
+  for (auto directory_page_id : directory_pages_) {
+    auto page = reinterpret_cast<TableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id));
+    uint32_t entry_count = page->GetEntryCount();
+    for (uint32_t slot = 0; slot < entry_count; slot++, index++) {
+      if (page->GetFreeSpace(slot) >= free_space) {
+        buffer_pool_manager_->UnpinPage(directory_page_id, false);
+        return static_cast<int>(index);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  return -1;
+}
+
+std::vector<TablePageDirectory::PageRange> TablePageDirectory::Partition(uint32_t k) const {
+  std::vector<PageRange> ranges;
+  uint32_t page_count = GetPageCount();
+  if (k == 0 || page_count == 0) {
+    return ranges;
+  }
+  k = std::min(k, page_count);
+  ranges.reserve(k);
+  // the first page_count % k ranges take one page more
+  uint32_t size = page_count / k, extra = page_count % k, begin = 0;
+  for (uint32_t i = 0; i < k; i++) {
+    uint32_t end = begin + size + (i < extra ? 1 : 0);
+    ranges.emplace_back(begin, end);
+    begin = end;
+  }
+  return ranges;
+}
+
+void TablePageDirectory::FreeDirectory() {
+  buffer_pool_manager_->DeletePages(directory_pages_);
+  directory_pages_.clear();
+  pages_.clear();
+  page_index_.clear();
+}
@@ -0,0 +1,128 @@
+#include "storage/table_zone_map.h"
+
+#include <algorithm>
+#include <limits>
+
+TableZoneMap::TableZoneMap(Schema *schema) : tracked_(schema->GetColumnCount(), -1) {
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    TypeId type = schema->GetColumn(i)->GetType();
+    if (type == kTypeInt || type == kTypeFloat) {
+      tracked_[i] = static_cast<int>(tracked_columns_.size());
+      tracked_columns_.push_back(i);
+      tracked_types_.push_back(type);
+    }
+  }
+}
+
+void TableZoneMap::AppendPage(bool summarized) {
+  std::lock_guard<std::mutex> lock(latch_);
+  uint32_t page_index = summarized_.size();
+  summarized_.push_back(summarized);
+  versions_.push_back(0);
+  zones_.resize(zones_.size() + tracked_columns_.size());
+  Clear(page_index);
+}
+
+void TableZoneMap::Widen(uint32_t page_index, const Row &row) {
+  std::lock_guard<std::mutex> lock(latch_);
+  versions_[page_index]++;
+  if (summarized_[page_index]) {
+    WidenUnlocked(page_index, row);
+  }
+}
+
+uint64_t TableZoneMap::GetVersion(uint32_t page_index) const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return versions_[page_index];
+}
+
+void TableZoneMap::Summarize(uint32_t page_index, uint64_t version, const Row *rows, size_t row_count) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (versions_[page_index] != version) {
+    return;
+  }
+  Clear(page_index);
+  for (size_t i = 0; i < row_count; i++) {
+    WidenUnlocked(page_index, rows[i]);
+  }
+  summarized_[page_index] = true;
+}
+
+bool TableZoneMap::IsTracked(uint32_t column_index) const {
+  return column_index < tracked_.size() && tracked_[column_index] >= 0;
+}
+
+bool TableZoneMap::MayMatch(uint32_t page_index, uint32_t column_index, ZoneOp op, double value) const {
+  if (!IsTracked(column_index)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(latch_);
+  if (page_index >= summarized_.size() || !summarized_[page_index]) {
+    return true;
+  }
+  const ColumnZone &zone = zones_[page_index * tracked_columns_.size() + tracked_[column_index]];
+  if (op == ZoneOp::kIsNull) {
+    return zone.null_count_ > 0;
+  }
+  // null values satisfy no comparison
+  if (!zone.has_value_) {
+    return false;
+  }
+  switch (op) {
+    case ZoneOp::kEq:
+      return zone.min_ <= value && value <= zone.max_;
+    case ZoneOp::kNe:
+      return !(zone.min_ == value && zone.max_ == value);
+    case ZoneOp::kLt:
+      return zone.min_ < value;
+    case ZoneOp::kLe:
+      return zone.min_ <= value;
+    case ZoneOp::kGt:
+      return zone.max_ > value;
+    case ZoneOp::kGe:
+      return zone.max_ >= value;
+    default:
+      return true;
+  }
+}
+
+double TableZoneMap::ToZoneValue(const Field &field) {
+  char buf[sizeof(int32_t)];
+  field.SerializeTo(buf);
+  if (field.GetTypeId() == kTypeInt) {
+    return MACH_READ_FROM(int32_t, buf);
+  }
+  return MACH_READ_FROM(float, buf);
+}
+
+void TableZoneMap::Clear(uint32_t page_index) {
+  for (size_t i = 0; i < tracked_columns_.size(); i++) {
+    zones_[page_index * tracked_columns_.size() + i] = ColumnZone{0, 0, 0, false};
+  }
+}
+
+void TableZoneMap::WidenUnlocked(uint32_t page_index, const Row &row) {
+  for (size_t i = 0; i < tracked_columns_.size(); i++) {
+    ColumnZone &zone = zones_[page_index * tracked_columns_.size() + i];
+    const Field *field = row.GetField(tracked_columns_[i]);
+    if (field->IsNull()) {
+      zone.null_count_++;
+      continue;
+    }
+    // a value of another type is read back as this column's type, nothing is known about it then
+    if (field->GetTypeId() != tracked_types_[i]) {
+      zone.min_ = -std::numeric_limits<double>::infinity();
+      zone.max_ = std::numeric_limits<double>::infinity();
+      zone.has_value_ = true;
+      continue;
+    }
+    double value = ToZoneValue(*field);
+    if (!zone.has_value_) {
+      zone.min_ = zone.max_ = value;
+      zone.has_value_ = true;
+    } else {
+      zone.min_ = std::min(zone.min_, value);
+      zone.max_ = std::max(zone.max_, value);
+    }
+  }
+}
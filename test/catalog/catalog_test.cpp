@@ -108,6 +108,15 @@ TEST(CatalogTest, TableMetaTest) {
   ASSERT_EQ(TypeId::kTypeFloat, (*iter)->GetType());
   ASSERT_EQ(2, (*iter)->GetTableInd());
   ASSERT_EQ(true, (*iter)->IsNullable());
+  ASSERT_EQ(kRowFormatV1, other->GetSchema()->GetRowFormat());
+  ASSERT_EQ(meta->GetSerializedSize(), TableMetadata::DeserializeFrom(buf, other, &heap));
+
+  // the row format is kept across serialization
+  schema.SetRowFormat(kRowFormatV2);
+  meta->SerializeTo(buf);
+  ASSERT_EQ(meta->GetSerializedSize(), TableMetadata::DeserializeFrom(buf, other, &heap));
+  ASSERT_EQ(kRowFormatV2, other->GetSchema()->GetRowFormat());
+  ASSERT_EQ(3, other->GetSchema()->GetColumnCount());
 }
 
 TEST(CatalogTest, CatalogTableTest) {
@@ -200,4 +209,305 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, TableStatsTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), &txn, table_info));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->AnalyzeTable("table-0"));
+  TableHeap *table_heap = table_info->GetTableHeap();
+  TableStats *stats = table_info->GetTableStats();
+  auto insert_rows = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      std::string name = "name_" + std::to_string(i);
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, i),
+              i % 10 == 0 ? Field(TypeId::kTypeChar, nullptr, 0, false)
+                          : Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+              Field(TypeId::kTypeFloat, static_cast<float>(i % 50))};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      stats->OnInsert(row);
+    }
+  };
+
+  // small table, every page is read
+  const int small_rows = 1000;
+  insert_rows(0, small_rows);
+  ASSERT_EQ(small_rows, stats->GetRowCount());
+  ASSERT_FALSE(stats->IsAnalyzed());
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1"));
+  ASSERT_TRUE(stats->IsAnalyzed());
+  ASSERT_EQ(table_heap->GetPageCount(), stats->GetSampledPages());
+  ASSERT_EQ(small_rows, stats->GetRowCount());
+  ASSERT_EQ(0, stats->GetModifiedCount());
+  ASSERT_DOUBLE_EQ(0, stats->GetNullFraction(0));
+  ASSERT_DOUBLE_EQ(0.1, stats->GetNullFraction(1));
+  ASSERT_EQ(small_rows, stats->GetColumnStats(0).distinct_count_);
+  ASSERT_EQ(small_rows * 9 / 10, stats->GetColumnStats(1).distinct_count_);
+  ASSERT_EQ(50, stats->GetDistinctCount(2));
+  const ColumnStats &id_stats = stats->GetColumnStats(0);
+  ASSERT_EQ(CmpBool::kTrue, id_stats.min_->CompareEquals(Field(TypeId::kTypeInt, 0)));
+  ASSERT_EQ(CmpBool::kTrue, id_stats.max_->CompareEquals(Field(TypeId::kTypeInt, small_rows - 1)));
+  ASSERT_EQ(STATS_HISTOGRAM_BUCKETS, id_stats.histogram_.size());
+  for (uint32_t b = 0; b < STATS_HISTOGRAM_BUCKETS; b++) {
+    // equi-depth: bucket b ends at the row that completes (b + 1) / STATS_HISTOGRAM_BUCKETS of the table
+    int bound = ((b + 1) * small_rows + STATS_HISTOGRAM_BUCKETS - 1) / STATS_HISTOGRAM_BUCKETS - 1;
+    ASSERT_EQ(CmpBool::kTrue, id_stats.histogram_[b]->CompareEquals(Field(TypeId::kTypeInt, bound)));
+  }
+  ASSERT_EQ(CmpBool::kTrue, id_stats.histogram_.back()->CompareEquals(*id_stats.max_));
+
+  // counters follow inserts and deletes
+  insert_rows(small_rows, small_rows + 10);
+  auto first = table_heap->Begin(nullptr);
+  Row deleted(*first);
+  ASSERT_TRUE(table_heap->MarkDelete(deleted.GetRowId(), nullptr));
+  stats->OnDelete(deleted);
+  ASSERT_EQ(small_rows + 9, stats->GetRowCount());
+  ASSERT_EQ(11, stats->GetModifiedCount());
+  ASSERT_EQ(CmpBool::kTrue, stats->GetColumnStats(0).max_->CompareEquals(Field(TypeId::kTypeInt, small_rows + 9)));
+
+  // large table, only a sample of the pages is read
+  const int large_rows = 40000;
+  insert_rows(small_rows + 10, large_rows);
+  ASSERT_GT(table_heap->GetPageCount(), STATS_SAMPLE_PAGES);
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1"));
+  ASSERT_EQ(STATS_SAMPLE_PAGES, stats->GetSampledPages());
+  ASSERT_EQ(table_heap->GetPageCount(), stats->GetTablePages());
+  ASSERT_NEAR(large_rows, stats->GetRowCount(), large_rows * 0.1);
+  ASSERT_NEAR(0.1, stats->GetNullFraction(1), 0.02);
+  ASSERT_NEAR(large_rows, stats->GetDistinctCount(0), large_rows * 0.25);
+  ASSERT_NEAR(50, stats->GetDistinctCount(2), 5);
+  uint64_t row_count = stats->GetRowCount();
+  uint64_t distinct_count = stats->GetDistinctCount(0);
+  Field name_min(*stats->GetColumnStats(1).min_);
+  delete db_01;
+
+  // statistics survive a restart
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  TableStats *stats_02 = table_info_02->GetTableStats();
+  ASSERT_TRUE(stats_02->IsValid());
+  ASSERT_TRUE(stats_02->IsAnalyzed());
+  ASSERT_EQ(row_count, stats_02->GetRowCount());
+  ASSERT_EQ(distinct_count, stats_02->GetDistinctCount(0));
+  ASSERT_EQ(STATS_HISTOGRAM_BUCKETS, stats_02->GetColumnStats(1).histogram_.size());
+  ASSERT_EQ(CmpBool::kTrue, stats_02->GetColumnStats(1).min_->CompareEquals(name_min));
+  delete db_02;
+}
+
+TEST(CatalogTest, DictionaryTableTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("state", TypeId::kTypeChar, 32, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatPax);
+  schema->SetColumnEncoding(2, kEncodingDictionary);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), nullptr, table_info));
+  ASSERT_EQ(table_info->GetTableHeap()->GetDictionaryPageId(),
+            table_info->GetTableMetadata()->GetDictionaryPageId());
+  const int row_nums = 2000;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name_" + std::to_string(i);
+    std::string state = "state_" + std::to_string(i % 20);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+                              Field(TypeId::kTypeChar, const_cast<char *>(state.data()), state.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1"));
+  TableStats *stats = table_info->GetTableStats();
+  // unique names gain nothing from a dictionary, 20 states do, ints never have one
+  ASSERT_EQ(kEncodingPlain, stats->AdviseEncoding(0));
+  ASSERT_EQ(kEncodingPlain, stats->AdviseEncoding(1));
+  ASSERT_EQ(kEncodingDictionary, stats->AdviseEncoding(2));
+  delete db_01;
+
+  // the encoding and the dictionary survive a restart
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  Schema *schema_02 = table_info_02->GetSchema();
+  ASSERT_EQ(kRowFormatPax, schema_02->GetRowFormat());
+  ASSERT_EQ(kEncodingPlain, schema_02->GetColumnEncoding(1));
+  ASSERT_EQ(kEncodingDictionary, schema_02->GetColumnEncoding(2));
+  TableHeap *table_heap_02 = table_info_02->GetTableHeap();
+  ASSERT_EQ(20, table_heap_02->GetDictionarySize(2));
+  ASSERT_NE(ColumnDictionary::INVALID_CODE, table_heap_02->FindCode(2, "state_7", 7));
+  uint64_t count = 0;
+  for (auto it = table_heap_02->Begin(nullptr); it != table_heap_02->End(); ++it) {
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+  delete db_02;
+}
+
+TEST(CatalogTest, CompressedTableTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("comment", TypeId::kTypeChar, 128, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatV2);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), nullptr, table_info, true));
+  ASSERT_TRUE(table_info->GetTableMetadata()->IsCompressed());
+  const int row_nums = 2000;
+  auto make_comment = [](int i) {
+    return "order " + std::to_string(i) + " shipped to warehouse " + std::to_string(i % 7) + ", status delivered";
+  };
+  for (int i = 0; i < row_nums; i++) {
+    std::string comment = make_comment(i);
+    std::vector<Field> fields;
+    fields.emplace_back(TypeId::kTypeInt, i);
+    fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(comment.data()), comment.size(), true);
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  delete db_01;
+
+  // pages are read back through the page map after a restart, text pages shrink at least twice
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  TableHeap *table_heap_02 = table_info_02->GetTableHeap();
+  ASSERT_TRUE(table_heap_02->IsCompressed());
+  uint32_t compressed_pages;
+  uint64_t stored_size = table_heap_02->GetStoredSize(&compressed_pages);
+  ASSERT_EQ(table_heap_02->GetPageCount(), compressed_pages);
+  ASSERT_LE(stored_size * 2, static_cast<uint64_t>(table_heap_02->GetPageCount()) * PAGE_SIZE);
+  int count = 0;
+  for (auto it = table_heap_02->Begin(nullptr); it != table_heap_02->End(); ++it) {
+    // rows come back in insert order
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, count)));
+    ASSERT_EQ(make_comment(count), std::string(it->GetField(1)->GetData(), it->GetField(1)->GetLength()));
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+  delete db_02;
+}
+
+TEST(CatalogTest, RowCountTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), nullptr, table_info));
+  uint64_t row_count;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->GetRowCount("table-1", row_count));
+  ASSERT_EQ(0, row_count);
+  const int row_nums = 1000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields;
+    fields.emplace_back(TypeId::kTypeInt, i);
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    table_info->GetTableMetadata()->OnInsert();
+    rids.push_back(row.GetRowId());
+  }
+  for (int i = 0; i < row_nums; i += 4) {
+    ASSERT_TRUE(table_info->GetTableHeap()->MarkDelete(rids[i], nullptr));
+    table_info->GetTableMetadata()->OnDelete();
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->GetRowCount("table-1", row_count));
+  ASSERT_EQ(row_nums - row_nums / 4, row_count);
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->GetRowCount("table-2", row_count));
+  delete db_01;
+
+  // the count is kept with the table metadata, a table without one is counted once
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  ASSERT_TRUE(table_info_02->GetTableMetadata()->HasRowCount());
+  ASSERT_EQ(row_nums - row_nums / 4, table_info_02->GetTableMetadata()->GetRowCount());
+  table_info_02->GetTableMetadata()->SetRowCount(TableMetadata::INVALID_ROW_COUNT);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetRowCount("table-1", row_count));
+  ASSERT_EQ(row_nums - row_nums / 4, row_count);
+  delete db_02;
+}
+
+TEST(CatalogTest, TruncateTableTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), nullptr, table_info));
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", index_keys, nullptr, index_info));
+  auto insert_rows = [&](TableInfo *table, IndexInfo *index, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      std::vector<Field> fields;
+      fields.emplace_back(TypeId::kTypeInt, i);
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true);
+      Row row(fields);
+      ASSERT_TRUE(table->GetTableHeap()->InsertTuple(row, nullptr));
+      table->GetTableMetadata()->OnInsert();
+      std::vector<Field> key_fields;
+      key_fields.emplace_back(TypeId::kTypeInt, i);
+      Row key(key_fields);
+      ASSERT_EQ(DB_SUCCESS, index->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr));
+    }
+  };
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(db_01->disk_mgr_->GetMetaData());
+  uint32_t empty_pages = meta_page->GetAllocatedPages();
+  const int row_nums = 5000;
+  insert_rows(table_info, index_info, 0, row_nums);
+  ASSERT_LT(empty_pages + 50, meta_page->GetAllocatedPages());
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->TruncateTable("table-2"));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->TruncateTable("table-1"));
+  // heap and index pages are all freed, only the new statistics take a page
+  ASSERT_EQ(empty_pages + 1, meta_page->GetAllocatedPages());
+  TableHeap *table_heap = table_info->GetTableHeap();
+  ASSERT_EQ(1, table_heap->GetPageCount());
+  ASSERT_FALSE(table_heap->Begin(nullptr) != table_heap->End());
+  uint64_t row_count;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->GetRowCount("table-1", row_count));
+  ASSERT_EQ(0, row_count);
+  ASSERT_EQ(0, table_info->GetTableStats()->GetRowCount());
+  std::vector<Field> key_fields;
+  key_fields.emplace_back(TypeId::kTypeInt, 0);
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(Row(key_fields), result, nullptr));
+  // the emptied table and index take new rows
+  insert_rows(table_info, index_info, row_nums, row_nums + 100);
+  delete db_01;
+
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  int count = 0;
+  for (auto it = table_info_02->GetTableHeap()->Begin(nullptr); it != table_info_02->GetTableHeap()->End(); ++it) {
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, row_nums + count)));
+    count++;
+  }
+  ASSERT_EQ(100, count);
+  ASSERT_EQ(100, table_info_02->GetTableMetadata()->GetRowCount());
+  IndexInfo *index_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info_02));
+  std::vector<Field> new_key_fields;
+  new_key_fields.emplace_back(TypeId::kTypeInt, row_nums + 50);
+  ASSERT_EQ(DB_SUCCESS, index_info_02->GetIndex()->ScanKey(Row(new_key_fields), result, nullptr));
+  ASSERT_EQ(1, result.size());
+  delete db_02;
+}
@@ -1,9 +1,16 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
 #include <string>
+#include <type_traits>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree_index.h"
+#include "index/b_plus_tree_index_types.h"
 #include "index/generic_key.h"
+#include "utils/external_sorter.h"
+#include "utils/utils.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
 
@@ -35,6 +42,77 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   ASSERT_EQ(0, comparator(k1, k2));
 }
 
+TEST(BPlusTreeTests, BPlusTreeIndexKeyOrderTest) {
+  using INDEX_KEY_TYPE = GenericKey<64>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<64>;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 2, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0, 1, 2};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  INDEX_COMPARATOR_TYPE comparator(key_schema);
+  // few distinct values per field so that later fields decide the order often
+  std::vector<int32_t> ints{INT32_MIN, -7, -1, 0, 1, 7, INT32_MAX};
+  std::vector<float> floats{-1e30f, -2.5f, -0.0f, 0.0f, 1e-30f, 2.5f, 1e30f};
+  std::vector<std::string> names{"", std::string(1, '\0'), std::string("a\0", 2), std::string("a\0b", 3),
+                                 "a", "ab", "b", std::string("\xff\xff", 2)};
+  std::mt19937 rng(2022);
+  std::vector<std::vector<Field>> keys;
+  for (int i = 0; i < 500; i++) {
+    std::vector<Field> fields;
+    uint32_t pick = rng() % (ints.size() + 1);
+    pick == ints.size() ? fields.emplace_back(TypeId::kTypeInt) : fields.emplace_back(TypeId::kTypeInt, ints[pick]);
+    pick = rng() % (floats.size() + 1);
+    pick == floats.size() ? fields.emplace_back(TypeId::kTypeFloat)
+                          : fields.emplace_back(TypeId::kTypeFloat, floats[pick]);
+    pick = rng() % (names.size() + 1);
+    if (pick == names.size()) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(names[pick].data()), names[pick].size(), true);
+    }
+    keys.push_back(std::move(fields));
+  }
+  // nulls sort first and equal each other, values compare like fields
+  auto compare_fields = [](const std::vector<Field> &lhs, const std::vector<Field> &rhs) {
+    for (size_t i = 0; i < lhs.size(); i++) {
+      if (lhs[i].IsNull() || rhs[i].IsNull()) {
+        if (lhs[i].IsNull() != rhs[i].IsNull()) {
+          return lhs[i].IsNull() ? -1 : 1;
+        }
+      } else if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::kTrue) {
+        return -1;
+      } else if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::kTrue) {
+        return 1;
+      }
+    }
+    return 0;
+  };
+  std::vector<INDEX_KEY_TYPE> encoded(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    Row key(keys[i]);
+    encoded[i].SerializeFromKey(key, key_schema);
+    Row decoded(INVALID_ROWID);
+    encoded[i].DeserializeToKey(decoded, key_schema);
+    ASSERT_EQ(keys[i].size(), decoded.GetFieldCount());
+    for (size_t j = 0; j < keys[i].size(); j++) {
+      ASSERT_EQ(keys[i][j].IsNull(), decoded.GetField(j)->IsNull());
+      if (!keys[i][j].IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, keys[i][j].CompareEquals(*decoded.GetField(j)));
+      }
+    }
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      ASSERT_EQ(compare_fields(keys[i], keys[j]), comparator(encoded[i], encoded[j])) << i << " " << j;
+    }
+  }
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   using INDEX_KEY_TYPE = GenericKey<32>;
   using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
@@ -79,4 +157,456 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexTypeTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, false, false),
+          ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 2, true, false),
+          ALLOC_COLUMN(heap)("code", TypeId::kTypeChar, 5, 3, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 10, 4, true, false),
+          ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 64, 5, true, false)
+  };
+  const TableSchema table_schema(columns);
+  auto key_size_of = [&](std::vector<uint32_t> key_map) {
+    auto *key_schema = Schema::ShallowCopySchema(&table_schema, key_map, &heap);
+    Index *index = CreateBPlusTreeIndex(0, key_schema, engine.bpm_);
+    size_t key_size = 0;
+    EXPECT_TRUE(VisitBPlusTreeIndex(index, [&](auto *tree_index) {
+      using KeyType = typename std::remove_pointer_t<decltype(tree_index)>::IndexKey;
+      key_size = std::is_same<KeyType, NativeKey<int32_t>>::value ? 1 : sizeof(KeyType);
+    }));
+    delete index;
+    return key_size;
+  };
+  // single non-null numbers are native, the int is told apart from the float by a size of 1
+  ASSERT_EQ(1, key_size_of({0}));
+  ASSERT_EQ(sizeof(NativeKey<float>), key_size_of({1}));
+  // a nullable int takes 5 bytes
+  ASSERT_EQ(8, key_size_of({2}));
+  // a char(n) takes up to 2n + 3 bytes
+  ASSERT_EQ(16, key_size_of({3}));
+  ASSERT_EQ(32, key_size_of({0, 4}));
+  ASSERT_EQ(64, key_size_of({5}));
+
+  // a native index behaves like the generic one
+  std::vector<uint32_t> index_key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  Index *index = CreateBPlusTreeIndex(0, key_schema, engine.bpm_);
+  const int row_nums = 2000;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, (i * 7919) % row_nums - row_nums / 2)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key, RowId(i, 0), nullptr));
+  }
+  std::vector<Field> duplicate{Field(TypeId::kTypeInt, 0)};
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(Row(duplicate), RowId(row_nums, 0), nullptr));
+  std::vector<RowId> result;
+  std::vector<Field> probe{Field(TypeId::kTypeInt, -row_nums / 2 + 7919 % row_nums)};
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(Row(probe), result, nullptr));
+  ASSERT_EQ(1, result.size());
+  ASSERT_EQ(1, result[0].GetPageId());
+  Row min_key(INVALID_ROWID);
+  ASSERT_EQ(DB_SUCCESS, index->GetMinKey(min_key));
+  ASSERT_EQ(CmpBool::kTrue, min_key.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, -row_nums / 2)));
+  VisitBPlusTreeIndex(index, [&](auto *tree_index) {
+    int expected = -row_nums / 2;
+    for (auto iter = tree_index->GetBeginIterator(); iter != tree_index->GetEndIterator(); ++iter) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, expected++)};
+      typename std::remove_pointer_t<decltype(tree_index)>::IndexKey key;
+      key.SerializeFromKey(Row(fields), key_schema);
+      ASSERT_TRUE(key == (*iter).first);
+    }
+    ASSERT_EQ(row_nums / 2, expected);
+  });
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  delete index;
+}
+
+TEST(BPlusTreeTests, ExternalSorterTest) {
+  auto less = [](int a, int b) { return a < b; };
+  std::mt19937 rng(42);
+  // n entries, runs spilled
+  for (auto test : std::vector<std::pair<int, size_t>>{{0, 0}, {1000, 0}, {100000, 25}}) {
+    int n = test.first;
+    // 16KB of memory spills 4096 ints a run
+    ExternalSorter<int, decltype(less)> sorter(less, 16 << 10);
+    std::vector<int> expected;
+    for (int i = 0; i < n; i++) {
+      int value = static_cast<int>(rng() % 50000);
+      sorter.Add(value);
+      expected.push_back(value);
+    }
+    sorter.Finish();
+    ASSERT_EQ(n, sorter.GetCount());
+    ASSERT_EQ(test.second, sorter.GetRunCount());
+    std::sort(expected.begin(), expected.end());
+    int value;
+    for (int i = 0; i < n; i++) {
+      ASSERT_TRUE(sorter.Next(&value));
+      ASSERT_EQ(expected[i], value);
+    }
+    ASSERT_FALSE(sorter.Next(&value));
+  }
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexBulkLoadTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  const int row_nums = 100000;
+  std::vector<int> ids(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    ids[i] = i;
+  }
+  ShuffleArray(ids);
+  auto make_key = [](const int *value) {
+    std::vector<Field> fields;
+    fields.emplace_back(value == nullptr ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, *value));
+    return Row(fields);
+  };
+  auto scan = [&](const IndexEntryConsumer &consume) {
+    for (int i = 0; i < row_nums; i++) {
+      consume(make_key(&ids[i]), RowId(i / 100, i % 100));
+    }
+  };
+  std::vector<uint32_t> index_key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  long long insert_ns;
+  {
+    DBStorageEngine engine(db_name);
+    Index *index = CreateBPlusTreeIndex(0, key_schema, engine.bpm_);
+    auto start = std::chrono::steady_clock::now();
+    scan([&](const Row &key, RowId row_id) { index->InsertEntry(key, row_id, nullptr); });
+    insert_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    delete index;
+  }
+  DBStorageEngine engine(db_name);
+  Index *index = CreateBPlusTreeIndex(0, key_schema, engine.bpm_);
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, index->BulkLoad(scan, nullptr));
+  auto bulk_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  LOG(INFO) << "index of " << row_nums << " shuffled rows: inserts " << insert_ns / 1000000 << " ms, bulk load "
+            << bulk_ns / 1000000 << " ms";
+  std::vector<RowId> result;
+  for (int i = 0; i < row_nums; i += 7) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(&ids[i]), result, nullptr));
+    ASSERT_EQ(RowId(i / 100, i % 100).Get(), result[0].Get());
+  }
+  ASSERT_EQ(DB_FAILED, index->BulkLoad(scan, nullptr));
+  // the loaded tree takes inserts like any other
+  int above = row_nums;
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(&above), RowId(row_nums, 0), nullptr));
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_key(&ids[0]), RowId(row_nums, 1), nullptr));
+  delete index;
+
+  // repeated keys and nulls keep their first row, as inserts in table order would
+  std::vector<uint32_t> age_key_map{1};
+  auto *age_schema = Schema::ShallowCopySchema(&table_schema, age_key_map, &heap);
+  index = CreateBPlusTreeIndex(1, age_schema, engine.bpm_);
+  ASSERT_EQ(DB_SUCCESS, index->BulkLoad([&](const IndexEntryConsumer &consume) {
+    for (int i = 0; i < row_nums; i++) {
+      int age = ids[i] % 100;
+      consume(make_key(i % 10 == 0 ? nullptr : &age), RowId(i / 100, i % 100));
+    }
+  }, nullptr));
+  std::vector<bool> seen(100, false);
+  for (int i = 0; i < row_nums; i++) {
+    int age = ids[i] % 100;
+    if (i % 10 == 0 || seen[age]) {
+      continue;
+    }
+    seen[age] = true;
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(&age), result, nullptr));
+    ASSERT_EQ(1, result.size());
+    ASSERT_EQ(RowId(i / 100, i % 100).Get(), result[0].Get());
+  }
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(nullptr), result, nullptr));
+  ASSERT_EQ(RowId(0, 0).Get(), result[0].Get());
+  VisitBPlusTreeIndex(index, [&](auto *tree_index) {
+    int count = 0;
+    for (auto iter = tree_index->GetBeginIterator(); iter != tree_index->GetEndIterator(); ++iter) {
+      count++;
+    }
+    ASSERT_EQ(101, count);
+  });
+  delete index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexNonUniqueTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> id_key_map{0};
+  std::vector<uint32_t> age_key_map{1};
+  std::vector<uint32_t> both_key_map{1, 0};
+  auto *age_schema = Schema::ShallowCopySchema(&table_schema, age_key_map, &heap);
+  ASSERT_TRUE(IsUniqueKeySchema(Schema::ShallowCopySchema(&table_schema, id_key_map, &heap)));
+  ASSERT_TRUE(IsUniqueKeySchema(Schema::ShallowCopySchema(&table_schema, both_key_map, &heap)));
+  ASSERT_FALSE(IsUniqueKeySchema(age_schema));
+  auto make_key = [](const int *value) {
+    std::vector<Field> fields;
+    fields.emplace_back(value == nullptr ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, *value));
+    return Row(fields);
+  };
+  const int row_nums = 20000;
+  const int ages = 50;
+  // ages repeat and every tenth one is null, the rows come shuffled
+  std::vector<int> order(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    order[i] = i;
+  }
+  ShuffleArray(order);
+  auto age_of = [&](int i, int *age) {
+    *age = (i * 7) % ages;
+    return i % 10 == 0 ? nullptr : age;
+  };
+  Index *index = CreateBPlusTreeIndex(0, age_schema, engine.bpm_, false);
+  ASSERT_FALSE(index->IsUnique());
+  // a nullable int and a row id take 13 bytes
+  ASSERT_TRUE(VisitBPlusTreeIndex(index, [&](auto *tree_index) {
+    ASSERT_EQ(16, sizeof(typename std::remove_pointer_t<decltype(tree_index)>::IndexKey));
+  }));
+  int age;
+  for (int i : order) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(age_of(i, &age)), RowId(i / 100, i % 100), nullptr));
+  }
+  // the same row twice is still refused
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_key(age_of(1, &age)), RowId(0, 1), nullptr));
+
+  auto check = [&](const std::vector<int> &removed) {
+    for (int probe = -1; probe <= ages; probe++) {
+      std::vector<RowId> expected;
+      for (int i = 0; i < row_nums; i++) {
+        const int *key = age_of(i, &age);
+        bool match = probe == -1 ? key == nullptr : key != nullptr && age == probe;
+        if (match && std::find(removed.begin(), removed.end(), i) == removed.end()) {
+          expected.emplace_back(i / 100, i % 100);
+        }
+      }
+      std::vector<RowId> result;
+      dberr_t status = index->ScanKey(make_key(probe == -1 ? nullptr : &probe), result, nullptr);
+      ASSERT_EQ(expected.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS, status);
+      // every row of the key, in row id order
+      ASSERT_EQ(expected.size(), result.size());
+      for (size_t j = 0; j < expected.size(); j++) {
+        ASSERT_EQ(expected[j].Get(), result[j].Get());
+      }
+    }
+  };
+  check({});
+  // the ends skip the nulls, which sort first and fill the leftmost leaves, an age of 0 only comes with a null
+  Row min_key(INVALID_ROWID);
+  Row max_key(INVALID_ROWID);
+  ASSERT_EQ(DB_SUCCESS, index->GetMinKey(min_key));
+  ASSERT_EQ(CmpBool::kTrue, min_key.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 1)));
+  ASSERT_EQ(DB_SUCCESS, index->GetMaxKey(max_key));
+  ASSERT_EQ(CmpBool::kTrue, max_key.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, ages - 1)));
+  // removing a row leaves the other rows of its key
+  std::vector<int> removed{3, 53, 103, 10, 20};
+  for (int i : removed) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(make_key(age_of(i, &age)), RowId(i / 100, i % 100), nullptr));
+  }
+  check(removed);
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  delete index;
+
+  // a bulk load keeps every row of a repeated key
+  index = CreateBPlusTreeIndex(1, age_schema, engine.bpm_, false);
+  ASSERT_EQ(DB_SUCCESS, index->BulkLoad([&](const IndexEntryConsumer &consume) {
+    for (int i : order) {
+      consume(make_key(age_of(i, &age)), RowId(i / 100, i % 100));
+    }
+  }, nullptr));
+  check({});
+  delete index;
+
+  // an index of nulls only has no smallest or largest value
+  index = CreateBPlusTreeIndex(2, age_schema, engine.bpm_, false);
+  for (int i = 0; i < row_nums; i += 10) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(nullptr), RowId(i / 100, i % 100), nullptr));
+  }
+  Row null_key(INVALID_ROWID);
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->GetMinKey(null_key));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->GetMaxKey(null_key));
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  delete index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexKeyTooLargeTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 0, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> name_key_map{0};
+  auto *name_schema = Schema::ShallowCopySchema(&table_schema, name_key_map, &heap);
+  std::string short_name(40, 'a');
+  std::string long_name(60, 'b');
+  auto make_key = [](const std::string &name) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    return Row(fields);
+  };
+  // a char(64) key takes GenericKey<64>, a name of 60 bytes fits alone but not with a row id
+  for (bool unique : {true, false}) {
+    Index *index = CreateBPlusTreeIndex(unique, name_schema, engine.bpm_, unique);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(short_name), RowId(0, 0), nullptr));
+    ASSERT_EQ(unique ? DB_SUCCESS : DB_KEY_TOO_LARGE, index->InsertEntry(make_key(long_name), RowId(0, 1), nullptr));
+    std::vector<RowId> result;
+    ASSERT_EQ(unique ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(make_key(long_name), result, nullptr));
+    Row bound = make_key(long_name);
+    ASSERT_EQ(unique ? DB_SUCCESS : DB_FAILED, index->ScanRange(&bound, true, nullptr, false, 0,
+                                                                [](const std::vector<RowId> &) { return true; },
+                                                                nullptr));
+    ASSERT_EQ(DB_SUCCESS, index->Destroy());
+    delete index;
+  }
+  std::string longer_name(63, 'c');
+  Index *index = CreateBPlusTreeIndex(0, name_schema, engine.bpm_, true);
+  ASSERT_EQ(DB_KEY_TOO_LARGE, index->InsertEntry(make_key(longer_name), RowId(0, 0), nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->RemoveEntry(make_key(longer_name), RowId(0, 0), nullptr));
+  // a bulk load with one key too long loads nothing
+  ASSERT_EQ(DB_KEY_TOO_LARGE, index->BulkLoad([&](const IndexEntryConsumer &consume) {
+    consume(make_key(short_name), RowId(0, 0));
+    consume(make_key(longer_name), RowId(0, 1));
+  }, nullptr));
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(make_key(short_name), result, nullptr));
+  delete index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexScanRangeTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> id_key_map{0};
+  std::vector<uint32_t> age_key_map{1};
+  auto *id_schema = Schema::ShallowCopySchema(&table_schema, id_key_map, &heap);
+  auto *age_schema = Schema::ShallowCopySchema(&table_schema, age_key_map, &heap);
+  auto make_key = [](int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    return Row(fields);
+  };
+  const int row_nums = 10000;
+  const int ages = 100;
+  std::vector<int> order(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    order[i] = i;
+  }
+  ShuffleArray(order);
+  // ids are unique, ages repeat and every tenth one is null
+  Index *id_index = CreateBPlusTreeIndex(0, id_schema, engine.bpm_, true);
+  Index *age_index = CreateBPlusTreeIndex(1, age_schema, engine.bpm_, false);
+  for (int i : order) {
+    ASSERT_EQ(DB_SUCCESS, id_index->InsertEntry(make_key(i), RowId(i / 100, i % 100), nullptr));
+    std::vector<Field> fields;
+    fields.emplace_back(i % 10 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, i % ages));
+    ASSERT_EQ(DB_SUCCESS, age_index->InsertEntry(Row(fields), RowId(i / 100, i % 100), nullptr));
+  }
+
+  // rows of the range in key order, then row id order
+  auto scan = [](Index *index, const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, uint64_t limit,
+                 size_t *batches) {
+    std::vector<int> rows;
+    *batches = 0;
+    auto consume = [&](const std::vector<RowId> &batch) {
+      EXPECT_FALSE(batch.empty());
+      (*batches)++;
+      for (auto &rid : batch) {
+        rows.push_back(rid.GetPageId() * 100 + static_cast<int>(rid.GetSlotNum()));
+      }
+      return true;
+    };
+    EXPECT_EQ(DB_SUCCESS, index->ScanRange(lo, lo_inclusive, hi, hi_inclusive, limit, consume, nullptr));
+    return rows;
+  };
+  auto expect_ids = [&](int lo, int hi, const std::vector<int> &rows) {
+    ASSERT_EQ(std::max(hi - lo, 0), static_cast<int>(rows.size()));
+    for (int i = lo; i < hi; i++) {
+      ASSERT_EQ(i, rows[i - lo]);
+    }
+  };
+  size_t batches;
+  Row lo = make_key(1000);
+  Row hi = make_key(3000);
+  expect_ids(1000, 3001, scan(id_index, &lo, true, &hi, true, 0, &batches));
+  // a batch is a leaf
+  ASSERT_GT(batches, 1);
+  ASSERT_LT(batches, 2001 / 2);
+  expect_ids(1001, 3000, scan(id_index, &lo, false, &hi, false, 0, &batches));
+  expect_ids(0, 3000, scan(id_index, nullptr, false, &hi, false, 0, &batches));
+  expect_ids(1000, row_nums, scan(id_index, &lo, true, nullptr, false, 0, &batches));
+  expect_ids(0, row_nums, scan(id_index, nullptr, false, nullptr, false, 0, &batches));
+  expect_ids(1000, 1001, scan(id_index, &lo, true, &lo, true, 0, &batches));
+  expect_ids(0, 0, scan(id_index, &lo, false, &lo, true, 0, &batches));
+  expect_ids(0, 0, scan(id_index, &hi, true, &lo, true, 0, &batches));
+  Row past = make_key(row_nums);
+  expect_ids(0, 0, scan(id_index, &past, true, nullptr, false, 0, &batches));
+  ASSERT_EQ(0, batches);
+  expect_ids(1000, 1500, scan(id_index, &lo, true, &hi, true, 500, &batches));
+
+  // the consumer ends the scan, or removes what it got and the scan goes on past it
+  size_t seen = 0;
+  id_index->ScanRange(&lo, true, nullptr, false, 0, [&](const std::vector<RowId> &batch) {
+    seen += batch.size();
+    return false;
+  }, nullptr);
+  ASSERT_LT(seen, row_nums - 1000);
+  std::vector<int> removed;
+  id_index->ScanRange(&lo, true, &hi, false, 0, [&](const std::vector<RowId> &batch) {
+    for (auto &rid : batch) {
+      int id = rid.GetPageId() * 100 + static_cast<int>(rid.GetSlotNum());
+      EXPECT_EQ(DB_SUCCESS, id_index->RemoveEntry(make_key(id), rid, nullptr));
+      removed.push_back(id);
+    }
+    return true;
+  }, nullptr);
+  expect_ids(1000, 3000, removed);
+  expect_ids(0, 0, scan(id_index, &lo, true, &hi, false, 0, &batches));
+  expect_ids(3000, 3001, scan(id_index, &lo, true, &hi, true, 0, &batches));
+
+  // every row of the bound keys of a non-unique index, nulls sort first
+  Row age_lo = make_key(20);
+  Row age_hi = make_key(30);
+  for (int lo_inclusive = 0; lo_inclusive < 2; lo_inclusive++) {
+    for (int hi_inclusive = 0; hi_inclusive < 2; hi_inclusive++) {
+      std::vector<int> rows = scan(age_index, &age_lo, lo_inclusive, &age_hi, hi_inclusive, 0, &batches);
+      std::vector<int> expected;
+      for (int age = lo_inclusive ? 20 : 21; age <= (hi_inclusive ? 30 : 29); age++) {
+        for (int i = age; i < row_nums; i += ages) {
+          if (i % 10 != 0) {
+            expected.push_back(i);
+          }
+        }
+      }
+      ASSERT_EQ(expected, rows);
+    }
+  }
+  ASSERT_EQ(row_nums, scan(age_index, nullptr, false, nullptr, false, 0, &batches).size());
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  Row null_key(null_fields);
+  ASSERT_EQ(row_nums - row_nums / 10, scan(age_index, &null_key, false, nullptr, false, 0, &batches).size());
+  ASSERT_EQ(row_nums / 10, scan(age_index, nullptr, false, &null_key, true, 0, &batches).size());
+
+  ASSERT_EQ(DB_SUCCESS, id_index->Destroy());
+  ASSERT_EQ(DB_SUCCESS, age_index->Destroy());
+  delete id_index;
+  delete age_index;
+}
@@ -1,7 +1,14 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
 #include "index/b_plus_tree.h"
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/basic_comparator.h"
+#include "index/generic_key.h"
+#include "page/b_plus_tree_node_search.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -67,3 +74,557 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
 }
+
+TEST(BPlusTreeTests, MinMaxKeyTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+  int key;
+  ASSERT_FALSE(tree.GetMinKey(key));
+  ASSERT_FALSE(tree.GetMaxKey(key));
+  const int n = 200;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int i = 0; i < n; i++) {
+    tree.Insert(keys[i], keys[i]);
+  }
+  ASSERT_TRUE(tree.GetMinKey(key));
+  ASSERT_EQ(0, key);
+  ASSERT_TRUE(tree.GetMaxKey(key));
+  ASSERT_EQ(n - 1, key);
+  // the ends move in as the smallest and largest keys are removed
+  for (int i = 0; i < n / 4; i++) {
+    tree.Remove(i);
+    tree.Remove(n - 1 - i);
+  }
+  ASSERT_TRUE(tree.Check());
+  ASSERT_TRUE(tree.GetMinKey(key));
+  ASSERT_EQ(n / 4, key);
+  ASSERT_TRUE(tree.GetMaxKey(key));
+  ASSERT_EQ(n - 1 - n / 4, key);
+  // the smallest key from a bound, past the leaves left of it
+  int from = n / 2;
+  ASSERT_TRUE(tree.GetMinKey(key, &from));
+  ASSERT_EQ(n / 2, key);
+  tree.Remove(n / 2);
+  ASSERT_TRUE(tree.GetMinKey(key, &from));
+  ASSERT_EQ(n / 2 + 1, key);
+  from = n - n / 4;
+  ASSERT_FALSE(tree.GetMinKey(key, &from));
+}
+
+TEST(BPlusTreeTests, DestroyTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+  const int n = 500;
+  for (int i = 0; i < n; i++) {
+    tree.Insert(i, i);
+  }
+  // every page of the tree is freed
+  std::vector<page_id_t> page_ids;
+  for (page_id_t page_id = INDEX_ROOTS_PAGE_ID + 1; page_id < 2 * n; page_id++) {
+    if (!engine.bpm_->IsPageFree(page_id)) {
+      page_ids.push_back(page_id);
+    }
+  }
+  ASSERT_LT(n / 4, page_ids.size());
+  tree.Destroy();
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Check());
+  for (auto page_id : page_ids) {
+    ASSERT_TRUE(engine.bpm_->IsPageFree(page_id));
+  }
+  // the emptied tree takes new keys, its root is found again by index id
+  for (int i = 0; i < n; i++) {
+    tree.Insert(i, i * 2);
+  }
+  BPlusTree<int, int, BasicComparator<int>> reopened(0, engine.bpm_, comparator, 4, 4);
+  vector<int> ans;
+  ASSERT_TRUE(reopened.GetValue(n - 1, ans));
+  ASSERT_EQ(2 * (n - 1), ans[0]);
+}
+
+TEST(BPlusTreeTests, NodeSearchTest) {
+  std::mt19937 rng(43);
+  BasicComparator<int> int_comparator;
+  NativeComparator<float> float_comparator(nullptr);
+  GenericComparator<8> generic_comparator(nullptr);
+  for (int n = 0; n < 600; n += 1 + n / 8) {
+    // sorted distinct keys with gaps, probes hit keys, gaps and both ends
+    std::vector<std::pair<int, int>> ints;
+    std::vector<std::pair<NativeKey<float>, RowId>> floats;
+    std::vector<std::pair<GenericKey<8>, RowId>> generics;
+    int value = -1000;
+    for (int i = 0; i < n; i++) {
+      value += 1 + rng() % 3;
+      ints.emplace_back(value, i);
+      floats.push_back({NativeKey<float>{value * 0.5f}, RowId(i, 0)});
+      GenericKey<8> key{};
+      uint32_t bits = static_cast<uint32_t>(value) ^ 0x80000000u;
+      for (int b = 0; b < 4; b++) {
+        key.data[b] = static_cast<char>(bits >> (24 - 8 * b));
+      }
+      generics.push_back({key, RowId(i, 0)});
+    }
+    for (int probe = -1002; probe <= value + 2; probe++) {
+      auto lower = std::lower_bound(ints.begin(), ints.end(), probe,
+                                    [](const std::pair<int, int> &entry, int key) { return entry.first < key; });
+      auto upper = std::upper_bound(ints.begin(), ints.end(), probe,
+                                    [](int key, const std::pair<int, int> &entry) { return key < entry.first; });
+      int expected_lower = lower - ints.begin();
+      int expected_upper = upper - ints.begin();
+      ASSERT_EQ(expected_lower,
+                (NodeSearch<int, BasicComparator<int>>::LowerBound(ints.data(), n, probe, int_comparator)));
+      ASSERT_EQ(expected_upper,
+                (NodeSearch<int, BasicComparator<int>>::UpperBound(ints.data(), n, probe, int_comparator)));
+      ASSERT_EQ(expected_lower, (NodeSearch<int, BasicComparator<int>>::BinaryBound<false>(ints.data(), n, probe,
+                                                                                             int_comparator)));
+      NativeKey<float> float_probe{probe * 0.5f};
+      ASSERT_EQ(expected_lower, (NodeSearch<NativeKey<float>, NativeComparator<float>>::LowerBound(
+              floats.data(), n, float_probe, float_comparator)));
+      ASSERT_EQ(expected_upper, (NodeSearch<NativeKey<float>, NativeComparator<float>>::UpperBound(
+              floats.data(), n, float_probe, float_comparator)));
+      GenericKey<8> generic_probe{};
+      uint32_t bits = static_cast<uint32_t>(probe) ^ 0x80000000u;
+      for (int b = 0; b < 4; b++) {
+        generic_probe.data[b] = static_cast<char>(bits >> (24 - 8 * b));
+      }
+      ASSERT_EQ(expected_lower, (NodeSearch<GenericKey<8>, GenericComparator<8>>::LowerBound(
+              generics.data(), n, generic_probe, generic_comparator)));
+      ASSERT_EQ(expected_upper, (NodeSearch<GenericKey<8>, GenericComparator<8>>::UpperBound(
+              generics.data(), n, generic_probe, generic_comparator)));
+    }
+  }
+}
+
+TEST(BPlusTreeTests, NodeSearchBenchmark) {
+  using Clock = std::chrono::high_resolution_clock;
+  using Search = NodeSearch<int, BasicComparator<int>>;
+  BasicComparator<int> comparator;
+  // full leaves of int keys, probed at keys and between them in random order
+  const int n = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<int, int>) - 1;
+  const int probe_nums = 500000;
+  std::mt19937 rng(43);
+  for (int node_nums : {1, 4096}) {
+    // a single node stays in cache, thousands of them do not, like the pages of a large tree
+    std::vector<std::pair<int, int>> nodes;
+    for (int j = 0; j < node_nums; j++) {
+      for (int i = 0; i < n; i++) {
+        nodes.emplace_back(2 * i, i);
+      }
+    }
+    std::vector<std::pair<int, int>> probes;
+    for (int i = 0; i < probe_nums; i++) {
+      probes.emplace_back(rng() % node_nums * n, rng() % (2 * n));
+    }
+    int64_t checksum[3] = {0, 0, 0};
+    auto t0 = Clock::now();
+    for (auto &probe : probes) {
+      // the scan the leaf page used before
+      const std::pair<int, int> *node = nodes.data() + probe.first;
+      int i = 0;
+      while (i < n && comparator(node[i].first, probe.second) < 0) {
+        i++;
+      }
+      checksum[0] += i;
+    }
+    auto t1 = Clock::now();
+    for (auto &probe : probes) {
+      checksum[1] += Search::BinaryBound<false>(nodes.data() + probe.first, n, probe.second, comparator);
+    }
+    auto t2 = Clock::now();
+    for (auto &probe : probes) {
+      checksum[2] += Search::LowerBound(nodes.data() + probe.first, n, probe.second, comparator);
+    }
+    auto t3 = Clock::now();
+    ASSERT_EQ(checksum[0], checksum[1]);
+    ASSERT_EQ(checksum[0], checksum[2]);
+    auto ns_per_probe = [&](Clock::time_point begin, Clock::time_point end) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / probe_nums;
+    };
+    LOG(INFO) << "lower bound in " << node_nums << " leaves of " << n << " int keys: linear " << ns_per_probe(t0, t1)
+              << " ns, branch-free binary " << ns_per_probe(t1, t2) << " ns, binary + simd scan "
+              << ns_per_probe(t2, t3) << " ns";
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  using LeafPage = BPlusTreeLeafPage<int, int, BasicComparator<int>>;
+  BasicComparator<int> comparator;
+  for (int n : {0, 1, 4, 5, 17, 500, 3000}) {
+    DBStorageEngine engine(db_name);
+    BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+    int i = 0;
+    auto next = [&](std::pair<int, int> *entry) {
+      if (i == n) {
+        return false;
+      }
+      *entry = {2 * i, i};
+      i++;
+      return true;
+    };
+    ASSERT_TRUE(tree.BulkLoad(next, n));
+    ASSERT_TRUE(tree.Check());
+    ASSERT_EQ(n == 0, tree.IsEmpty());
+    if (n == 0) {
+      continue;
+    }
+    // leaves are linked in key order, each at least half full
+    int key = 0;
+    Page *page = tree.FindLeafPage(0, true);
+    while (true) {
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      ASSERT_TRUE(leaf->GetSize() >= leaf->GetMinSize() || n < leaf->GetMinSize());
+      for (int j = 0; j < leaf->GetSize(); j++, key += 2) {
+        ASSERT_EQ(key, leaf->KeyAt(j));
+      }
+      page_id_t next_page_id = leaf->GetNextPageId();
+      engine.bpm_->UnpinPage(page->GetPageId(), false);
+      if (next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      page = engine.bpm_->FetchPage(next_page_id);
+    }
+    ASSERT_EQ(2 * n, key);
+    vector<int> ans;
+    for (int k = 0; k < n; k++) {
+      ASSERT_TRUE(tree.GetValue(2 * k, ans));
+      ASSERT_EQ(k, ans.back());
+      ASSERT_FALSE(tree.GetValue(2 * k + 1, ans));
+    }
+    // the loaded tree takes inserts and removes like any other, its root is found again by index id
+    for (int k = 0; k < n; k++) {
+      ASSERT_TRUE(tree.Insert(2 * k + 1, -k));
+    }
+    for (int k = 0; k < n; k += 2) {
+      tree.Remove(2 * k);
+    }
+    ASSERT_TRUE(tree.Check());
+    ASSERT_FALSE(tree.BulkLoad(next, 0));
+    BPlusTree<int, int, BasicComparator<int>> reopened(0, engine.bpm_, comparator, 4, 4);
+    for (int k = 0; k < 2 * n; k++) {
+      ans.clear();
+      ASSERT_EQ(k % 2 == 1 || k % 4 == 2, reopened.GetValue(k, ans));
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadShortTest) {
+  // fewer entries than counted, e.g. duplicates skipped by the caller, leave the right edge short
+  BasicComparator<int> comparator;
+  for (int n : {1, 10, 200}) {
+    DBStorageEngine engine(db_name);
+    BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+    int i = 0;
+    auto next = [&](std::pair<int, int> *entry) {
+      if (i == n) {
+        return false;
+      }
+      *entry = {i, i};
+      i++;
+      return true;
+    };
+    ASSERT_TRUE(tree.BulkLoad(next, 1000));
+    ASSERT_TRUE(tree.Check());
+    vector<int> ans;
+    for (int k = 0; k < n; k++) {
+      ASSERT_TRUE(tree.GetValue(k, ans));
+    }
+    for (int k = n; k < 2 * n; k++) {
+      ASSERT_TRUE(tree.Insert(k, k));
+    }
+    for (int k = 0; k < 2 * n; k += 3) {
+      tree.Remove(k);
+    }
+    ASSERT_TRUE(tree.Check());
+    for (int k = 0; k < 2 * n; k++) {
+      ans.clear();
+      ASSERT_EQ(k % 3 != 0, tree.GetValue(k, ans));
+    }
+  }
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // small pages give a tree of several levels
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 8, 8);
+  std::vector<int> probes{3, 5};
+  std::vector<int> values;
+  std::vector<bool> found;
+  ASSERT_EQ(0, tree.GetValues(probes, values, found));
+  ASSERT_EQ(std::vector<bool>(2, false), found);
+  const int n = 2000;
+  std::vector<int> keys;
+  for (int key = 0; key < n; key += 2) {
+    keys.push_back(key);
+  }
+  ShuffleArray(keys);
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(key, 3 * key));
+  }
+  // unsorted probes, repeats and keys outside the tree, in batches of every size up to all of them
+  std::mt19937 rng(7);
+  for (int batch : {0, 1, 2, 17, 500, 3 * n}) {
+    probes.clear();
+    for (int i = 0; i < batch; i++) {
+      probes.push_back(static_cast<int>(rng() % (n + 20)) - 10);
+    }
+    size_t hits = tree.GetValues(probes, values, found);
+    ASSERT_EQ(probes.size(), values.size());
+    ASSERT_EQ(probes.size(), found.size());
+    size_t expected = 0;
+    for (size_t i = 0; i < probes.size(); i++) {
+      std::vector<int> ans;
+      ASSERT_EQ(tree.GetValue(probes[i], ans), found[i]);
+      if (found[i]) {
+        ASSERT_EQ(3 * probes[i], values[i]);
+        expected++;
+      }
+    }
+    ASSERT_EQ(expected, hits);
+    ASSERT_TRUE(tree.Check());
+  }
+}
+
+TEST(BPlusTreeTests, GetValuesBenchmark) {
+  using Clock = std::chrono::high_resolution_clock;
+  BasicComparator<int> comparator;
+  DBStorageEngine engine(db_name, true, 4096);
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator);
+  const int n = 1000000;
+  int i = 0;
+  auto next = [&](std::pair<int, int> *entry) {
+    if (i == n) {
+      return false;
+    }
+    *entry = {2 * i, i};
+    i++;
+    return true;
+  };
+  ASSERT_TRUE(tree.BulkLoad(next, n));
+  const int probe_nums = 400000;
+  std::mt19937 rng(11);
+  for (int batch : {16, 256, 4096}) {
+    // half of the probes hit, like an IN list or the outer rows of a join
+    std::vector<std::vector<int>> batches(probe_nums / batch);
+    for (auto &probes : batches) {
+      for (int j = 0; j < batch; j++) {
+        probes.push_back(static_cast<int>(rng() % (2 * n)));
+      }
+    }
+    int64_t checksum[2] = {0, 0};
+    auto t0 = Clock::now();
+    std::vector<int> ans;
+    for (auto &probes : batches) {
+      for (auto key : probes) {
+        ans.clear();
+        if (tree.GetValue(key, ans)) {
+          checksum[0] += ans[0];
+        }
+      }
+    }
+    auto t1 = Clock::now();
+    std::vector<int> values;
+    std::vector<bool> found;
+    for (auto &probes : batches) {
+      tree.GetValues(probes, values, found);
+      for (int j = 0; j < batch; j++) {
+        checksum[1] += found[j] ? values[j] : 0;
+      }
+    }
+    auto t2 = Clock::now();
+    ASSERT_EQ(checksum[0], checksum[1]);
+    ASSERT_TRUE(tree.Check());
+    auto ns_per_probe = [&](Clock::time_point begin, Clock::time_point end) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / probe_nums;
+    };
+    LOG(INFO) << "batches of " << batch << " probes in " << n << " int keys: GetValue loop " << ns_per_probe(t0, t1)
+              << " ns, GetValues " << ns_per_probe(t1, t2) << " ns per probe";
+  }
+}
+
+TEST(BPlusTreeTests, ConcurrentTest) {
+  // small pages split and merge often, so that threads keep meeting on the pessimistic path
+  DBStorageEngine engine(db_name, true, 4096);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 16, 16);
+  const int thread_nums = 4;
+  const int n = 20000;
+  auto run = [&](const std::function<void(int)> &work) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_nums; t++) {
+      threads.emplace_back(work, t);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+  // every thread inserts its own keys in random order while looking up the keys of the others
+  run([&](int t) {
+    std::vector<int> keys;
+    for (int key = t; key < n; key += thread_nums) {
+      keys.push_back(key);
+    }
+    ShuffleArray(keys);
+    std::mt19937 rng(t);
+    vector<int> ans;
+    for (auto key : keys) {
+      ASSERT_TRUE(tree.Insert(key, 2 * key));
+      ASSERT_FALSE(tree.Insert(key, 0));
+      int probe = static_cast<int>(rng() % n);
+      ans.clear();
+      if (tree.GetValue(probe, ans)) {
+        ASSERT_EQ(2 * probe, ans[0]);
+      }
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  vector<int> ans;
+  for (int key = 0; key < n; key++) {
+    ASSERT_TRUE(tree.GetValue(key, ans));
+    ASSERT_EQ(2 * key, ans.back());
+  }
+  // then removes three keys of four, the leaves merge under the lookups
+  run([&](int t) {
+    std::vector<int> keys;
+    for (int key = t; key < n; key += thread_nums) {
+      if (key % 4 != 0) {
+        keys.push_back(key);
+      }
+    }
+    ShuffleArray(keys);
+    vector<int> result;
+    for (auto key : keys) {
+      tree.Remove(key);
+      result.clear();
+      ASSERT_FALSE(tree.GetValue(key, result));
+      int kept = key / 4 * 4;
+      ASSERT_TRUE(tree.GetValue(kept, result));
+      ASSERT_EQ(2 * kept, result[0]);
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expected += 4) {
+    ASSERT_EQ(expected, (*iter).first);
+  }
+  ASSERT_EQ(n, expected);
+}
+
+TEST(BPlusTreeTests, ConcurrentBenchmark) {
+  using Clock = std::chrono::high_resolution_clock;
+  BasicComparator<int> comparator;
+  const int op_nums = 200000;
+  for (int thread_nums : {1, 2, 4, 8}) {
+    DBStorageEngine engine(db_name, true, 4096);
+    BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator);
+    // a loaded tree, then three lookups to one insert split over the threads
+    for (int key = 0; key < op_nums; key += 2) {
+      tree.Insert(key, key);
+    }
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int t = 0; t < thread_nums; t++) {
+      threads.emplace_back([&, t]() {
+        std::mt19937 rng(t);
+        vector<int> ans;
+        for (int i = t; i < op_nums; i += thread_nums) {
+          if (i % 4 == 0) {
+            tree.Insert(2 * (i / 4) + 1, i);
+          } else {
+            tree.GetValue(static_cast<int>(rng() % op_nums), ans);
+            ans.clear();
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    ASSERT_TRUE(tree.Check());
+    LOG(INFO) << thread_nums << " threads on " << std::thread::hardware_concurrency() << " cores: "
+              << static_cast<int64_t>(op_nums) * 1000000 / ns << " k ops/s";
+  }
+}
+
+TEST(BPlusTreeTests, SequentialInsertTest) {
+  using Clock = std::chrono::high_resolution_clock;
+  using LeafPage = BPlusTreeLeafPage<int, int, BasicComparator<int>>;
+  BasicComparator<int> comparator;
+  DBStorageEngine engine(db_name, true, 4096);
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator);
+  // increasing ids, like the primary keys of a table being loaded
+  const int start = 12500000;
+  const int n = 200000;
+  auto t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(tree.Insert(start + i, i));
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+  ASSERT_TRUE(tree.Check());
+  // right edge splits leave every leaf but the last one full
+  int leaf_nums = 0;
+  int key = start;
+  Page *page = tree.FindLeafPage(start);
+  while (true) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf_nums++;
+    for (int j = 0; j < leaf->GetSize(); j++, key++) {
+      ASSERT_EQ(key, leaf->KeyAt(j));
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    ASSERT_TRUE(next_page_id == INVALID_PAGE_ID || leaf->GetSize() == leaf->GetMaxSize());
+    engine.bpm_->UnpinPage(page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    page = engine.bpm_->FetchPage(next_page_id);
+  }
+  ASSERT_EQ(start + n, key);
+  LOG(INFO) << n << " increasing keys in " << leaf_nums << " leaves, " << ns / n << " ns per insert";
+
+  // keys in between and below still split in half, and removes at the right edge are seen by later appends
+  vector<int> ans;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(tree.Insert(start - 1 - i, -i));
+    ASSERT_FALSE(tree.Insert(start + i * 97, 0));
+  }
+  for (int i = 0; i < 5000; i++) {
+    tree.Remove(start + n - 1 - i);
+  }
+  for (int i = 0; i < 5000; i++) {
+    ASSERT_TRUE(tree.Insert(start + n + i, i));
+  }
+  ASSERT_TRUE(tree.Check());
+  for (int i = -1000; i < n + 5000; i++) {
+    ans.clear();
+    ASSERT_EQ(i < n - 5000 || i >= n, tree.GetValue(start + i, ans));
+  }
+
+  // threads appending at once meet at the rightmost leaf
+  const int thread_nums = 4;
+  const int append_nums = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_nums; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < append_nums; i += thread_nums) {
+        ASSERT_TRUE(tree.Insert(start + n + 5000 + i, i));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(tree.Check());
+  for (int i = 0; i < append_nums; i++) {
+    ans.clear();
+    ASSERT_TRUE(tree.GetValue(start + n + 5000 + i, ans));
+    ASSERT_EQ(i, ans[0]);
+  }
+}
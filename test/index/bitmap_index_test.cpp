@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "index/bitmap_index.h"
+#include "utils/utils.h"
+
+namespace {
+
+std::set<int64_t> ToSet(const RoaringBitmap &bitmap) {
+  std::vector<RowId> rids;
+  bitmap.ToRowIds(&rids);
+  std::set<int64_t> result;
+  for (auto &rid : rids) {
+    result.insert(rid.Get());
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(BitmapIndexTests, RoaringBitmapTest) {
+  // sparse pages stay arrays, dense pages become bitmaps
+  RoaringBitmap a;
+  RoaringBitmap b;
+  std::set<int64_t> set_a;
+  std::set<int64_t> set_b;
+  for (page_id_t page = 0; page < 20; page++) {
+    uint32_t step = page % 2 == 0 ? 1 : 37;
+    for (uint32_t slot = 0; slot < 1000; slot += step) {
+      a.Add(RowId(page, slot));
+      set_a.insert(RowId(page, slot).Get());
+    }
+    for (uint32_t slot = page % 3; slot < 1000; slot += 3) {
+      b.Add(RowId(page + 10, slot));
+      set_b.insert(RowId(page + 10, slot).Get());
+    }
+  }
+  ASSERT_FALSE(a.Add(RowId(0, 0)));
+  ASSERT_EQ(set_a.size(), a.GetCardinality());
+  ASSERT_EQ(set_a, ToSet(a));
+  ASSERT_TRUE(a.Contains(RowId(3, 37)));
+  ASSERT_FALSE(a.Contains(RowId(3, 38)));
+  // 10 dense pages take a bitmap each, 10 sparse ones 28 slots each
+  ASSERT_EQ(20 * sizeof(page_id_t) + 10 * RoaringBitmap::BITMAP_WORDS * sizeof(uint64_t) + 10 * 28 * sizeof(uint16_t),
+            a.GetSizeInBytes());
+
+  std::set<int64_t> expected;
+  RoaringBitmap result = a;
+  result.And(b);
+  std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(),
+                        std::inserter(expected, expected.end()));
+  ASSERT_EQ(expected, ToSet(result));
+  ASSERT_EQ(expected.size(), result.GetCardinality());
+
+  expected.clear();
+  result = a;
+  result.Or(b);
+  std::set_union(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::inserter(expected, expected.end()));
+  ASSERT_EQ(expected, ToSet(result));
+  ASSERT_EQ(expected.size(), result.GetCardinality());
+
+  expected.clear();
+  result = a;
+  result.AndNot(b);
+  std::set_difference(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(),
+                      std::inserter(expected, expected.end()));
+  ASSERT_EQ(expected, ToSet(result));
+
+  RoaringBitmap universe = a;
+  universe.Or(b);
+  result = b;
+  result.Not(universe);
+  ASSERT_EQ(expected, ToSet(result));
+
+  // removing slots turns a dense page back into an array, removing all of them drops the page
+  for (uint32_t slot = 0; slot < 1000; slot++) {
+    if (slot >= 100) {
+      ASSERT_TRUE(a.Remove(RowId(0, slot)));
+    }
+    a.Remove(RowId(1, slot));
+  }
+  ASSERT_FALSE(a.Remove(RowId(0, 500)));
+  ASSERT_FALSE(a.Contains(RowId(1, 0)));
+  ASSERT_EQ(set_a.size() - 900 - 28, a.GetCardinality());
+  ASSERT_EQ(19 * sizeof(page_id_t) + 9 * RoaringBitmap::BITMAP_WORDS * sizeof(uint64_t) +
+                    (9 * 28 + 100) * sizeof(uint16_t),
+            a.GetSizeInBytes());
+}
+
+TEST(BitmapIndexTests, BitmapIndexSimpleTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("region", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{1};
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  BitmapIndex index(0, key_schema);
+  std::vector<std::string> regions{"north", "south", "east", "west"};
+  auto make_key = [](const std::string *region) {
+    std::vector<Field> fields;
+    if (region == nullptr) {
+      fields.emplace_back(TypeId::kTypeChar);
+    } else {
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(region->data()), region->size(), true);
+    }
+    return Row(fields);
+  };
+  const int row_nums = 1000;
+  for (int i = 0; i < row_nums; i++) {
+    Row key = make_key(i % 5 == 4 ? nullptr : &regions[i % 5]);
+    // keys repeat, every insert succeeds
+    ASSERT_EQ(DB_SUCCESS, index.InsertEntry(key, RowId(i / 100, i % 100), nullptr));
+  }
+  ASSERT_EQ(5, index.GetKeyCount());
+  ASSERT_EQ(row_nums, index.GetAllRows().GetCardinality());
+
+  std::vector<RowId> result;
+  Row south = make_key(&regions[1]);
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(south, result, nullptr));
+  ASSERT_EQ(row_nums / 5, result.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    ASSERT_EQ(1, (result[i].GetPageId() * 100 + result[i].GetSlotNum()) % 5);
+    // rows come in row id order
+    ASSERT_TRUE(i == 0 || result[i - 1].Get() < result[i].Get());
+  }
+  std::string nowhere = "nowhere";
+  ASSERT_EQ(nullptr, index.GetBitmap(make_key(&nowhere)));
+  ASSERT_EQ(row_nums / 5, index.GetBitmap(make_key(nullptr))->GetCardinality());
+
+  // region = 'north' or region = 'south', then not null
+  RoaringBitmap north_or_south = *index.GetBitmap(make_key(&regions[0]));
+  north_or_south.Or(*index.GetBitmap(south));
+  ASSERT_EQ(2 * row_nums / 5, north_or_south.GetCardinality());
+  RoaringBitmap others = north_or_south;
+  others.Not(index.GetAllRows());
+  others.AndNot(*index.GetBitmap(make_key(nullptr)));
+  ASSERT_EQ(2 * row_nums / 5, others.GetCardinality());
+
+  // the last row of a key takes its bitmap along
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.RemoveEntry(south, RowId(0, 0), nullptr));
+  for (int i = 1; i < row_nums; i += 5) {
+    ASSERT_EQ(DB_SUCCESS, index.RemoveEntry(south, RowId(i / 100, i % 100), nullptr));
+  }
+  ASSERT_EQ(4, index.GetKeyCount());
+  ASSERT_EQ(row_nums - row_nums / 5, index.GetAllRows().GetCardinality());
+  result.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.ScanKey(south, result, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index.Destroy());
+  ASSERT_EQ(0, index.GetKeyCount());
+}
@@ -1,6 +1,8 @@
+#include <chrono>
 #include <cstring>
 
 #include "common/instance.h"
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
 #include "record/field.h"
@@ -156,4 +158,292 @@ TEST(TupleTest, SchemaTest) {
   ASSERT_EQ(2, (*iter)->GetTableInd());
   ASSERT_EQ(true, (*iter)->IsNullable());
 
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false),
+          ALLOC_COLUMN(heap)("comment", TypeId::kTypeChar, 64, 3, true, false)
+  };
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeFloat, 19.99f),
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false)
+  };
+  Schema schema(columns);
+  Row row(fields);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), &schema, &view));
+  ASSERT_EQ(4, view.GetFieldCount());
+  ASSERT_EQ(row.GetSerializedSize(&schema), view.GetSerializedSize());
+  ASSERT_FALSE(view.IsNull(0));
+  ASSERT_TRUE(view.IsNull(1));
+  ASSERT_FALSE(view.IsNull(2));
+  ASSERT_FALSE(view.IsNull(3));
+  // access out of order to exercise the lazy offset cache
+  uint32_t len = 0;
+  const char *chars = view.GetChars(3, &len);
+  ASSERT_EQ(strlen("minisql"), len);
+  ASSERT_EQ(0, memcmp("minisql", chars, len));
+  ASSERT_EQ(188, view.GetInt(0));
+  ASSERT_FLOAT_EQ(19.99f, view.GetFloat(2));
+  ASSERT_EQ(CmpBool::kTrue, view.CompareEquals(0, fields[0]));
+  ASSERT_EQ(CmpBool::kNull, view.CompareEquals(1, fields[1]));
+  ASSERT_EQ(CmpBool::kTrue, view.CompareLessThan(2, Field(TypeId::kTypeFloat, 20.0f)));
+  ASSERT_EQ(CmpBool::kTrue, view.CompareGreaterThan(3, char_fields[1]));
+  Field *field = view.GetField(3, &heap);
+  ASSERT_EQ(CmpBool::kTrue, field->CompareEquals(fields[3]));
+
+  // views over two rows compare column by column
+  std::vector<Field> other_fields = {
+          Field(TypeId::kTypeInt, 189),
+          Field(TypeId::kTypeChar, const_cast<char *>("a"), 1, false),
+          Field(TypeId::kTypeFloat, 19.99f),
+          Field(TypeId::kTypeChar, const_cast<char *>("minisqm"), strlen("minisqm"), false)
+  };
+  Row other_row(other_fields);
+  ASSERT_TRUE(table_page.InsertTuple(other_row, &schema, nullptr, nullptr, nullptr));
+  RowView other_view;
+  ASSERT_TRUE(table_page.GetTupleView(other_row.GetRowId(), &schema, &other_view));
+  ASSERT_GT(0, view.CompareField(0, other_view, 0));
+  ASSERT_EQ(0, view.CompareField(1, other_view, 1));
+  ASSERT_EQ(0, view.CompareField(2, other_view, 2));
+  ASSERT_GT(0, view.CompareField(3, other_view, 3));
+  ASSERT_LT(0, other_view.CompareField(3, view, 3));
+
+  ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
+  table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
+  ASSERT_FALSE(table_page.GetTupleView(row.GetRowId(), &schema, &view));
+}
+
+TEST(TupleTest, CompactRowTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 0, true, false),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, false, false),
+          ALLOC_COLUMN(heap)("comment", TypeId::kTypeChar, 64, 2, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 3, true, false),
+          ALLOC_COLUMN(heap)("remark", TypeId::kTypeChar, 64, 4, true, false)
+  };
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeFloat),
+          Field(TypeId::kTypeChar, const_cast<char *>("hello"), strlen("hello"), false)
+  };
+  Schema schema(columns);
+  schema.SetRowFormat(kRowFormatV2);
+  Row row(fields);
+  // bitmap + two fixed-width slots + three var end offsets + var data
+  ASSERT_EQ(1 + 8 + 3 * sizeof(uint16_t) + strlen("minisql") + strlen("hello"), row.GetSerializedSize(&schema));
+  Schema legacy_schema(columns);
+  ASSERT_LT(row.GetSerializedSize(&schema), row.GetSerializedSize(&legacy_schema));
+
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page.InsertTuple(row, &schema, nullptr, nullptr, nullptr));
+  Row row2(row.GetRowId());
+  ASSERT_TRUE(table_page.GetTuple(&row2, &schema, nullptr, nullptr));
+  ASSERT_EQ(row.GetRowId(), row2.GetRowId());
+  ASSERT_EQ(fields.size(), row2.GetFieldCount());
+  for (size_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), &schema, &view));
+  ASSERT_EQ(row.GetRowId(), view.GetRowId());
+  ASSERT_EQ(row.GetSerializedSize(&schema), view.GetSerializedSize());
+  uint32_t len = 0;
+  const char *chars = view.GetChars(4, &len);
+  ASSERT_EQ(strlen("hello"), len);
+  ASSERT_EQ(0, memcmp("hello", chars, len));
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_TRUE(view.IsNull(3));
+  ASSERT_EQ(188, view.GetInt(1));
+  chars = view.GetChars(0, &len);
+  ASSERT_EQ(0, memcmp("minisql", chars, len));
+
+  // update in place with a longer value
+  std::vector<Field> new_fields = {
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql v2"), strlen("minisql v2"), false),
+          Field(TypeId::kTypeInt, 189),
+          Field(TypeId::kTypeChar, const_cast<char *>("c"), 1, false),
+          Field(TypeId::kTypeFloat, 1.5f),
+          Field(TypeId::kTypeChar)
+  };
+  Row new_row(new_fields);
+  Row old_row(row.GetRowId());
+  ASSERT_EQ(1, table_page.UpdateTuple(new_row, &old_row, &schema, nullptr, nullptr, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, old_row.GetField(0)->CompareEquals(fields[0]));
+  Row row3(row.GetRowId());
+  ASSERT_TRUE(table_page.GetTuple(&row3, &schema, nullptr, nullptr));
+  for (size_t i = 0; i < new_fields.size(); i++) {
+    ASSERT_EQ(new_fields[i].IsNull(), row3.GetField(i)->IsNull());
+    if (!new_fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row3.GetField(i)->CompareEquals(new_fields[i]));
+    }
+  }
+}
+
+/**
+ * Row serialization through per-field Type dispatch, the path RowCodec replaces
+ */
+static uint32_t DispatchSerialize(Row &row, char *buf) {
+  MACH_WRITE_TO(int64_t, buf, row.GetRowId().Get());
+  uint32_t ofs = sizeof(int64_t);
+  MACH_WRITE_TO(size_t, buf + ofs, row.GetFieldCount());
+  ofs += sizeof(size_t);
+  unsigned char *bitmap = reinterpret_cast<unsigned char *>(buf + ofs);
+  memset(bitmap, 0, (row.GetFieldCount() + 7) / 8);
+  for (size_t i = 0; i < row.GetFieldCount(); ++i)
+    if (row.GetField(i)->IsNull()) bitmap[i / 8] |= 1u << (i % 8);
+  ofs += (row.GetFieldCount() + 7) / 8;
+  for (auto field : row.GetFields()) {
+    ofs += field->SerializeTo(buf + ofs);
+  }
+  return ofs;
+}
+
+static uint32_t DispatchDeserialize(char *buf, Schema *schema, MemHeap *heap, std::vector<Field *> &fields) {
+  size_t size = MACH_READ_FROM(size_t, buf + sizeof(int64_t));
+  uint32_t ofs = sizeof(int64_t) + sizeof(size_t);
+  const unsigned char *bitmap = reinterpret_cast<unsigned char *>(buf + ofs);
+  ofs += (size + 7) / 8;
+  for (size_t i = 0; i < size; ++i) {
+    Field *field = nullptr;
+    ofs += Field::DeserializeFrom(buf + ofs, schema->GetColumn(i)->GetType(), &field, (bitmap[i / 8] >> (i % 8)) & 1,
+                                  heap);
+    fields.push_back(field);
+  }
+  return ofs;
+}
+
+TEST(TupleTest, RowCodecBenchmark) {
+  using Clock = std::chrono::high_resolution_clock;
+  SimpleMemHeap heap;
+  const int column_nums = 12;
+  const int rounds = 20000;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  for (int i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    switch (i % 3) {
+      case 0:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+        fields.emplace_back(TypeId::kTypeInt, i * 7);
+        break;
+      case 1:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeFloat, i, true, false));
+        fields.emplace_back(TypeId::kTypeFloat, i * 0.5f);
+        break;
+      default:
+        columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 32, i, true, false));
+        fields.emplace_back(TypeId::kTypeChar, chars[i % 3], strlen(chars[i % 3]), false);
+        break;
+    }
+  }
+  Schema schema(columns);
+  Row row(fields);
+  row.SetRowId(RowId(3, 7));
+  char codec_buf[PAGE_SIZE];
+  char dispatch_buf[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(codec_buf, &schema);
+  ASSERT_EQ(size, DispatchSerialize(row, dispatch_buf));
+  ASSERT_EQ(0, memcmp(codec_buf, dispatch_buf, size));
+
+  auto t0 = Clock::now();
+  for (int i = 0; i < rounds; i++) {
+    DispatchSerialize(row, dispatch_buf);
+    SimpleMemHeap row_heap;
+    std::vector<Field *> out;
+    ASSERT_EQ(size, DispatchDeserialize(dispatch_buf, &schema, &row_heap, out));
+  }
+  auto t1 = Clock::now();
+  for (int i = 0; i < rounds; i++) {
+    row.SerializeTo(codec_buf, &schema);
+    Row out(row.GetRowId());
+    ASSERT_EQ(size, out.DeserializeFrom(codec_buf, &schema));
+  }
+  auto t2 = Clock::now();
+  schema.SetRowFormat(kRowFormatV2);
+  uint32_t v2_size = row.SerializeTo(codec_buf, &schema);
+  for (int i = 0; i < rounds; i++) {
+    row.SerializeTo(codec_buf, &schema);
+    Row out(row.GetRowId());
+    ASSERT_EQ(v2_size, out.DeserializeFrom(codec_buf, &schema));
+  }
+  auto t3 = Clock::now();
+  ArenaMemHeap arena;
+  for (int i = 0; i < rounds; i++) {
+    row.SerializeTo(codec_buf, &schema);
+    arena.Reset();
+    Row out(row.GetRowId(), &arena);
+    ASSERT_EQ(v2_size, out.DeserializeFrom(codec_buf, &schema));
+  }
+  auto t4 = Clock::now();
+  auto ns_per_row = [&](Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / rounds;
+  };
+  LOG(INFO) << "row round trip, " << column_nums << " columns: type dispatch " << ns_per_row(t0, t1)
+            << " ns, codec v1 " << ns_per_row(t1, t2) << " ns, codec v2 " << ns_per_row(t2, t3)
+            << " ns, codec v2 with arena " << ns_per_row(t3, t4) << " ns";
+}
+
+TEST(TupleTest, ArenaRowTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  Schema schema(columns);
+  schema.SetRowFormat(kRowFormatV2);
+  char buf[PAGE_SIZE];
+  ArenaMemHeap arena(PAGE_SIZE);
+  for (int i = 0; i < 1000; i++) {
+    arena.Reset();
+    std::string name = "name" + std::to_string(i);
+    std::vector<Field> fields = {
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), false),
+            Field(TypeId::kTypeFloat, i * 0.25f)
+    };
+    Row row(fields, &arena);
+    uint32_t size = row.SerializeTo(buf, &schema);
+    Row copy(RowId(0, i), &arena);
+    ASSERT_EQ(size, copy.DeserializeFrom(buf, &schema));
+    for (size_t j = 0; j < fields.size(); j++) {
+      ASSERT_EQ(CmpBool::kTrue, copy.GetField(j)->CompareEquals(fields[j]));
+    }
+    // an empty string still decodes as a non-null value
+    std::vector<Field> empty = {
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, chars[0], 0, false),
+            Field(TypeId::kTypeFloat)
+    };
+    Row empty_row(empty, &arena);
+    empty_row.SerializeTo(buf, &schema);
+    Row empty_copy(RowId(0, i), &arena);
+    empty_copy.DeserializeFrom(buf, &schema);
+    ASSERT_FALSE(empty_copy.GetField(1)->IsNull());
+    ASSERT_EQ(0, empty_copy.GetField(1)->GetLength());
+    ASSERT_TRUE(empty_copy.GetField(2)->IsNull());
+  }
+  // rewinding reuses the first block instead of allocating new ones
+  ASSERT_EQ(1, arena.GetBlockCount());
+  // large requests bypass the blocks
+  ASSERT_NE(nullptr, arena.Allocate(PAGE_SIZE));
+  ASSERT_EQ(1, arena.GetBlockCount());
+}
@@ -1,7 +1,10 @@
+#include <sys/stat.h>
+#include <random>
 #include <unordered_set>
 
 #include "gtest/gtest.h"
 #include "storage/disk_manager.h"
+#include "storage/page_compressor.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
   const size_t size = 512;
@@ -55,4 +58,126 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+
+TEST(DiskManagerTest, BulkDeAllocationTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  int extent_nums = 3;
+  for (uint32_t i = 0; i < DiskManager::BITMAP_SIZE * extent_nums; i++) {
+    disk_mgr->AllocatePage();
+  }
+  // the last extent empties and is dropped, pages listed twice are freed once
+  std::vector<page_id_t> page_ids{static_cast<page_id_t>(DiskManager::BITMAP_SIZE + 1), 0, 0};
+  for (uint32_t i = 0; i < DiskManager::BITMAP_SIZE; i++) {
+    page_ids.push_back(2 * DiskManager::BITMAP_SIZE + i);
+  }
+  disk_mgr->DeAllocatePages(page_ids);
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ((extent_nums - 1) * DiskManager::BITMAP_SIZE - 2, meta_page->GetAllocatedPages());
+  EXPECT_EQ(extent_nums - 1, meta_page->GetExtentNums());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 1, meta_page->GetExtentUsedPage(0));
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 1, meta_page->GetExtentUsedPage(1));
+  EXPECT_TRUE(disk_mgr->IsPageFree(0));
+  EXPECT_FALSE(disk_mgr->IsPageFree(1));
+  EXPECT_TRUE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 1));
+  // freed pages are handed out again first
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove((db_name + DiskManager::SLOT_FILE_SUFFIX).c_str());
+}
+TEST(DiskManagerTest, PageCompressorTest) {
+  char page[PAGE_SIZE];
+  char compressed[PAGE_SIZE];
+  char decompressed[PAGE_SIZE];
+  // an empty page is one long run
+  memset(page, 0, PAGE_SIZE);
+  uint32_t len = PageCompressor::Compress(page, PAGE_SIZE, compressed, PAGE_SIZE);
+  ASSERT_GT(len, 0);
+  ASSERT_LT(len, 64);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, len, decompressed, PAGE_SIZE));
+  ASSERT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+  // repeated text
+  for (uint32_t ofs = 0; ofs < PAGE_SIZE; ofs++) {
+    page[ofs] = "status delivered, warehouse "[ofs % 28] + (ofs / 700);
+  }
+  len = PageCompressor::Compress(page, PAGE_SIZE, compressed, PAGE_SIZE);
+  ASSERT_GT(len, 0);
+  ASSERT_LT(len, PAGE_SIZE / 4);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, len, decompressed, PAGE_SIZE));
+  ASSERT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+  // truncated or wrongly sized input is rejected
+  ASSERT_FALSE(PageCompressor::Decompress(compressed, len / 2, decompressed, PAGE_SIZE));
+  ASSERT_FALSE(PageCompressor::Decompress(compressed, len, decompressed, PAGE_SIZE - 1));
+  // random bytes do not shrink, compression gives up at the capacity
+  std::mt19937 random(17);
+  for (uint32_t ofs = 0; ofs < PAGE_SIZE; ofs++) {
+    page[ofs] = static_cast<char>(random());
+  }
+  ASSERT_EQ(0, PageCompressor::Compress(page, PAGE_SIZE, compressed, PAGE_SIZE - 1));
+}
+
+TEST(DiskManagerTest, PageCompressionTest) {
+  std::string db_name = "disk_compression_test.db";
+  remove(db_name.c_str());
+  char page[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+  auto fill_page = [&page](page_id_t page_id, bool compressible) {
+    std::mt19937 random(page_id);
+    for (uint32_t ofs = 0; ofs < PAGE_SIZE; ofs++) {
+      page[ofs] =
+              compressible ? static_cast<char>('a' + (ofs + page_id) % 16 * (ofs % 3)) : static_cast<char>(random());
+    }
+  };
+  auto *disk_mgr = new DiskManager(db_name);
+  const int page_nums = 20;
+  for (int i = 0; i < page_nums; i++) {
+    page_id_t page_id = disk_mgr->AllocatePage();
+    ASSERT_EQ(i, page_id);
+    // even pages compress, odd pages are random, pages from 10 on are not marked
+    if (i < 10) {
+      disk_mgr->SetPageCompression(page_id, true);
+    }
+    fill_page(page_id, i % 2 == 0);
+    disk_mgr->WritePage(page_id, page);
+  }
+  ASSERT_EQ(5, disk_mgr->GetCompressedPageCount());
+  ASSERT_LT(disk_mgr->GetStoredSize(0), PAGE_SIZE);
+  ASSERT_EQ(PAGE_SIZE, disk_mgr->GetStoredSize(1));
+  ASSERT_EQ(PAGE_SIZE, disk_mgr->GetStoredSize(12));
+  // a compressed page that turns incompressible moves back into the db file, its slot is reused
+  fill_page(0, false);
+  disk_mgr->WritePage(0, page);
+  ASSERT_EQ(PAGE_SIZE, disk_mgr->GetStoredSize(0));
+  struct stat slot_stat;
+  ASSERT_EQ(0, stat((db_name + DiskManager::SLOT_FILE_SUFFIX).c_str(), &slot_stat));
+  off_t slot_file_size = slot_stat.st_size;
+  fill_page(0, true);
+  disk_mgr->WritePage(0, page);
+  ASSERT_EQ(0, stat((db_name + DiskManager::SLOT_FILE_SUFFIX).c_str(), &slot_stat));
+  ASSERT_EQ(slot_file_size, slot_stat.st_size);
+  disk_mgr->DeAllocatePage(8);
+  ASSERT_EQ(4, disk_mgr->GetCompressedPageCount());
+  delete disk_mgr;
+
+  // the page map is rebuilt from the slot file
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(4, disk_mgr->GetCompressedPageCount());
+  for (int i = 0; i < page_nums; i++) {
+    if (i == 8) {
+      continue;
+    }
+    disk_mgr->ReadPage(i, buf);
+    fill_page(i, i % 2 == 0);
+    ASSERT_EQ(0, memcmp(page, buf, PAGE_SIZE));
+  }
+  // disabling compression stores the page uncompressed on its next write
+  disk_mgr->SetPageCompression(2, false);
+  disk_mgr->WritePage(2, page);
+  ASSERT_EQ(PAGE_SIZE, disk_mgr->GetStoredSize(2));
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove((db_name + DiskManager::SLOT_FILE_SUFFIX).c_str());
+}
@@ -1,10 +1,14 @@
+#include <algorithm>
+#include <chrono>
 #include <vector>
+#include <set>
 #include <unordered_map>
 
 // #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "record/field.h"
 #include "record/schema.h"
+#include "executor/parallel_scan.h"
 #include "storage/table_heap.h"
 #include "utils/utils.h"
 
@@ -71,3 +75,660 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 }
 
+
+TEST(TableHeapTest, ToastTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_toast_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  const int row_nums = 100;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("doc", TypeId::kTypeChar, VARCHAR_MAX_LEN - 1, 1, true, false),
+          ALLOC_COLUMN(heap)("tag", TypeId::kTypeChar, 16, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatV2);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::unordered_map<int64_t, std::string> docs;
+  std::set<page_id_t> heap_pages;
+  for (int i = 0; i < row_nums; i++) {
+    std::string doc(RandomUtils::RandomInt(TOAST_THRESHOLD + 1, VARCHAR_MAX_LEN - 1), 'a' + i % 26);
+    doc[doc.size() - 1] = 'z';
+    Fields fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(doc.data()), doc.size(), true),
+            Field(TypeId::kTypeChar, const_cast<char *>("tag"), 3, true)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    docs[row.GetRowId().Get()] = doc;
+    heap_pages.insert(row.GetRowId().GetPageId());
+  }
+  // only toast pointers are kept inline, many wide rows share a heap page
+  ASSERT_LT(heap_pages.size(), row_nums / 10);
+
+  for (auto &kv : docs) {
+    Row row(RowId(kv.first));
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_FALSE(row.GetField(1)->IsExternal());
+    ASSERT_EQ(kv.second.size(), row.GetField(1)->GetLength());
+    ASSERT_EQ(0, memcmp(kv.second.data(), row.GetField(1)->GetData(), kv.second.size()));
+  }
+
+  // narrow projection leaves the wide value in its overflow pages
+  int count = 0;
+  std::vector<uint32_t> fetch{0, 2};
+  for (auto iter = table_heap->Begin(nullptr, fetch); iter != table_heap->End(); ++iter) {
+    const char *pointer = iter->GetField(1)->GetData();
+    ASSERT_TRUE(iter->GetField(1)->IsExternal());
+    ASSERT_EQ(docs[iter->GetRowId().Get()].size(), MACH_READ_UINT32(pointer));
+    ASSERT_EQ(0, memcmp(docs[iter->GetRowId().Get()].data(), pointer + OverflowPage::SIZE_TOAST_POINTER,
+                        TOAST_PREFIX_LEN));
+    ASSERT_FALSE(iter->GetField(2)->IsExternal());
+    ASSERT_EQ(0, memcmp("tag", iter->GetField(2)->GetData(), 3));
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+
+  // overflow chains are released with their tuple
+  RowId rid(docs.begin()->first);
+  Row deferred(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&deferred, nullptr, {0}));
+  page_id_t overflow_page_id = MACH_READ_FROM(page_id_t, deferred.GetField(1)->GetData() + sizeof(uint32_t));
+  ASSERT_FALSE(bpm_->IsPageFree(overflow_page_id));
+  ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+  table_heap->ApplyDelete(rid, nullptr);
+  ASSERT_TRUE(bpm_->IsPageFree(overflow_page_id));
+  Row deleted(rid);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted, nullptr));
+
+  // updating to a short value drops the old chain
+  rid = RowId(std::next(docs.begin())->first);
+  Row before(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&before, nullptr, {0}));
+  overflow_page_id = MACH_READ_FROM(page_id_t, before.GetField(1)->GetData() + sizeof(uint32_t));
+  Fields short_fields{
+          Field(TypeId::kTypeInt, -1),
+          Field(TypeId::kTypeChar, const_cast<char *>("short"), 5, true),
+          Field(TypeId::kTypeChar, const_cast<char *>("tag"), 3, true)
+  };
+  Row updated(short_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(updated, rid, nullptr));
+  ASSERT_TRUE(bpm_->IsPageFree(overflow_page_id));
+  Row after(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&after, nullptr));
+  ASSERT_EQ(0, memcmp("short", after.GetField(1)->GetData(), 5));
+
+  // an update that outgrows a full page moves the tuple, the old tuple takes its chain along
+  page_id_t first_page_id = *heap_pages.begin();
+  auto moved_entry = std::find_if(docs.begin(), docs.end(), [&](const std::pair<const int64_t, std::string> &kv) {
+    RowId candidate(kv.first);
+    return candidate.GetPageId() == first_page_id && candidate.Get() != rid.Get() &&
+           candidate.Get() != docs.begin()->first;
+  });
+  ASSERT_NE(docs.end(), moved_entry);
+  RowId moved_rid(moved_entry->first);
+  Row moving(moved_rid);
+  ASSERT_TRUE(table_heap->GetTuple(&moving, nullptr, {0}));
+  overflow_page_id = MACH_READ_FROM(page_id_t, moving.GetField(1)->GetData() + sizeof(uint32_t));
+  std::string inline_doc(TOAST_THRESHOLD, 'm');
+  Fields inline_fields{
+          Field(TypeId::kTypeInt, -2),
+          Field(TypeId::kTypeChar, const_cast<char *>(inline_doc.data()), inline_doc.size(), true),
+          Field(TypeId::kTypeChar, const_cast<char *>("tag"), 3, true)
+  };
+  Row grown(inline_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(grown, moved_rid, nullptr));
+  ASSERT_NE(moved_rid.Get(), grown.GetRowId().Get());
+  ASSERT_TRUE(bpm_->IsPageFree(overflow_page_id));
+  Row stale(moved_rid);
+  ASSERT_FALSE(table_heap->GetTuple(&stale, nullptr));
+  Row moved(grown.GetRowId());
+  ASSERT_TRUE(table_heap->GetTuple(&moved, nullptr));
+  ASSERT_EQ(0, memcmp(inline_doc.data(), moved.GetField(1)->GetData(), inline_doc.size()));
+
+  // a delete marks the rows during the scan and applies the deletes after it, as the executor does
+  std::vector<RowId> deleted_rids;
+  std::vector<page_id_t> freed_page_ids;
+  int kept = 0;
+  for (auto iter = table_heap->Begin(nullptr, {0}); iter != table_heap->End(); ++iter) {
+    if (iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 0)) != CmpBool::kTrue &&
+        iter->GetField(1)->IsExternal()) {
+      freed_page_ids.push_back(MACH_READ_FROM(page_id_t, iter->GetField(1)->GetData() + sizeof(uint32_t)));
+      ASSERT_TRUE(table_heap->MarkDelete(iter->GetRowId(), nullptr));
+      deleted_rids.push_back(iter->GetRowId());
+    } else {
+      kept++;
+    }
+  }
+  ASSERT_LT(row_nums / 2, deleted_rids.size());
+  for (auto &deleted_rid : deleted_rids) {
+    table_heap->ApplyDelete(deleted_rid, nullptr);
+  }
+  for (auto page_id : freed_page_ids) {
+    ASSERT_TRUE(bpm_->IsPageFree(page_id));
+  }
+  int left = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    left++;
+  }
+  ASSERT_EQ(kept, left);
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, PageDirectoryTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_directory_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, TOAST_THRESHOLD, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatV2);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_EQ(1, table_heap->GetPageCount());
+  ASSERT_EQ(table_heap->GetFirstPageId(), table_heap->GetPageId(0));
+
+  // enough pages to spill into a second directory page
+  const int row_nums = 8 * TableDirectoryPage::MAX_ENTRY_COUNT;
+  std::string name(TOAST_THRESHOLD, 'x');
+  std::set<page_id_t> heap_pages;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    heap_pages.insert(row.GetRowId().GetPageId());
+  }
+  uint32_t page_count = table_heap->GetPageCount();
+  ASSERT_EQ(heap_pages.size(), page_count);
+  ASSERT_GT(page_count, TableDirectoryPage::MAX_ENTRY_COUNT);
+
+  // directory order is scan order
+  std::vector<page_id_t> scan_pages;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    if (scan_pages.empty() || scan_pages.back() != iter->GetRowId().GetPageId()) {
+      scan_pages.push_back(iter->GetRowId().GetPageId());
+    }
+  }
+  ASSERT_EQ(page_count, scan_pages.size());
+  for (uint32_t i = 0; i < page_count; i++) {
+    ASSERT_EQ(scan_pages[i], table_heap->GetPageId(i));
+  }
+
+  // contiguous ranges covering every page once
+  for (uint32_t k : {1u, 3u, 7u, page_count, page_count + 5}) {
+    auto ranges = table_heap->Partition(k);
+    ASSERT_EQ(std::min(k, page_count), ranges.size());
+    uint32_t begin = 0;
+    for (auto &range : ranges) {
+      ASSERT_EQ(begin, range.first);
+      ASSERT_LT(range.first, range.second);
+      ASSERT_LE(range.second - range.first, page_count / ranges.size() + 1);
+      begin = range.second;
+    }
+    ASSERT_EQ(page_count, begin);
+  }
+
+  // freed space is found through the fill levels before the heap grows
+  RowId rid = table_heap->Begin(nullptr)->GetRowId();
+  ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+  table_heap->ApplyDelete(rid, nullptr);
+  uint32_t refill_rows = 0;
+  for (bool reused = false; !reused; refill_rows++) {
+    Fields fields{Field(TypeId::kTypeInt, -1),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_EQ(page_count, table_heap->GetPageCount());
+    reused = row.GetRowId().GetPageId() == rid.GetPageId();
+  }
+
+  // reopen by the directory page
+  TableHeap *reopened = TableHeap::Create(bpm_, table_heap->GetDirectoryPageId(), schema.get(), nullptr, nullptr,
+                                          &heap);
+  ASSERT_EQ(table_heap->GetPageCount(), reopened->GetPageCount());
+  ASSERT_EQ(table_heap->GetFirstPageId(), reopened->GetFirstPageId());
+  for (uint32_t i = 0; i < reopened->GetPageCount(); i++) {
+    ASSERT_EQ(table_heap->GetPageId(i), reopened->GetPageId(i));
+  }
+  int count = 0;
+  for (auto iter = reopened->Begin(nullptr); iter != reopened->End(); ++iter) {
+    count++;
+  }
+  ASSERT_EQ(row_nums - 1 + refill_rows, count);
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, ParallelScanTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_parallel_scan_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  const int row_nums = 20000;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name_" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+                  Field(TypeId::kTypeFloat, i * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  ASSERT_GT(table_heap->GetPageCount(), 4 * 8);
+
+  ParallelTableScan::Predicate even = [](const Row &row) {
+    char buf[sizeof(int32_t)];
+    row.GetField(0)->SerializeTo(buf);
+    return MACH_READ_FROM(int32_t, buf) % 2 == 0;
+  };
+  for (uint32_t workers : {1u, 4u}) {
+    ParallelTableScan scan(table_heap, workers, 8);
+    std::set<int32_t> ids;
+    uint64_t count = scan.Execute(even, [&ids](Row &row) {
+      char buf[sizeof(int32_t)];
+      row.GetField(0)->SerializeTo(buf);
+      ids.insert(MACH_READ_FROM(int32_t, buf));
+    });
+    ASSERT_EQ(row_nums / 2, count);
+    ASSERT_EQ(row_nums / 2, ids.size());
+    ASSERT_EQ(0, *ids.begin());
+    ASSERT_EQ(row_nums - 2, *ids.rbegin());
+  }
+
+  // only the fetched columns are filled in
+  std::vector<uint32_t> fetch{0};
+  ParallelTableScan scan(table_heap, 4, 8);
+  uint64_t count = scan.Execute(nullptr, [](Row &row) { ASSERT_FALSE(row.GetField(0)->IsNull()); }, &fetch);
+  ASSERT_EQ(row_nums, count);
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, ZoneMapTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_zone_map_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  // ids ascend with the heap, accounts are null on the first page only
+  const int row_nums = 20000;
+  RowId first_rid;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name_" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+                  i < 10 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, i * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    if (i == 0) {
+      first_rid = row.GetRowId();
+    }
+  }
+  const TableZoneMap &zone_map = table_heap->GetZoneMap();
+  ASSERT_TRUE(zone_map.IsTracked(0));
+  ASSERT_FALSE(zone_map.IsTracked(1));
+  ASSERT_TRUE(zone_map.IsTracked(2));
+  uint32_t page_count = table_heap->GetPageCount();
+  ASSERT_TRUE(zone_map.MayMatch(0, 2, ZoneOp::kIsNull, 0));
+  ASSERT_FALSE(zone_map.MayMatch(page_count - 1, 2, ZoneOp::kIsNull, 0));
+  ASSERT_TRUE(zone_map.MayMatch(page_count - 1, 0, ZoneOp::kEq, row_nums - 1));
+  ASSERT_FALSE(zone_map.MayMatch(page_count - 1, 0, ZoneOp::kLt, 0));
+
+  auto count_matches = [&](TableHeap *scanned, int32_t lower, uint32_t *skipped) {
+    ParallelTableScan scan(scanned, 4, 8);
+    const TableZoneMap &map = scanned->GetZoneMap();
+    scan.SetPageFilter([&map, lower](uint32_t page_index) {
+      return map.MayMatch(page_index, 0, ZoneOp::kGt, lower);
+    });
+    uint64_t count = scan.Execute(
+        [lower](const Row &row) {
+          char buf[sizeof(int32_t)];
+          row.GetField(0)->SerializeTo(buf);
+          return MACH_READ_FROM(int32_t, buf) > lower;
+        },
+        [](Row &row) {});
+    *skipped = scan.GetSkippedPages();
+    return count;
+  };
+  // a range at the tail reads only the last pages
+  uint32_t skipped;
+  ASSERT_EQ(1000, count_matches(table_heap, row_nums - 1001, &skipped));
+  ASSERT_GT(skipped, page_count * 9 / 10);
+
+  // updates widen the summary of the page in place
+  Fields fields{Field(TypeId::kTypeInt, 2 * row_nums),
+                Field(TypeId::kTypeChar, const_cast<char *>("moved"), 5, true),
+                Field(TypeId::kTypeFloat, 1.0f)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(row, first_rid, nullptr));
+  ASSERT_TRUE(zone_map.MayMatch(0, 0, ZoneOp::kGt, row_nums));
+  ASSERT_EQ(1001, count_matches(table_heap, row_nums - 1001, &skipped));
+
+  // a reopened heap summarizes its pages during the first scan
+  TableHeap *reopened = TableHeap::Create(bpm_, table_heap->GetDirectoryPageId(), schema.get(), nullptr, nullptr,
+                                          &heap);
+  ASSERT_EQ(1001, count_matches(reopened, row_nums - 1001, &skipped));
+  ASSERT_EQ(0, skipped);
+  ASSERT_EQ(1001, count_matches(reopened, row_nums - 1001, &skipped));
+  ASSERT_GT(skipped, page_count * 9 / 10);
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, PaxLayoutTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_pax_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatPax);
+  const RowCodec &codec = schema->GetCodec();
+  ASSERT_GT(codec.GetPaxCapacity(), 0);
+  ASSERT_EQ(2 + 16, codec.GetPaxWidth(1));
+  ASSERT_LE(codec.GetPaxValueOffset(2) + codec.GetPaxCapacity() * codec.GetPaxWidth(2), RowCodec::PAX_AREA_SIZE);
+
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_TRUE(table_heap->IsPax());
+  const int row_nums = 5000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name_" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 7 == 0 ? Field(TypeId::kTypeChar, nullptr, 0, false)
+                             : Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true),
+                  Field(TypeId::kTypeFloat, i * 0.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_EQ((row_nums + codec.GetPaxCapacity() - 1) / codec.GetPaxCapacity(), table_heap->GetPageCount());
+  // a value longer than its column has no slot
+  std::string long_name(17, 'x');
+  Fields too_long{Field(TypeId::kTypeInt, -1),
+                  Field(TypeId::kTypeChar, const_cast<char *>(long_name.data()), long_name.size(), true),
+                  Field(TypeId::kTypeFloat, 0.f)};
+  Row too_long_row(too_long);
+  ASSERT_FALSE(table_heap->InsertTuple(too_long_row, nullptr));
+
+  for (int i = 0; i < row_nums; i += 97) {
+    Row row(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    std::string name = "name_" + std::to_string(i);
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+    if (i % 7 == 0) {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+    } else {
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(
+              Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), false)));
+    }
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(2)->CompareEquals(Field(TypeId::kTypeFloat, i * 0.5f)));
+  }
+
+  // a projecting scan reads the requested minipages only
+  std::vector<uint32_t> fetch{2};
+  ParallelTableScan scan(table_heap, 4, 2);
+  double sum = 0;
+  uint64_t count = scan.Execute(nullptr, [&sum](Row &row) {
+    ASSERT_TRUE(row.GetField(0)->IsNull());
+    ASSERT_TRUE(row.GetField(1)->IsNull());
+    char buf[sizeof(float)];
+    row.GetField(2)->SerializeTo(buf);
+    sum += MACH_READ_FROM(float, buf);
+  }, &fetch);
+  ASSERT_EQ(row_nums, count);
+  ASSERT_DOUBLE_EQ(0.5 * (row_nums - 1) * row_nums / 2, sum);
+
+  // updates stay in their slot, deleted slots are reused
+  Fields updated{Field(TypeId::kTypeInt, 2 * row_nums),
+                 Field(TypeId::kTypeChar, const_cast<char *>("updated"), 7, true),
+                 Field(TypeId::kTypeFloat)};
+  Row updated_row(updated);
+  ASSERT_TRUE(table_heap->UpdateTuple(updated_row, rids[1], nullptr));
+  ASSERT_EQ(rids[1].Get(), updated_row.GetRowId().Get());
+  Row reread(rids[1]);
+  ASSERT_TRUE(table_heap->GetTuple(&reread, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, reread.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 2 * row_nums)));
+  ASSERT_TRUE(reread.GetField(2)->IsNull());
+  ASSERT_TRUE(table_heap->MarkDelete(rids[2], nullptr));
+  Row deleted(rids[2]);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted, nullptr));
+  table_heap->RollbackDelete(rids[2], nullptr);
+  ASSERT_TRUE(table_heap->MarkDelete(rids[2], nullptr));
+  table_heap->ApplyDelete(rids[2], nullptr);
+  // once the last page is full, the free slot is found through the directory
+  uint32_t tail_free = codec.GetPaxCapacity() * table_heap->GetPageCount() - row_nums;
+  for (uint32_t i = 0; i < tail_free; i++) {
+    Fields fields{Field(TypeId::kTypeInt, static_cast<int32_t>(row_nums + i)),
+                  Field(TypeId::kTypeChar, nullptr, 0, false), Field(TypeId::kTypeFloat, 0.f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  Fields reinserted{Field(TypeId::kTypeInt, -2), Field(TypeId::kTypeChar, nullptr, 0, false),
+                    Field(TypeId::kTypeFloat, 1.f)};
+  Row reinserted_row(reinserted);
+  ASSERT_TRUE(table_heap->InsertTuple(reinserted_row, nullptr));
+  ASSERT_EQ(rids[2].Get(), reinserted_row.GetRowId().Get());
+
+  // the iterator and a reopened heap see the same rows
+  TableHeap *reopened = TableHeap::Create(bpm_, table_heap->GetDirectoryPageId(), schema.get(), nullptr, nullptr,
+                                          &heap);
+  uint64_t iterated = 0;
+  for (auto it = reopened->Begin(nullptr); it != reopened->End(); ++it) {
+    iterated++;
+  }
+  ASSERT_EQ(row_nums + tail_free, iterated);
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, DictionaryEncodingTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_dictionary_test.db");
+  BufferPoolManager *bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("city", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  schema->SetRowFormat(kRowFormatPax);
+  uint32_t plain_capacity = schema->GetCodec().GetPaxCapacity();
+  schema->SetColumnEncoding(1, kEncodingDictionary);
+  const RowCodec &codec = schema->GetCodec();
+  // codes are two bytes wide, however long the column is
+  ASSERT_EQ(2, codec.GetPaxWidth(1));
+  ASSERT_GT(codec.GetPaxCapacity(), plain_capacity);
+
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_NE(INVALID_PAGE_ID, table_heap->GetDictionaryPageId());
+  // long values, so the dictionary spans several pages
+  std::vector<std::string> cities;
+  for (int i = 0; i < 300; i++) {
+    cities.push_back("city_" + std::to_string(i) + std::string(40, 'c'));
+  }
+  const int row_nums = 6000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    const std::string &city = cities[i % cities.size()];
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 11 == 0 ? Field(TypeId::kTypeChar, nullptr, 0, false)
+                              : Field(TypeId::kTypeChar, const_cast<char *>(city.data()), city.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_EQ(cities.size(), table_heap->GetDictionarySize(1));
+  ASSERT_EQ(ColumnDictionary::INVALID_CODE, table_heap->FindCode(1, "nowhere", 7));
+
+  auto check_row = [&](TableHeap *heap_to_check, int i) {
+    Row row(rids[i]);
+    ASSERT_TRUE(heap_to_check->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+    if (i % 11 == 0) {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+    } else {
+      const std::string &city = cities[i % cities.size()];
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(
+              Field(TypeId::kTypeChar, const_cast<char *>(city.data()), city.size(), false)));
+    }
+  };
+  for (int i = 0; i < row_nums; i += 31) {
+    check_row(table_heap, i);
+  }
+
+  // code filters drop rows before they are decoded, here city in (cities[1], cities[2])
+  std::vector<CodeFilter> filters(1);
+  filters[0].column_index_ = 1;
+  filters[0].codes_.assign(table_heap->GetDictionarySize(1), false);
+  for (int i = 1; i <= 2; i++) {
+    filters[0].codes_[table_heap->FindCode(1, cities[i].data(), cities[i].size())] = true;
+  }
+  ParallelTableScan scan(table_heap, 4, 2);
+  scan.SetCodeFilters(filters);
+  uint64_t count = scan.Execute(nullptr, [&](Row &row) {
+    char buf[sizeof(int32_t)];
+    row.GetField(0)->SerializeTo(buf);
+    int32_t id = MACH_READ_FROM(int32_t, buf);
+    ASSERT_TRUE(id % 300 == 1 || id % 300 == 2);
+    ASSERT_NE(0, id % 11);
+  });
+  uint64_t expected = 0;
+  for (int i = 0; i < row_nums; i++) {
+    expected += (i % 300 == 1 || i % 300 == 2) && i % 11 != 0;
+  }
+  ASSERT_EQ(expected, count);
+
+  // updates may bring new values
+  std::string moved = "moved";
+  Fields updated{Field(TypeId::kTypeInt, 5), Field(TypeId::kTypeChar, const_cast<char *>(moved.data()), 5, true)};
+  Row updated_row(updated);
+  ASSERT_TRUE(table_heap->UpdateTuple(updated_row, rids[5], nullptr));
+  ASSERT_EQ(cities.size() + 1, table_heap->GetDictionarySize(1));
+
+  // a reopened heap hands out the same codes
+  TableHeap *reopened = TableHeap::Create(bpm_, table_heap->GetDirectoryPageId(), table_heap->GetDictionaryPageId(),
+                                          schema.get(), nullptr, nullptr, &heap);
+  ASSERT_EQ(cities.size() + 1, reopened->GetDictionarySize(1));
+  for (size_t i = 0; i < cities.size(); i += 17) {
+    ASSERT_EQ(table_heap->FindCode(1, cities[i].data(), cities[i].size()),
+              reopened->FindCode(1, cities[i].data(), cities[i].size()));
+  }
+  for (int i = 1; i < row_nums; i += 53) {
+    if (i != 5) {
+      check_row(reopened, i);
+    }
+  }
+  Row reread(rids[5]);
+  ASSERT_TRUE(reopened->GetTuple(&reread, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, reread.GetField(1)->CompareEquals(
+          Field(TypeId::kTypeChar, const_cast<char *>(moved.data()), moved.size(), false)));
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}
+
+TEST(TableHeapTest, SortedFetchTest) {
+  DiskManager *disk_mgr_ = new DiskManager("table_heap_sorted_fetch_test.db");
+  // a pool much smaller than the table, rows fetched in random order miss it most of the time
+  BufferPoolManager *bpm_ = new BufferPoolManager(16, disk_mgr_);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  const int row_nums = 20000;
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name_" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.data()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_GT(table_heap->GetPageCount(), 16 * 4);
+  auto id_of = [](const Row &row) {
+    char buf[sizeof(int32_t)];
+    row.GetField(0)->SerializeTo(buf);
+    return MACH_READ_FROM(int32_t, buf);
+  };
+
+  // every third row in random order, as an index on another column hands them out, some of them twice
+  std::vector<int> picked;
+  for (int i = 0; i < row_nums; i += 3) {
+    picked.push_back(i);
+  }
+  ShuffleArray(picked);
+  std::vector<RowId> probe;
+  for (int i : picked) {
+    probe.push_back(rids[i]);
+  }
+  probe.push_back(rids[picked[0]]);
+  ASSERT_TRUE(table_heap->MarkDelete(rids[3], nullptr));
+
+  auto start = std::chrono::steady_clock::now();
+  std::set<int> one_by_one;
+  for (auto &rid : probe) {
+    Row row(rid);
+    if (table_heap->GetTuple(&row, nullptr)) {
+      one_by_one.insert(id_of(row));
+    }
+  }
+  auto row_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  TableHeap::SortRowIds(&probe);
+  ArenaMemHeap rows_heap;
+  std::vector<Row> rows;
+  table_heap->GetTuples(probe, nullptr, nullptr, &rows_heap, &rows);
+  auto sorted_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  LOG(INFO) << "fetch of " << picked.size() << " shuffled rows: one by one " << row_ns / 1000 << " us, sorted by page "
+            << sorted_ns / 1000 << " us";
+
+  // each row once, in row id order, the deleted one left out
+  ASSERT_EQ(picked.size(), probe.size());
+  ASSERT_EQ(picked.size() - 1, rows.size());
+  ASSERT_EQ(one_by_one.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_TRUE(i == 0 || rows[i - 1].GetRowId().Get() < rows[i].GetRowId().Get());
+    ASSERT_EQ(1, one_by_one.count(id_of(rows[i])));
+    ASSERT_EQ(rids[id_of(rows[i])].Get(), rows[i].GetRowId().Get());
+    std::string name = "name_" + std::to_string(id_of(rows[i]));
+    ASSERT_EQ(name, std::string(rows[i].GetField(1)->GetData(), rows[i].GetField(1)->GetLength()));
+  }
+
+  table_heap->FreeHeap();
+  delete bpm_;
+  delete disk_mgr_;
+}